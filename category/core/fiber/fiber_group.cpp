@@ -26,6 +26,7 @@
 #include <boost/fiber/operations.hpp>
 #include <boost/fiber/protected_fixedsize_stack.hpp>
 
+#include <atomic>
 #include <cstddef>
 #include <future>
 #include <memory>
@@ -55,6 +56,7 @@ FiberGroup::FiberGroup(FiberThreadPool &pool, unsigned const n_fibers)
                     PriorityTask task;
                     while (channel_.pop(task) ==
                            boost::fibers::channel_op_status::success) {
+                        n_pending_.fetch_sub(1, std::memory_order_relaxed);
                         properties->set_priority(task.priority);
                         boost::this_fiber::yield();
                         task.task();
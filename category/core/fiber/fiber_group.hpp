@@ -21,6 +21,8 @@
 #include <boost/fiber/buffered_channel.hpp>
 #include <boost/fiber/fiber.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <vector>
@@ -53,6 +55,8 @@ class FiberGroup final
 
     std::promise<void> start_{};
 
+    std::atomic<uint64_t> n_pending_{0};
+
     friend class FiberThreadPool;
 
     FiberGroup(FiberThreadPool &pool, unsigned n_fibers);
@@ -66,6 +70,7 @@ public:
     template <typename F>
     void submit(uint64_t const priority, F &&task)
     {
+        n_pending_.fetch_add(1, std::memory_order_relaxed);
         channel_.push(
             {priority, std::move_only_function<void()>(std::forward<F>(task))});
     }
@@ -74,6 +79,12 @@ public:
     {
         return static_cast<unsigned>(fibers_.size());
     }
+
+    /// Number of submitted tasks no fiber has picked up yet
+    uint64_t num_pending() const
+    {
+        return n_pending_.load(std::memory_order_relaxed);
+    }
 };
 
 MONAD_FIBER_NAMESPACE_END
@@ -19,6 +19,7 @@
 #include <category/core/fiber/fiber_group.hpp>
 #include <category/core/fiber/fiber_thread_pool.hpp>
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 
@@ -55,6 +56,11 @@ public:
         return thread_pool_->num_threads();
     }
 
+    uint64_t num_pending() const
+    {
+        return fiber_group_->num_pending();
+    }
+
     template <typename F>
     void submit(uint64_t const priority, F &&task)
     {
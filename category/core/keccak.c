@@ -35,7 +35,13 @@ void keccak256(
 
     __builtin_memset(A, 0, sizeof(A));
 
-    size_t const rem = SHA3_absorb(A, in, len, BLOCK_SIZE);
+    // Full blocks are absorbed straight from the input. Inputs shorter than
+    // a block, such as words, addresses and most regions hashed by the SHA3
+    // opcode, go directly to the single padded block below.
+    size_t rem = len;
+    if (len >= BLOCK_SIZE) {
+        rem = SHA3_absorb(A, in, len, BLOCK_SIZE);
+    }
     if (rem > 0) {
         __builtin_memcpy(blk, &in[len - rem], rem);
     }
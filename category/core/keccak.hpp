@@ -20,6 +20,8 @@
 
 #include <ethash/hash_types.hpp>
 
+#include <array>
+
 MONAD_NAMESPACE_BEGIN
 
 using ::keccak256;
@@ -39,4 +41,9 @@ inline hash256 keccak256(unsigned char const (&a)[N])
     return keccak256(to_byte_string_view(a));
 }
 
+// Hashes four inputs at once, one per vector lane. Each input must fit in a
+// single keccak block (under 136 bytes), which covers addresses and words.
+void keccak256_x4(
+    std::array<byte_string_view, 4> const &, std::array<hash256, 4> &);
+
 MONAD_NAMESPACE_END
@@ -0,0 +1,123 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/byte_string.hpp>
+#include <category/core/config.hpp>
+#include <category/core/keccak.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+MONAD_NAMESPACE_BEGIN
+
+namespace
+{
+    // One 64-bit keccak lane from each of four states, so every step of the
+    // permutation runs on all four at once
+    using lane4 = uint64_t __attribute__((vector_size(32)));
+
+    constexpr size_t RATE = (1600 - 2 * 256) / 8;
+
+    constexpr uint64_t ROUND_CONSTANTS[24] = {
+        0x0000000000000001, 0x0000000000008082, 0x800000000000808a,
+        0x8000000080008000, 0x000000000000808b, 0x0000000080000001,
+        0x8000000080008081, 0x8000000000008009, 0x000000000000008a,
+        0x0000000000000088, 0x0000000080008009, 0x000000008000000a,
+        0x000000008000808b, 0x800000000000008b, 0x8000000000008089,
+        0x8000000000008003, 0x8000000000008002, 0x8000000000000080,
+        0x000000000000800a, 0x800000008000000a, 0x8000000080008081,
+        0x8000000000008080, 0x0000000080000001, 0x8000000080008008};
+
+    // Rotation offsets, indexed by x + 5 * y
+    constexpr unsigned ROTATIONS[25] = {
+        0,  1,  62, 28, 27, 36, 44, 6,  55, 20, 3,  10, 43,
+        25, 39, 41, 45, 15, 21, 8,  18, 2,  61, 56, 14};
+
+    void keccak_f1600_x4(lane4 (&a)[25])
+    {
+        for (uint64_t const rc : ROUND_CONSTANTS) {
+            // theta
+            lane4 c[5];
+            for (unsigned x = 0; x < 5; ++x) {
+                c[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20];
+            }
+            for (unsigned x = 0; x < 5; ++x) {
+                lane4 const &r = c[(x + 1) % 5];
+                lane4 const d = c[(x + 4) % 5] ^ ((r << 1) | (r >> 63));
+                for (unsigned y = 0; y < 25; y += 5) {
+                    a[x + y] ^= d;
+                }
+            }
+            // rho and pi
+            lane4 b[25];
+            for (unsigned x = 0; x < 5; ++x) {
+                for (unsigned y = 0; y < 5; ++y) {
+                    lane4 const &v = a[x + 5 * y];
+                    unsigned const n = ROTATIONS[x + 5 * y];
+                    b[y + 5 * ((2 * x + 3 * y) % 5)] =
+                        n == 0 ? v : (v << n) | (v >> (64 - n));
+                }
+            }
+            // chi
+            for (unsigned y = 0; y < 25; y += 5) {
+                for (unsigned x = 0; x < 5; ++x) {
+                    a[x + y] = b[x + y] ^
+                               (~b[(x + 1) % 5 + y] & b[(x + 2) % 5 + y]);
+                }
+            }
+            // iota
+            a[0] ^= rc;
+        }
+    }
+}
+
+void keccak256_x4(
+    std::array<byte_string_view, 4> const &in, std::array<hash256, 4> &out)
+{
+    // Every input fits in a single padded block, so absorbing is a plain
+    // copy of the padded blocks into the rate lanes
+    alignas(32) unsigned char blocks[4][RATE];
+    for (unsigned i = 0; i < 4; ++i) {
+        MONAD_ASSERT(in[i].size() < RATE);
+        std::memset(blocks[i], 0, RATE);
+        if (!in[i].empty()) {
+            std::memcpy(blocks[i], in[i].data(), in[i].size());
+        }
+        blocks[i][in[i].size()] = 0x01;
+        blocks[i][RATE - 1] |= 0x80;
+    }
+
+    lane4 a[25] = {};
+    for (unsigned j = 0; j < RATE / 8; ++j) {
+        for (unsigned i = 0; i < 4; ++i) {
+            uint64_t lane;
+            std::memcpy(&lane, &blocks[i][j * 8], sizeof(lane));
+            a[j][i] = lane;
+        }
+    }
+    keccak_f1600_x4(a);
+
+    for (unsigned i = 0; i < 4; ++i) {
+        for (unsigned j = 0; j < 4; ++j) {
+            uint64_t const lane = a[j][i];
+            std::memcpy(&out[i].bytes[j * 8], &lane, sizeof(lane));
+        }
+    }
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,52 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/byte_string.hpp>
+#include <category/core/keccak.hpp>
+#include <category/core/test_util/gtest_signal_stacktrace_printer.hpp> // NOLINT
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+using namespace monad;
+
+TEST(keccak256_x4, matches_keccak256)
+{
+    byte_string input;
+    for (size_t i = 0; i < 136; ++i) {
+        input.push_back(static_cast<unsigned char>(i * 7 + 3));
+    }
+
+    // Each lane gets a different length so no two lanes share a padding
+    // position
+    for (size_t len = 0; len + 3 < 136; ++len) {
+        std::array<byte_string_view, 4> const in{
+            byte_string_view{input.data(), len},
+            byte_string_view{input.data() + 1, len + 1},
+            byte_string_view{input.data() + 2, len + 2},
+            byte_string_view{input.data(), len + 3}};
+        std::array<hash256, 4> out;
+        keccak256_x4(in, out);
+        for (size_t i = 0; i < 4; ++i) {
+            auto const expected = keccak256(in[i]);
+            EXPECT_EQ(
+                std::memcmp(out[i].bytes, expected.bytes, sizeof(hash256)), 0)
+                << "len=" << in[i].size() << " lane=" << i;
+        }
+    }
+}
@@ -0,0 +1,101 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/bytes.hpp>
+#include <category/core/small_prng.hpp>
+#include <category/execution/ethereum/block_hash_buffer.hpp>
+
+#include <CLI/CLI.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using namespace monad;
+
+namespace
+{
+    bytes32_t block_id(uint64_t const number, uint64_t const fork)
+    {
+        bytes32_t id{number};
+        id.bytes[0] = static_cast<uint8_t>(fork);
+        return id;
+    }
+}
+
+// Proposes several forks at every height on top of a window of unfinalized
+// blocks, and looks up random recent block hashes on each proposal the way
+// a BLOCKHASH-heavy block does, before finalizing the oldest height
+int main(int argc, char *argv[])
+{
+    unsigned n_blocks = 10000;
+    unsigned n_forks = 3;
+    unsigned n_unfinalized = 3;
+    unsigned n_lookups = 1000;
+
+    CLI::App app{"Block hash chain benchmark"};
+    app.add_option("-n", n_blocks, "Number of heights to propose")
+        ->default_val(10000);
+    app.add_option("--forks", n_forks, "Number of proposals per height")
+        ->default_val(3);
+    app.add_option(
+           "--unfinalized", n_unfinalized, "Heights proposed ahead of finality")
+        ->default_val(3);
+    app.add_option("--lookups", n_lookups, "BLOCKHASH lookups per proposal")
+        ->default_val(1000);
+
+    try {
+        app.parse(argc, argv);
+    }
+    catch (CLI::ParseError const &e) {
+        return app.exit(e);
+    }
+
+    BlockHashBufferFinalized buf;
+    for (uint64_t i = 0; i < BlockHashBuffer::N; ++i) {
+        buf.set(i, bytes32_t{i + 1});
+    }
+    BlockHashChain chain{buf};
+
+    small_prng rnd{42};
+    uint64_t checksum = 0;
+    uint64_t const first = buf.n();
+    auto const begin = std::chrono::steady_clock::now();
+    for (uint64_t number = first; number < first + n_blocks; ++number) {
+        for (uint64_t fork = 0; fork < n_forks; ++fork) {
+            // every fork extends the first proposal of the previous height
+            auto const id = block_id(number, fork);
+            chain.propose(
+                bytes32_t{number + 1}, number, id, block_id(number - 1, 0));
+            auto const &hashes = chain.find_chain(id);
+            for (unsigned i = 0; i < n_lookups; ++i) {
+                checksum +=
+                    hashes.get(hashes.n() - 1 - rnd() % BlockHashBuffer::N)
+                        .bytes[31];
+            }
+        }
+        if (number >= first + n_unfinalized) {
+            chain.finalize(block_id(number - n_unfinalized, 0));
+        }
+    }
+    auto const elapsed = std::chrono::steady_clock::now() - begin;
+    auto const ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    std::cout << static_cast<double>(ns) /
+                     static_cast<double>(uint64_t{n_blocks} * n_forks)
+              << " ns/proposal, checksum = " << checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,157 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/int.hpp>
+#include <category/execution/ethereum/block_hash_buffer.hpp>
+#include <category/execution/ethereum/chain/ethereum_mainnet.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
+#include <category/execution/ethereum/db/trie_db.hpp>
+#include <category/execution/ethereum/db/util.hpp>
+#include <category/execution/ethereum/execute_transaction.hpp>
+#include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state3/state.hpp>
+#include <category/execution/ethereum/trace/call_frame.hpp>
+#include <category/execution/ethereum/trace/call_tracer.hpp>
+#include <category/execution/ethereum/trace/state_tracer.hpp>
+#include <category/mpt/db.hpp>
+#include <category/vm/evm/traits.hpp>
+#include <category/vm/vm.hpp>
+
+#include <CLI/CLI.hpp>
+
+#include <boost/fiber/future/promise.hpp>
+
+#include <intx/intx.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <variant>
+#include <vector>
+
+using namespace monad;
+
+namespace
+{
+    using traits = EvmTraits<EVMC_PRAGUE>;
+
+    Address make_address(uint64_t const tag, uint64_t const n)
+    {
+        Address address{};
+        std::memcpy(address.bytes, &tag, sizeof(tag));
+        std::memcpy(address.bytes + 12, &n, sizeof(n));
+        return address;
+    }
+}
+
+// Executes a block made only of value transfers between externally owned
+// accounts, one transaction after another, and reports the time spent per
+// transaction. With --traced every transaction goes through the EVM the way
+// a traced block does
+int main(int argc, char *argv[])
+{
+    using intx::operator""_u256;
+
+    unsigned n_txns = 10000;
+    bool traced = false;
+
+    CLI::App app{"Transfer block benchmark"};
+    app.add_option("-n", n_txns, "Number of transfers in the block")
+        ->default_val(10000);
+    app.add_flag("--traced", traced, "Trace calls, disabling the fast path");
+
+    try {
+        app.parse(argc, argv);
+    }
+    catch (CLI::ParseError const &e) {
+        return app.exit(e);
+    }
+
+    InMemoryMachine machine;
+    mpt::Db db{machine};
+    TrieDb tdb{db};
+    vm::VM vm;
+    BlockState block_state{tdb, vm};
+    BlockMetrics metrics;
+
+    std::vector<Address> senders;
+    std::vector<Transaction> txns;
+    {
+        State state{block_state, Incarnation{0, 0}};
+        for (uint64_t i = 0; i < n_txns; ++i) {
+            senders.push_back(make_address(1, i));
+            state.add_to_balance(senders.back(), 1'000'000'000'000'000'000);
+            txns.push_back(Transaction{
+                .sc =
+                    {.r =
+                         0x5fd883bb01a10915ebc06621b925bd6d624cb6768976b73c0d468b31f657d15b_u256,
+                     .s =
+                         0x121d855c539a23aadf6f06ac21165db1ad5efd261842e82a719c9863ca4ac04c_u256},
+                .nonce = 0,
+                .max_fee_per_gas = 10,
+                .gas_limit = 21'000,
+                .value = 1'000 + i,
+                .to = make_address(2, i),
+            });
+        }
+        block_state.merge(state);
+    }
+
+    BlockHeader const header{
+        .number = 1, .beneficiary = make_address(3, 0), .base_fee_per_gas = 1};
+    BlockHashBufferFinalized const block_hash_buffer;
+    EthereumMainnet const chain;
+    trace::StateTracer state_tracer = std::monostate{};
+
+    uint64_t gas_used = 0;
+    auto const begin = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < n_txns; ++i) {
+        boost::fibers::promise<void> prev{};
+        prev.set_value();
+        std::vector<CallFrame> call_frames;
+        CallTracer call_tracer{txns[i], call_frames};
+        NoopCallTracer noop_call_tracer;
+        CallTracerBase &tracer =
+            traced ? static_cast<CallTracerBase &>(call_tracer)
+                   : noop_call_tracer;
+        auto const receipt = ExecuteTransaction<traits>{
+            chain,
+            i,
+            txns[i],
+            senders[i],
+            {},
+            header,
+            block_hash_buffer,
+            block_state,
+            metrics,
+            prev,
+            tracer,
+            state_tracer}();
+        MONAD_ASSERT(receipt.has_value() && receipt.value().status == 1);
+        gas_used += receipt.value().gas_used;
+    }
+    auto const elapsed = std::chrono::steady_clock::now() - begin;
+    auto const ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    std::cout << static_cast<double>(ns) / static_cast<double>(n_txns)
+              << " ns/txn, gas used = " << gas_used << std::endl;
+    return 0;
+}
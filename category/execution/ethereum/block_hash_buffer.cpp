@@ -27,9 +27,9 @@
 
 #include <quill/Quill.h>
 
-#include <algorithm>
-#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <unordered_map>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -64,7 +64,7 @@ BlockHashBufferProposal::BlockHashBufferProposal(
     bytes32_t const &h, BlockHashBufferFinalized const &buf)
     : n_{buf.n() + 1}
     , buf_{&buf}
-    , deltas_{h}
+    , head_{std::make_shared<Link>(Link{.hash = h, .parent = nullptr})}
 {
 }
 
@@ -72,12 +72,10 @@ BlockHashBufferProposal::BlockHashBufferProposal(
     bytes32_t const &h, BlockHashBufferProposal const &parent)
     : n_{parent.n_ + 1}
     , buf_{parent.buf_}
+    , head_{std::make_shared<Link>(Link{.hash = h, .parent = parent.head_})}
 {
     MONAD_ASSERT_PRINTF(
         n_ > 0 && n_ > buf_->n(), "n_=%lu, n=%lu", n_, buf_->n());
-    deltas_.push_back(h);
-    deltas_.insert(deltas_.end(), parent.deltas_.begin(), parent.deltas_.end());
-    deltas_.resize(n_ - buf_->n());
 }
 
 uint64_t BlockHashBufferProposal::n() const
@@ -88,13 +86,21 @@ uint64_t BlockHashBufferProposal::n() const
 bytes32_t const &BlockHashBufferProposal::get(uint64_t const n) const
 {
     MONAD_ASSERT_PRINTF(n < n_ && n + N >= n_, "n_=%lu, n=%lu", n_, n);
-    size_t const idx = n_ - n - 1;
-    if (idx < deltas_.size()) {
-        return deltas_.at(idx);
+    Link const *link = head_.get();
+    for (uint64_t idx = n_ - n - 1; link && idx; --idx) {
+        link = link->parent.get();
+    }
+    if (link) {
+        return link->hash;
     }
     return buf_->get(n);
 }
 
+void BlockHashBufferProposal::unlink_parent()
+{
+    head_->parent.reset();
+}
+
 BlockHashChain::BlockHashChain(BlockHashBufferFinalized &buf)
     : buf_{buf}
 {
@@ -104,58 +110,46 @@ void BlockHashChain::propose(
     bytes32_t const &hash, uint64_t const block_number,
     bytes32_t const &block_id, bytes32_t const &parent_id)
 {
-    for (auto it = proposals_.begin(); it != proposals_.end(); ++it) {
-        if (it->block_id == parent_id) {
-            proposals_.emplace_back(Proposal{
-                .block_number = block_number,
-                .block_id = block_id,
-                .parent_id = parent_id,
-                .buf = BlockHashBufferProposal(hash, it->buf)});
-            return;
-        }
-    }
-    proposals_.emplace_back(Proposal{
-        .block_number = block_number,
-        .block_id = block_id,
-        .parent_id = parent_id,
-        .buf = BlockHashBufferProposal(hash, buf_)});
+    auto const parent = proposals_.find(parent_id);
+    proposals_.try_emplace(
+        block_id,
+        Proposal{
+            .block_number = block_number,
+            .parent_id = parent_id,
+            .buf = parent == proposals_.end()
+                       ? BlockHashBufferProposal(hash, buf_)
+                       : BlockHashBufferProposal(hash, parent->second.buf)});
 }
 
 void BlockHashChain::finalize(bytes32_t const &block_id)
 {
     auto const to_finalize = buf_.n();
 
-    auto winner_it = std::find_if(
-        proposals_.begin(), proposals_.end(), [&block_id](Proposal const &p) {
-            return p.block_id == block_id;
-        });
+    auto const winner_it = proposals_.find(block_id);
     MONAD_ASSERT(winner_it != proposals_.end());
-    MONAD_ASSERT((winner_it->buf.n() - 1) == to_finalize);
-    buf_.set(to_finalize, winner_it->buf.get(to_finalize));
-    uint64_t const block_number = winner_it->block_number;
+    BlockHashBufferProposal &winner = winner_it->second.buf;
+    MONAD_ASSERT((winner.n() - 1) == to_finalize);
+    buf_.set(to_finalize, winner.get(to_finalize));
+    uint64_t const block_number = winner_it->second.block_number;
+
+    // the descendants of the winner share its list, and find everything
+    // below it in the finalized buffer from now on
+    winner.unlink_parent();
 
     // cleanup chains
-    proposals_.erase(
-        std::remove_if(
-            proposals_.begin(),
-            proposals_.end(),
-            [block_number](Proposal const &p) {
-                return p.block_number <= block_number;
-            }),
-        proposals_.end());
+    std::erase_if(proposals_, [block_number](auto const &p) {
+        return p.second.block_number <= block_number;
+    });
 }
 
 BlockHashBuffer const &
 BlockHashChain::find_chain(bytes32_t const &block_id) const
 {
-    auto it = std::find_if(
-        proposals_.begin(), proposals_.end(), [&block_id](Proposal const &p) {
-            return p.block_id == block_id;
-        });
+    auto const it = proposals_.find(block_id);
     if (MONAD_UNLIKELY(it == proposals_.end())) {
         return buf_;
     }
-    return it->buf;
+    return it->second.buf;
 }
 
 bool init_block_hash_buffer_from_triedb(
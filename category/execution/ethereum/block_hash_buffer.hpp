@@ -19,8 +19,8 @@
 #include <category/core/config.hpp>
 
 #include <cstdint>
-#include <deque>
-#include <vector>
+#include <memory>
+#include <unordered_map>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -57,9 +57,17 @@ public:
 
 class BlockHashBufferProposal : public BlockHashBuffer
 {
+    // Hashes of the blocks above the finalized buffer, newest first. A child
+    // links to the list of its parent instead of copying it
+    struct Link
+    {
+        bytes32_t hash;
+        std::shared_ptr<Link> parent;
+    };
+
     uint64_t n_;
     BlockHashBuffer const *buf_;
-    std::vector<bytes32_t> deltas_;
+    std::shared_ptr<Link> head_;
 
 public:
     BlockHashBufferProposal(
@@ -68,6 +76,9 @@ public:
 
     uint64_t n() const override;
     bytes32_t const &get(uint64_t) const override;
+
+    // Drops the ancestors, once they are all in the finalized buffer
+    void unlink_parent();
 };
 
 class BlockHashChain
@@ -77,12 +88,11 @@ class BlockHashChain
     struct Proposal
     {
         uint64_t block_number;
-        bytes32_t block_id;
         bytes32_t parent_id;
         BlockHashBufferProposal buf;
     };
 
-    std::deque<Proposal> proposals_;
+    std::unordered_map<bytes32_t, Proposal> proposals_; // by block id
 
 public:
     explicit BlockHashChain(BlockHashBufferFinalized &);
@@ -173,6 +173,42 @@ TEST(BlockHashBuffer, duplicate_proposals)
     EXPECT_EQ(buf.get(3), bytes32_t{6});
 }
 
+TEST(BlockHashBuffer, long_unfinalized_chain)
+{
+    BlockHashBufferFinalized buf;
+    buf.set(0, bytes32_t{0}); // genesis
+
+    BlockHashChain chain(buf);
+
+    // ten proposals ahead of finality, with a sibling at every height
+    for (uint64_t i = 1; i <= 10; ++i) {
+        auto const parent_id = dummy_block_id(i - 1);
+        chain.propose(bytes32_t{i}, i, dummy_block_id(i), parent_id);
+        chain.propose(
+            bytes32_t{100 + i}, i, dummy_block_id(100 + i), parent_id);
+    }
+    auto const &tip = chain.find_chain(dummy_block_id(10));
+    ASSERT_EQ(tip.n(), 11);
+    for (uint64_t i = 0; i <= 10; ++i) {
+        EXPECT_EQ(tip.get(i), bytes32_t{i});
+    }
+    auto const &sibling = chain.find_chain(dummy_block_id(110));
+    EXPECT_EQ(sibling.get(10), bytes32_t{110});
+    EXPECT_EQ(sibling.get(9), bytes32_t{9});
+
+    // the tip keeps reading the same hashes as its ancestors are finalized
+    for (uint64_t i = 1; i <= 9; ++i) {
+        chain.finalize(dummy_block_id(i));
+        EXPECT_EQ(buf.get(i), bytes32_t{i});
+        for (uint64_t j = 0; j <= 10; ++j) {
+            EXPECT_EQ(tip.get(j), bytes32_t{j});
+        }
+    }
+    chain.finalize(dummy_block_id(10));
+    EXPECT_EQ(buf.n(), 11);
+    EXPECT_EQ(&chain.find_chain(dummy_block_id(10)), &buf);
+}
+
 TEST(BlockHashBuffer, propose_after_crash)
 {
     BlockHashBufferFinalized buf;
@@ -0,0 +1,105 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/bytes.hpp>
+#include <category/core/small_prng.hpp>
+#include <category/execution/ethereum/core/receipt.hpp>
+#include <category/execution/ethereum/validate_block.hpp>
+
+#include <CLI/CLI.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+using namespace monad;
+
+// Builds the blooms of a synthetic block of log-heavy receipts, once a log
+// at a time and once with the logs of each receipt hashed as a batch
+int main(int argc, char *argv[])
+{
+    unsigned n_receipts = 1000;
+    unsigned n_logs = 20;
+    unsigned n_iterations = 10;
+
+    CLI::App app{"Logs bloom benchmark"};
+    app.add_option("-n", n_receipts, "Number of receipts in the block")
+        ->default_val(1000);
+    app.add_option("--logs", n_logs, "Number of logs per receipt")
+        ->default_val(20);
+    app.add_option("--iterations", n_iterations, "Number of iterations")
+        ->default_val(10);
+
+    try {
+        app.parse(argc, argv);
+    }
+    catch (CLI::ParseError const &e) {
+        return app.exit(e);
+    }
+
+    small_prng rnd{42};
+    std::vector<std::vector<Receipt::Log>> block_logs(n_receipts);
+    uint64_t n_hashes = 0;
+    for (auto &logs : block_logs) {
+        for (unsigned i = 0; i < n_logs; ++i) {
+            auto &log = logs.emplace_back();
+            for (auto &b : log.address.bytes) {
+                b = static_cast<uint8_t>(rnd());
+            }
+            // Zero to four topics, like the LOG0 to LOG4 opcodes
+            log.topics.resize(rnd() % 5);
+            for (auto &topic : log.topics) {
+                for (auto &b : topic.bytes) {
+                    b = static_cast<uint8_t>(rnd());
+                }
+            }
+            n_hashes += 1 + log.topics.size();
+        }
+    }
+
+    auto const run = [&](char const *const name, auto &&build) {
+        Receipt::Bloom block_bloom{};
+        auto const begin = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < n_iterations; ++i) {
+            std::vector<Receipt> receipts(n_receipts);
+            for (unsigned j = 0; j < n_receipts; ++j) {
+                build(receipts[j], block_logs[j]);
+            }
+            block_bloom = compute_bloom(receipts);
+        }
+        auto const elapsed = std::chrono::steady_clock::now() - begin;
+        auto const ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                .count();
+        std::cout << name << ": "
+                  << static_cast<double>(ns) /
+                         static_cast<double>(n_hashes * n_iterations)
+                  << " ns/hash, block bloom byte 0 = "
+                  << unsigned{block_bloom[0]} << std::endl;
+    };
+
+    using Logs = std::vector<Receipt::Log>;
+    run("per log", [](Receipt &receipt, Logs const &logs) {
+        for (auto const &log : logs) {
+            receipt.add_log(log);
+        }
+    });
+    run("batched", [](Receipt &receipt, Logs const &logs) {
+        receipt.logs = logs;
+        populate_bloom(receipt.bloom, receipt.logs);
+    });
+    return 0;
+}
@@ -20,36 +20,89 @@
 
 #include <intx/intx.hpp>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 
 MONAD_NAMESPACE_BEGIN
 
-void set_3_bits(Receipt::Bloom &bloom, byte_string_view const bytes)
+namespace
 {
-    // YP Eqn 29
-    auto const hash = keccak256(bytes);
-    for (unsigned i = 0; i < 3; ++i) {
-        // Poorly named intx function, this really is taking from our hash,
-        // which is returned as big endian, to host order so we can do calcs on
-        // `bit`
-        uint16_t const bit =
-            intx::to_big_endian(
-                reinterpret_cast<uint16_t const *>(hash.bytes)[i]) &
-            2047u;
-        unsigned int const byte = 255u - bit / 8u;
-        bloom[byte] |= static_cast<unsigned char>(1u << (bit & 7u));
+    void set_3_bits(Receipt::Bloom &bloom, hash256 const &hash)
+    {
+        // YP Eqn 29
+        for (unsigned i = 0; i < 3; ++i) {
+            // Poorly named intx function, this really is taking from our
+            // hash, which is returned as big endian, to host order so we can
+            // do calcs on `bit`
+            uint16_t const bit =
+                intx::to_big_endian(
+                    reinterpret_cast<uint16_t const *>(hash.bytes)[i]) &
+                2047u;
+            unsigned int const byte = 255u - bit / 8u;
+            bloom[byte] |= static_cast<unsigned char>(1u << (bit & 7u));
+        }
     }
+
+    // Queues the addresses and topics of logs and hashes them four at a
+    // time, setting the bloom bits of each batch as it completes
+    class BloomHasher
+    {
+        Receipt::Bloom &bloom_;
+        std::array<byte_string_view, 4> pending_{};
+        size_t size_{0};
+
+        void flush()
+        {
+            std::array<hash256, 4> hashes;
+            keccak256_x4(pending_, hashes);
+            for (size_t i = 0; i < size_; ++i) {
+                set_3_bits(bloom_, hashes[i]);
+            }
+            size_ = 0;
+        }
+
+    public:
+        explicit BloomHasher(Receipt::Bloom &bloom)
+            : bloom_{bloom}
+        {
+        }
+
+        ~BloomHasher()
+        {
+            if (size_ > 0) {
+                flush();
+            }
+        }
+
+        void push(byte_string_view const bytes)
+        {
+            pending_[size_++] = bytes;
+            if (size_ == pending_.size()) {
+                flush();
+            }
+        }
+    };
 }
 
-void populate_bloom(Receipt::Bloom &bloom, Receipt::Log const &log)
+void populate_bloom(Receipt::Bloom &bloom, std::span<Receipt::Log const> logs)
 {
     // YP Eqn 28
-    set_3_bits(bloom, to_byte_string_view(log.address.bytes));
-    for (auto const &i : log.topics) {
-        set_3_bits(bloom, to_byte_string_view(i.bytes));
+    BloomHasher hasher{bloom};
+    for (auto const &log : logs) {
+        hasher.push(to_byte_string_view(log.address.bytes));
+        for (auto const &topic : log.topics) {
+            hasher.push(to_byte_string_view(topic.bytes));
+        }
     }
 }
 
+void populate_bloom(Receipt::Bloom &bloom, Receipt::Log const &log)
+{
+    populate_bloom(bloom, std::span{&log, 1});
+}
+
 void Receipt::add_log(Receipt::Log const &log)
 {
     logs.push_back(log);
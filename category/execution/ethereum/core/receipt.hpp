@@ -21,6 +21,11 @@
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/ethereum/core/transaction.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
 MONAD_NAMESPACE_BEGIN
 
 struct Receipt
@@ -49,6 +54,23 @@ struct Receipt
 
 void populate_bloom(Receipt::Bloom &, Receipt::Log const &);
 
+// Sets the bloom bits of all the logs of a receipt, hashing their addresses
+// and topics in batches
+void populate_bloom(Receipt::Bloom &, std::span<Receipt::Log const>);
+
+// Ors a receipt bloom into a block bloom a word at a time
+inline void accumulate_bloom(Receipt::Bloom &acc, Receipt::Bloom const &bloom)
+{
+    for (size_t i = 0; i < acc.size(); i += sizeof(uint64_t)) {
+        uint64_t a;
+        uint64_t b;
+        std::memcpy(&a, &acc[i], sizeof(a));
+        std::memcpy(&b, &bloom[i], sizeof(b));
+        a |= b;
+        std::memcpy(&acc[i], &a, sizeof(a));
+    }
+}
+
 static_assert(sizeof(Receipt::Log) == 80);
 static_assert(alignof(Receipt::Log) == 8);
 
@@ -14,12 +14,14 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
 #include <category/execution/ethereum/core/receipt.hpp>
 
 #include <evmc/evmc.hpp>
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <vector>
 
 using namespace monad;
@@ -109,3 +111,35 @@ TEST(Receipt, add_log)
     EXPECT_EQ(output, r.bloom);
     EXPECT_EQ(v, r.logs);
 }
+
+TEST(Receipt, populate_bloom_batched)
+{
+    // Logs with zero to four topics, so the batches of four hashes straddle
+    // log boundaries
+    std::vector<Receipt::Log> logs;
+    for (unsigned i = 0; i < 10; ++i) {
+        Receipt::Log log{.address = Address{}};
+        log.address.bytes[19] = static_cast<uint8_t>(i);
+        for (unsigned j = 0; j < i % 5; ++j) {
+            bytes32_t topic{};
+            topic.bytes[0] = static_cast<uint8_t>(i);
+            topic.bytes[31] = static_cast<uint8_t>(j);
+            log.topics.push_back(topic);
+        }
+        logs.push_back(log);
+    }
+
+    Receipt expected{};
+    for (auto const &log : logs) {
+        expected.add_log(log);
+    }
+    Receipt::Bloom bloom{};
+    populate_bloom(bloom, logs);
+    EXPECT_EQ(bloom, expected.bloom);
+
+    Receipt::Bloom acc{};
+    acc[0] = 0x80;
+    accumulate_bloom(acc, bloom);
+    bloom[0] |= 0x80;
+    EXPECT_EQ(acc, bloom);
+}
@@ -0,0 +1,581 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/core/likely.h>
+#include <category/core/result.hpp>
+#include <category/core/unaligned.hpp>
+#include <category/execution/ethereum/block_hash_buffer.hpp>
+#include <category/execution/ethereum/core/account.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/core/rlp/address_rlp.hpp>
+#include <category/execution/ethereum/core/rlp/block_rlp.hpp>
+#include <category/execution/ethereum/core/rlp/bytes_rlp.hpp>
+#include <category/execution/ethereum/core/rlp/int_rlp.hpp>
+#include <category/execution/ethereum/core/rlp/receipt_rlp.hpp>
+#include <category/execution/ethereum/db/block_capture.hpp>
+#include <category/execution/ethereum/db/db.hpp>
+#include <category/execution/ethereum/db/util.hpp>
+#include <category/execution/ethereum/rlp/decode.hpp>
+#include <category/execution/ethereum/rlp/decode_error.hpp>
+#include <category/execution/ethereum/rlp/encode2.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/execution/ethereum/types/incarnation.hpp>
+#include <category/vm/code.hpp>
+#include <category/vm/vm.hpp>
+
+#include <boost/outcome/try.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+byte_string encode_account_entry(
+    Address const &address, std::optional<Account> const &account)
+{
+    if (account.has_value()) {
+        return encode_account_db(address, account.value());
+    }
+    return rlp::encode_list2(rlp::encode_address(address));
+}
+
+Result<std::pair<Address, std::optional<Account>>>
+decode_account_entry(byte_string_view &enc)
+{
+    // an absent account is encoded as its address alone
+    byte_string_view absent = enc;
+    BOOST_OUTCOME_TRY(auto const raw, decode_account_db_raw(absent));
+    if (raw.second.empty()) {
+        enc = absent;
+        return std::pair<Address, std::optional<Account>>{
+            unaligned_load<Address>(raw.first.data()), std::nullopt};
+    }
+    BOOST_OUTCOME_TRY(auto const entry, decode_account_db(enc));
+    return std::pair<Address, std::optional<Account>>{
+        entry.first, entry.second};
+}
+
+byte_string encode_addresses(std::vector<Address> const &addresses)
+{
+    byte_string encoded;
+    for (auto const &address : addresses) {
+        encoded += rlp::encode_address(address);
+    }
+    return rlp::encode_list2(encoded);
+}
+
+Result<std::vector<Address>> decode_addresses(byte_string_view &enc)
+{
+    BOOST_OUTCOME_TRY(auto payload, rlp::parse_list_metadata(enc));
+    std::vector<Address> addresses;
+    while (!payload.empty()) {
+        BOOST_OUTCOME_TRY(auto const address, rlp::decode_address(payload));
+        addresses.push_back(address);
+    }
+    return addresses;
+}
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_NAMESPACE_BEGIN
+
+byte_string encode_state_changes(
+    StateDeltas const &state_deltas, std::vector<Receipt> const &receipts)
+{
+    std::map<Address, StateDelta const *> sorted;
+    for (auto const &[address, delta] : state_deltas) {
+        sorted.emplace(address, &delta);
+    }
+
+    byte_string encoded;
+    for (auto const &[address, delta] : sorted) {
+        std::map<bytes32_t, StorageDelta const *> storage;
+        for (auto const &[key, value] : delta->storage) {
+            if (value.first != value.second) {
+                storage.emplace(key, &value);
+            }
+        }
+        auto const &[before, after] = delta->account;
+        if (before == after && storage.empty()) {
+            continue;
+        }
+        byte_string encoded_storage;
+        for (auto const &[key, value] : storage) {
+            encoded_storage += rlp::encode_list2(
+                rlp::encode_bytes32_compact(key),
+                rlp::encode_bytes32_compact(value->first),
+                rlp::encode_bytes32_compact(value->second));
+        }
+        encoded += rlp::encode_list2(
+            encode_account_entry(address, before),
+            encode_account_entry(address, after),
+            rlp::encode_list2(encoded_storage));
+    }
+    byte_string encoded_receipts;
+    for (Receipt const &receipt : receipts) {
+        encoded_receipts += rlp::encode_receipt(receipt);
+    }
+    return rlp::encode_list2(
+        rlp::encode_list2(encoded), rlp::encode_list2(encoded_receipts));
+}
+
+byte_string encode_block_capture(BlockCapture const &capture)
+{
+    byte_string accounts;
+    for (auto const &[address, account] : capture.accounts) {
+        accounts += encode_account_entry(address, account);
+    }
+    byte_string storage;
+    for (auto const &slot : capture.storage) {
+        storage += rlp::encode_list2(
+            rlp::encode_address(slot.address),
+            rlp::encode_unsigned(slot.incarnation.to_int()),
+            rlp::encode_bytes32_compact(slot.key),
+            rlp::encode_bytes32_compact(slot.value));
+    }
+    byte_string code;
+    for (auto const &[code_hash, bytes] : capture.code) {
+        code += rlp::encode_list2(
+            rlp::encode_bytes32(code_hash), rlp::encode_string2(bytes));
+    }
+    byte_string block_hashes;
+    for (auto const &[number, hash] : capture.block_hashes) {
+        block_hashes += rlp::encode_list2(
+            rlp::encode_unsigned(number), rlp::encode_bytes32(hash));
+    }
+    return rlp::encode_list2(
+        rlp::encode_block(capture.block),
+        rlp::encode_list2(accounts),
+        rlp::encode_list2(storage),
+        rlp::encode_list2(code),
+        rlp::encode_list2(block_hashes),
+        encode_addresses(capture.parent_senders_and_authorities),
+        encode_addresses(capture.grandparent_senders_and_authorities),
+        rlp::encode_string2(capture.state_changes));
+}
+
+Result<BlockCapture> decode_block_capture(byte_string_view &enc)
+{
+    BlockCapture capture;
+    BOOST_OUTCOME_TRY(auto payload, rlp::parse_list_metadata(enc));
+    BOOST_OUTCOME_TRY(capture.block, rlp::decode_block(payload));
+    {
+        BOOST_OUTCOME_TRY(auto accounts, rlp::parse_list_metadata(payload));
+        while (!accounts.empty()) {
+            BOOST_OUTCOME_TRY(
+                auto const entry, decode_account_entry(accounts));
+            capture.accounts.push_back(entry);
+        }
+    }
+    {
+        BOOST_OUTCOME_TRY(auto storage, rlp::parse_list_metadata(payload));
+        while (!storage.empty()) {
+            BOOST_OUTCOME_TRY(auto slot, rlp::parse_list_metadata(storage));
+            BOOST_OUTCOME_TRY(auto const address, rlp::decode_address(slot));
+            BOOST_OUTCOME_TRY(
+                auto const incarnation,
+                rlp::decode_unsigned<uint64_t>(slot));
+            BOOST_OUTCOME_TRY(
+                auto const key, rlp::decode_bytes32_compact(slot));
+            BOOST_OUTCOME_TRY(
+                auto const value, rlp::decode_bytes32_compact(slot));
+            capture.storage.push_back(CapturedStorage{
+                .address = address,
+                .incarnation = Incarnation::from_int(incarnation),
+                .key = key,
+                .value = value});
+        }
+    }
+    {
+        BOOST_OUTCOME_TRY(auto code, rlp::parse_list_metadata(payload));
+        while (!code.empty()) {
+            BOOST_OUTCOME_TRY(auto entry, rlp::parse_list_metadata(code));
+            BOOST_OUTCOME_TRY(
+                auto const code_hash, rlp::decode_bytes32(entry));
+            BOOST_OUTCOME_TRY(auto const bytes, rlp::decode_string(entry));
+            capture.code.emplace_back(code_hash, byte_string{bytes});
+        }
+    }
+    {
+        BOOST_OUTCOME_TRY(auto hashes, rlp::parse_list_metadata(payload));
+        while (!hashes.empty()) {
+            BOOST_OUTCOME_TRY(auto entry, rlp::parse_list_metadata(hashes));
+            BOOST_OUTCOME_TRY(
+                auto const number, rlp::decode_unsigned<uint64_t>(entry));
+            BOOST_OUTCOME_TRY(auto const hash, rlp::decode_bytes32(entry));
+            capture.block_hashes.emplace_back(number, hash);
+        }
+    }
+    BOOST_OUTCOME_TRY(
+        capture.parent_senders_and_authorities, decode_addresses(payload));
+    BOOST_OUTCOME_TRY(
+        capture.grandparent_senders_and_authorities,
+        decode_addresses(payload));
+    BOOST_OUTCOME_TRY(
+        auto const state_changes, rlp::decode_string(payload));
+    capture.state_changes = byte_string{state_changes};
+    if (MONAD_UNLIKELY(!payload.empty())) {
+        return rlp::DecodeError::InputTooLong;
+    }
+    return capture;
+}
+
+CaptureDb::CaptureDb(Db &db)
+    : db_{db}
+{
+}
+
+BlockCapture CaptureDb::take()
+{
+    std::lock_guard const lock{mutex_};
+    BlockCapture capture = std::move(capture_);
+    capture_ = BlockCapture{};
+    for (auto const &[address, account] : accounts_) {
+        capture.accounts.emplace_back(address, account);
+    }
+    for (auto const &[key, value] : storage_) {
+        auto const &[address, incarnation, slot] = key;
+        capture.storage.push_back(CapturedStorage{
+            .address = address,
+            .incarnation = Incarnation::from_int(incarnation),
+            .key = slot,
+            .value = value});
+    }
+    for (auto const &[code_hash, icode] : code_) {
+        capture.code.emplace_back(
+            code_hash, byte_string{icode->code(), icode->size()});
+    }
+    accounts_.clear();
+    storage_.clear();
+    code_.clear();
+    return capture;
+}
+
+std::optional<Account> CaptureDb::read_account(Address const &address)
+{
+    auto result = db_.read_account(address);
+    std::lock_guard const lock{mutex_};
+    accounts_.emplace(address, result);
+    return result;
+}
+
+bytes32_t CaptureDb::read_storage(
+    Address const &address, Incarnation const incarnation,
+    bytes32_t const &key)
+{
+    auto const result = db_.read_storage(address, incarnation, key);
+    std::lock_guard const lock{mutex_};
+    storage_.emplace(std::tuple{address, incarnation.to_int(), key}, result);
+    return result;
+}
+
+vm::SharedIntercode CaptureDb::read_code(bytes32_t const &code_hash)
+{
+    auto result = db_.read_code(code_hash);
+    std::lock_guard const lock{mutex_};
+    code_.emplace(code_hash, result);
+    return result;
+}
+
+void CaptureDb::record_commit(
+    StateDeltas const &state_deltas, BlockHeader const &header,
+    std::vector<Receipt> const &receipts,
+    std::vector<Transaction> const &transactions,
+    std::vector<BlockHeader> const &ommers,
+    std::optional<std::vector<Withdrawal>> const &withdrawals)
+{
+    std::lock_guard const lock{mutex_};
+    // Code cached by the VM is not read through the database, so the code of
+    // every account read is loaded here
+    for (auto const &[address, account] : accounts_) {
+        if (account.has_value() && account->code_hash != NULL_HASH &&
+            !code_.contains(account->code_hash)) {
+            code_.emplace(
+                account->code_hash, db_.read_code(account->code_hash));
+        }
+    }
+    capture_.block = Block{
+        .header = header,
+        .transactions = transactions,
+        .ommers = ommers,
+        .withdrawals = withdrawals};
+    capture_.state_changes = encode_state_changes(state_deltas, receipts);
+}
+
+void CaptureDb::commit(
+    StateDeltas const &state_deltas, Code const &code,
+    bytes32_t const &block_id, BlockHeader const &header,
+    std::vector<Receipt> const &receipts,
+    std::vector<std::vector<CallFrame>> const &call_frames,
+    std::vector<Address> const &senders,
+    std::vector<Transaction> const &transactions,
+    std::vector<BlockHeader> const &ommers,
+    std::optional<std::vector<Withdrawal>> const &withdrawals)
+{
+    record_commit(
+        state_deltas, header, receipts, transactions, ommers, withdrawals);
+    db_.commit(
+        state_deltas,
+        code,
+        block_id,
+        header,
+        receipts,
+        call_frames,
+        senders,
+        transactions,
+        ommers,
+        withdrawals);
+}
+
+void CaptureDb::commit(
+    std::unique_ptr<StateDeltas> state_deltas, Code const &code,
+    bytes32_t const &block_id, BlockHeader const &header,
+    std::vector<Receipt> const &receipts,
+    std::vector<std::vector<CallFrame>> const &call_frames,
+    std::vector<Address> const &senders,
+    std::vector<Transaction> const &transactions,
+    std::vector<BlockHeader> const &ommers,
+    std::optional<std::vector<Withdrawal>> const &withdrawals)
+{
+    record_commit(
+        *state_deltas, header, receipts, transactions, ommers, withdrawals);
+    db_.commit(
+        std::move(state_deltas),
+        code,
+        block_id,
+        header,
+        receipts,
+        call_frames,
+        senders,
+        transactions,
+        ommers,
+        withdrawals);
+}
+
+BlockHeader CaptureDb::read_eth_header()
+{
+    return db_.read_eth_header();
+}
+
+bytes32_t CaptureDb::state_root()
+{
+    return db_.state_root();
+}
+
+bytes32_t CaptureDb::receipts_root()
+{
+    return db_.receipts_root();
+}
+
+bytes32_t CaptureDb::transactions_root()
+{
+    return db_.transactions_root();
+}
+
+std::optional<bytes32_t> CaptureDb::withdrawals_root()
+{
+    return db_.withdrawals_root();
+}
+
+void CaptureDb::set_block_and_prefix(
+    uint64_t const block_number, bytes32_t const &block_id)
+{
+    db_.set_block_and_prefix(block_number, block_id);
+}
+
+void CaptureDb::finalize(uint64_t const block_number, bytes32_t const &block_id)
+{
+    db_.finalize(block_number, block_id);
+}
+
+void CaptureDb::update_verified_block(uint64_t const block_number)
+{
+    db_.update_verified_block(block_number);
+}
+
+void CaptureDb::update_voted_metadata(
+    uint64_t const block_number, bytes32_t const &block_id)
+{
+    db_.update_voted_metadata(block_number, block_id);
+}
+
+void CaptureDb::update_proposed_metadata(
+    uint64_t const block_number, bytes32_t const &block_id)
+{
+    db_.update_proposed_metadata(block_number, block_id);
+}
+
+uint64_t CaptureDb::get_block_number() const
+{
+    return db_.get_block_number();
+}
+
+std::string CaptureDb::print_stats()
+{
+    return db_.print_stats();
+}
+
+Db::Stats CaptureDb::stats()
+{
+    return db_.stats();
+}
+
+CaptureBlockHashBuffer::CaptureBlockHashBuffer(BlockHashBuffer const &buf)
+    : buf_{buf}
+{
+}
+
+uint64_t CaptureBlockHashBuffer::n() const
+{
+    return buf_.n();
+}
+
+bytes32_t const &CaptureBlockHashBuffer::get(uint64_t const n) const
+{
+    auto const &hash = buf_.get(n);
+    std::lock_guard const lock{mutex_};
+    hashes_.emplace(n, hash);
+    return hash;
+}
+
+std::vector<std::pair<uint64_t, bytes32_t>> CaptureBlockHashBuffer::take()
+{
+    std::lock_guard const lock{mutex_};
+    std::vector<std::pair<uint64_t, bytes32_t>> hashes{
+        hashes_.begin(), hashes_.end()};
+    hashes_.clear();
+    return hashes;
+}
+
+ReplayDb::ReplayDb(BlockCapture const &capture)
+    : header_{capture.block.header}
+{
+    for (auto const &[address, account] : capture.accounts) {
+        accounts_.emplace(address, account);
+    }
+    for (auto const &slot : capture.storage) {
+        storage_.emplace(
+            std::tuple{slot.address, slot.incarnation.to_int(), slot.key},
+            slot.value);
+    }
+    for (auto const &[code_hash, code] : capture.code) {
+        code_.emplace(code_hash, vm::make_shared_intercode(code));
+    }
+}
+
+std::optional<Account> ReplayDb::read_account(Address const &address)
+{
+    auto const it = accounts_.find(address);
+    return it == accounts_.end() ? std::nullopt : it->second;
+}
+
+bytes32_t ReplayDb::read_storage(
+    Address const &address, Incarnation const incarnation,
+    bytes32_t const &key)
+{
+    auto const it =
+        storage_.find(std::tuple{address, incarnation.to_int(), key});
+    return it == storage_.end() ? bytes32_t{} : it->second;
+}
+
+vm::SharedIntercode ReplayDb::read_code(bytes32_t const &code_hash)
+{
+    if (code_hash == NULL_HASH) {
+        return vm::make_shared_intercode({});
+    }
+    auto const it = code_.find(code_hash);
+    MONAD_ASSERT(it != code_.end());
+    return it->second;
+}
+
+BlockHeader ReplayDb::read_eth_header()
+{
+    return header_;
+}
+
+bytes32_t ReplayDb::state_root()
+{
+    return header_.state_root;
+}
+
+bytes32_t ReplayDb::receipts_root()
+{
+    return header_.receipts_root;
+}
+
+bytes32_t ReplayDb::transactions_root()
+{
+    return header_.transactions_root;
+}
+
+std::optional<bytes32_t> ReplayDb::withdrawals_root()
+{
+    return header_.withdrawals_root;
+}
+
+void ReplayDb::set_block_and_prefix(uint64_t, bytes32_t const &) {}
+
+void ReplayDb::finalize(uint64_t, bytes32_t const &) {}
+
+void ReplayDb::update_verified_block(uint64_t) {}
+
+void ReplayDb::update_voted_metadata(uint64_t, bytes32_t const &) {}
+
+void ReplayDb::update_proposed_metadata(uint64_t, bytes32_t const &) {}
+
+uint64_t ReplayDb::get_block_number() const
+{
+    return header_.number - 1;
+}
+
+void ReplayDb::commit(
+    StateDeltas const &state_deltas, Code const &, bytes32_t const &,
+    BlockHeader const &, std::vector<Receipt> const &receipts,
+    std::vector<std::vector<CallFrame>> const &, std::vector<Address> const &,
+    std::vector<Transaction> const &, std::vector<BlockHeader> const &,
+    std::optional<std::vector<Withdrawal>> const &)
+{
+    state_changes_ = encode_state_changes(state_deltas, receipts);
+}
+
+ReplayBlockHashBuffer::ReplayBlockHashBuffer(BlockCapture const &capture)
+    : n_{capture.block.header.number}
+    , hashes_{capture.block_hashes.begin(), capture.block_hashes.end()}
+{
+}
+
+uint64_t ReplayBlockHashBuffer::n() const
+{
+    return n_;
+}
+
+bytes32_t const &ReplayBlockHashBuffer::get(uint64_t const n) const
+{
+    static bytes32_t const missing{};
+    auto const it = hashes_.find(n);
+    return it == hashes_.end() ? missing : it->second;
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,230 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/core/result.hpp>
+#include <category/execution/ethereum/block_hash_buffer.hpp>
+#include <category/execution/ethereum/core/account.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/core/receipt.hpp>
+#include <category/execution/ethereum/db/db.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/execution/ethereum/types/incarnation.hpp>
+#include <category/vm/vm.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+MONAD_NAMESPACE_BEGIN
+
+struct CapturedStorage
+{
+    Address address;
+    Incarnation incarnation;
+    bytes32_t key;
+    bytes32_t value;
+};
+
+// The values a block read from the database and the block hash buffer while
+// it executed, and the changes it made, so that it can be executed again
+// without the database. Reads of speculative executions that did not merge
+// are included, so the reads are a superset of what the block depends on
+struct BlockCapture
+{
+    Block block{};
+    std::vector<std::pair<Address, std::optional<Account>>> accounts{};
+    std::vector<CapturedStorage> storage{};
+    std::vector<std::pair<bytes32_t, byte_string>> code{};
+    std::vector<std::pair<uint64_t, bytes32_t>> block_hashes{};
+    // Monad reserve balance checks depend on the senders and authorities of
+    // the two blocks before
+    std::vector<Address> parent_senders_and_authorities{};
+    std::vector<Address> grandparent_senders_and_authorities{};
+    // Encoded by `encode_state_changes`
+    byte_string state_changes{};
+};
+
+// Accounts and slots whose value changed, ordered by address and key, so
+// the encoding does not depend on which speculative reads happened, followed
+// by the receipts of the block
+byte_string
+encode_state_changes(StateDeltas const &, std::vector<Receipt> const &);
+
+byte_string encode_block_capture(BlockCapture const &);
+Result<BlockCapture> decode_block_capture(byte_string_view &);
+
+// Forwards to another database and records what the block reads through
+// it and the changes it commits
+class CaptureDb final : public Db
+{
+    Db &db_;
+    std::mutex mutex_;
+    std::map<Address, std::optional<Account>> accounts_;
+    std::map<std::tuple<Address, uint64_t, bytes32_t>, bytes32_t> storage_;
+    std::map<bytes32_t, vm::SharedIntercode> code_;
+    BlockCapture capture_;
+
+    void record_commit(
+        StateDeltas const &, BlockHeader const &, std::vector<Receipt> const &,
+        std::vector<Transaction> const &, std::vector<BlockHeader> const &,
+        std::optional<std::vector<Withdrawal>> const &);
+
+public:
+    explicit CaptureDb(Db &);
+
+    // The capture of the block committed last
+    BlockCapture take();
+
+    virtual std::optional<Account> read_account(Address const &) override;
+    virtual bytes32_t
+    read_storage(Address const &, Incarnation, bytes32_t const &key) override;
+    virtual vm::SharedIntercode read_code(bytes32_t const &) override;
+
+    virtual BlockHeader read_eth_header() override;
+    virtual bytes32_t state_root() override;
+    virtual bytes32_t receipts_root() override;
+    virtual bytes32_t transactions_root() override;
+    virtual std::optional<bytes32_t> withdrawals_root() override;
+
+    virtual void set_block_and_prefix(
+        uint64_t block_number,
+        bytes32_t const &block_id = bytes32_t{}) override;
+    virtual void
+    finalize(uint64_t block_number, bytes32_t const &block_id) override;
+    virtual void update_verified_block(uint64_t block_number) override;
+    virtual void update_voted_metadata(
+        uint64_t block_number, bytes32_t const &block_id) override;
+    virtual void update_proposed_metadata(
+        uint64_t block_number, bytes32_t const &block_id) override;
+
+    virtual uint64_t get_block_number() const override;
+
+    virtual void commit(
+        StateDeltas const &, Code const &, bytes32_t const &block_id,
+        BlockHeader const &, std::vector<Receipt> const & = {},
+        std::vector<std::vector<CallFrame>> const & = {},
+        std::vector<Address> const & = {},
+        std::vector<Transaction> const & = {},
+        std::vector<BlockHeader> const &ommers = {},
+        std::optional<std::vector<Withdrawal>> const & = std::nullopt) override;
+
+    virtual void commit(
+        std::unique_ptr<StateDeltas>, Code const &, bytes32_t const &block_id,
+        BlockHeader const &, std::vector<Receipt> const & = {},
+        std::vector<std::vector<CallFrame>> const & = {},
+        std::vector<Address> const & = {},
+        std::vector<Transaction> const & = {},
+        std::vector<BlockHeader> const &ommers = {},
+        std::optional<std::vector<Withdrawal>> const & = {}) override;
+
+    virtual std::string print_stats() override;
+    virtual Stats stats() override;
+};
+
+// Forwards to another block hash buffer and records the hashes looked up
+class CaptureBlockHashBuffer final : public BlockHashBuffer
+{
+    BlockHashBuffer const &buf_;
+    mutable std::mutex mutex_;
+    mutable std::map<uint64_t, bytes32_t> hashes_;
+
+public:
+    explicit CaptureBlockHashBuffer(BlockHashBuffer const &);
+
+    uint64_t n() const override;
+    bytes32_t const &get(uint64_t) const override;
+
+    std::vector<std::pair<uint64_t, bytes32_t>> take();
+};
+
+// Serves the reads of a captured block and encodes the changes it commits.
+// A read the capture does not have can only come from a speculative
+// execution that will not merge, and sees an empty account or slot
+class ReplayDb final : public Db
+{
+    BlockHeader header_;
+    std::unordered_map<Address, std::optional<Account>> accounts_;
+    std::map<std::tuple<Address, uint64_t, bytes32_t>, bytes32_t> storage_;
+    std::unordered_map<bytes32_t, vm::SharedIntercode> code_;
+    byte_string state_changes_;
+
+public:
+    explicit ReplayDb(BlockCapture const &);
+
+    byte_string const &state_changes() const
+    {
+        return state_changes_;
+    }
+
+    virtual std::optional<Account> read_account(Address const &) override;
+    virtual bytes32_t
+    read_storage(Address const &, Incarnation, bytes32_t const &key) override;
+    virtual vm::SharedIntercode read_code(bytes32_t const &) override;
+
+    virtual BlockHeader read_eth_header() override;
+    virtual bytes32_t state_root() override;
+    virtual bytes32_t receipts_root() override;
+    virtual bytes32_t transactions_root() override;
+    virtual std::optional<bytes32_t> withdrawals_root() override;
+
+    virtual void set_block_and_prefix(
+        uint64_t block_number,
+        bytes32_t const &block_id = bytes32_t{}) override;
+    virtual void
+    finalize(uint64_t block_number, bytes32_t const &block_id) override;
+    virtual void update_verified_block(uint64_t block_number) override;
+    virtual void update_voted_metadata(
+        uint64_t block_number, bytes32_t const &block_id) override;
+    virtual void update_proposed_metadata(
+        uint64_t block_number, bytes32_t const &block_id) override;
+
+    virtual uint64_t get_block_number() const override;
+
+    virtual void commit(
+        StateDeltas const &, Code const &, bytes32_t const &block_id,
+        BlockHeader const &, std::vector<Receipt> const & = {},
+        std::vector<std::vector<CallFrame>> const & = {},
+        std::vector<Address> const & = {},
+        std::vector<Transaction> const & = {},
+        std::vector<BlockHeader> const &ommers = {},
+        std::optional<std::vector<Withdrawal>> const & = std::nullopt) override;
+};
+
+// Serves the block hashes of a captured block
+class ReplayBlockHashBuffer final : public BlockHashBuffer
+{
+    uint64_t n_;
+    std::unordered_map<uint64_t, bytes32_t> hashes_;
+
+public:
+    explicit ReplayBlockHashBuffer(BlockCapture const &);
+
+    uint64_t n() const override;
+    bytes32_t const &get(uint64_t) const override;
+};
+
+MONAD_NAMESPACE_END
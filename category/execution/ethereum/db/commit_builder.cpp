@@ -35,9 +35,21 @@
 #include <category/execution/ethereum/validate_block.hpp>
 #include <category/mpt/nibbles_view.hpp>
 #include <category/mpt/update.hpp>
+#include <category/mpt/update_batch.hpp>
 #include <category/mpt/util.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
 
 MONAD_NAMESPACE_BEGIN
 
@@ -59,115 +71,210 @@ namespace
         return rlp::encode_list2(
             rlp::encode_string2(encoded_tx), rlp::encode_address(sender));
     }
+
+    // Smallest number of items a worker takes on at once, so that small
+    // blocks are not split into tasks that cost more than they save
+    constexpr size_t GRAIN_SIZE = 32;
 }
 
-CommitBuilder::CommitBuilder(uint64_t const block_number)
+CommitBuilder::CommitBuilder(
+    uint64_t const block_number, KeyHashCache &key_hashes)
     : block_number_{block_number}
+    , key_hashes_{key_hashes}
 {
 }
 
-CommitBuilder &CommitBuilder::add_state_deltas(StateDeltas const &state_deltas)
+CommitBuilder::Arena &CommitBuilder::new_arena()
 {
-    UpdateList account_updates;
-    for (auto const &[addr, delta] : state_deltas) {
-        UpdateList storage_updates;
-        std::optional<byte_string_view> value;
-        auto const &account = delta.account.second;
-        if (account.has_value()) {
-            for (auto const &[key, delta] : delta.storage) {
-                if (delta.first != delta.second) {
-                    storage_updates.push_front(
-                        update_alloc_.emplace_back(Update{
-                            .key = hash_alloc_.emplace_back(
-                                keccak256({key.bytes, sizeof(key.bytes)})),
-                            .value = delta.second == bytes32_t{}
-                                         ? std::nullopt
-                                         : std::make_optional<byte_string_view>(
-                                               bytes_alloc_.emplace_back(
-                                                   encode_storage_db(
-                                                       key, delta.second))),
-                            .incarnation = false,
-                            .next = UpdateList{},
-                            .version = static_cast<int64_t>(block_number_)}));
-                }
-            }
-            value = bytes_alloc_.emplace_back(
-                encode_account_db(addr, account.value()));
-        }
+    std::lock_guard const guard{mutex_};
+    return arenas_.emplace_back();
+}
+
+void CommitBuilder::add_subtrie(Arena &arena, Update &&update)
+{
+    Update &subtrie = arena.updates.emplace_back(std::move(update));
+    std::lock_guard const guard{mutex_};
+    updates_.push_front(subtrie);
+}
 
-        if (!storage_updates.empty() || delta.account.first != account) {
-            bool const incarnation =
-                account.has_value() && delta.account.first.has_value() &&
-                delta.account.first->incarnation != account->incarnation;
-            account_updates.push_front(update_alloc_.emplace_back(Update{
-                .key = hash_alloc_.emplace_back(
-                    keccak256({addr.bytes, sizeof(addr.bytes)})),
-                .value = value,
-                .incarnation = incarnation,
-                .next = std::move(storage_updates),
-                .version = static_cast<int64_t>(block_number_)}));
+// Runs `body` over `range` in parallel. Each worker thread allocates from an
+// arena of its own and appends to its own N vectors of updates; the vectors
+// are then kept in `arena` and linked into N lists.
+template <size_t N, class Range, class Body>
+std::array<UpdateList, N> CommitBuilder::build_parallel(
+    Range const &range, Arena &arena, Body const &body)
+{
+    using Outputs = std::array<std::vector<Update>, N>;
+
+    struct Worker
+    {
+        Arena *arena;
+        Outputs outputs;
+    };
+
+    tbb::enumerable_thread_specific<Worker> workers{
+        [this] { return Worker{.arena = &new_arena(), .outputs = {}}; }};
+    tbb::parallel_for(range, [&](Range const &subrange) {
+        Worker &worker = workers.local();
+        body(subrange, *worker.arena, worker.outputs);
+    });
+
+    std::array<UpdateList, N> lists;
+    for (Worker &worker : workers) {
+        for (size_t i = 0; i < N; ++i) {
+            auto &updates =
+                arena.update_arrays.emplace_back(std::move(worker.outputs[i]));
+            for (Update &update : updates) {
+                lists[i].push_front(update);
+            }
         }
     }
+    return lists;
+}
 
-    updates_.push_front(update_alloc_.emplace_back(Update{
-        .key = state_nibbles,
-        .value = byte_string_view{},
-        .incarnation = false,
-        .next = std::move(account_updates),
-        .version = static_cast<int64_t>(block_number_)}));
+CommitBuilder &CommitBuilder::add_state_deltas(StateDeltas const &state_deltas)
+{
+    Arena &arena = new_arena();
+    auto [updates] = build_parallel<1>(
+        state_deltas.range(GRAIN_SIZE),
+        arena,
+        [this](
+            StateDeltas::const_range_type const &range,
+            Arena &local,
+            std::array<std::vector<Update>, 1> &outputs) {
+            for (auto const &[addr, delta] : range) {
+                UpdateBatch &storage_updates = local.batches.emplace_back();
+                std::optional<byte_string_view> value;
+                auto const &account = delta.account.second;
+                if (account.has_value()) {
+                    storage_updates.reserve(delta.storage.size());
+                    for (auto const &[key, delta] : delta.storage) {
+                        if (delta.first != delta.second) {
+                            storage_updates.push_back(Update{
+                                .key = local.hashes.emplace_back(
+                                    key_hashes_.slot(key)),
+                                .value =
+                                    delta.second == bytes32_t{}
+                                        ? std::nullopt
+                                        : std::make_optional<byte_string_view>(
+                                              local.bytes.emplace_back(
+                                                  encode_storage_db(
+                                                      key, delta.second))),
+                                .incarnation = false,
+                                .next = UpdateList{},
+                                .version =
+                                    static_cast<int64_t>(block_number_)});
+                        }
+                    }
+                    value = local.bytes.emplace_back(
+                        encode_account_db(addr, account.value()));
+                }
+
+                if (!storage_updates.empty() ||
+                    delta.account.first != account) {
+                    bool const incarnation =
+                        account.has_value() &&
+                        delta.account.first.has_value() &&
+                        delta.account.first->incarnation !=
+                            account->incarnation;
+                    outputs[0].push_back(Update{
+                        .key = local.hashes.emplace_back(
+                            key_hashes_.account(addr)),
+                        .value = value,
+                        .incarnation = incarnation,
+                        .next = storage_updates.finalize(),
+                        .version = static_cast<int64_t>(block_number_)});
+                }
+            }
+        });
+
+    // Accounts and storage slots are keyed by hash and make up most of the
+    // updates of a block, so they are batched to be partitioned by range
+    UpdateBatch &account_updates = arena.batches.emplace_back();
+    account_updates.reserve(updates.size());
+    for (Update &update : updates) {
+        account_updates.push_back(std::move(update));
+    }
+    updates.clear();
+    arena.update_arrays.clear();
+
+    add_subtrie(
+        arena,
+        Update{
+            .key = state_nibbles,
+            .value = byte_string_view{},
+            .incarnation = false,
+            .next = account_updates.finalize(),
+            .version = static_cast<int64_t>(block_number_)});
 
     return *this;
 }
 
 CommitBuilder &CommitBuilder::add_code(Code const &code)
 {
+    Arena &arena = new_arena();
     UpdateList code_updates;
     for (auto const &[hash, icode] : code) {
         MONAD_ASSERT(icode);
-        code_updates.push_front(update_alloc_.emplace_back(Update{
+        code_updates.push_front(arena.updates.emplace_back(Update{
             .key = NibblesView{to_byte_string_view(hash.bytes)},
             .value = {{icode->code(), icode->size()}},
             .incarnation = false,
             .next = UpdateList{},
             .version = static_cast<int64_t>(block_number_)}));
     }
-    updates_.push_front(update_alloc_.emplace_back(Update{
-        .key = code_nibbles,
-        .value = byte_string_view{},
-        .incarnation = false,
-        .next = std::move(code_updates),
-        .version = static_cast<int64_t>(block_number_)}));
+    add_subtrie(
+        arena,
+        Update{
+            .key = code_nibbles,
+            .value = byte_string_view{},
+            .incarnation = false,
+            .next = std::move(code_updates),
+            .version = static_cast<int64_t>(block_number_)});
 
     return *this;
 }
 
 CommitBuilder &CommitBuilder::add_receipts(std::vector<Receipt> const &receipts)
 {
-    UpdateList receipt_updates;
     MONAD_ASSERT(receipts.size() <= std::numeric_limits<uint32_t>::max());
 
-    size_t log_index_begin = 0;
-    for (uint32_t i = 0; i < static_cast<uint32_t>(receipts.size()); ++i) {
-        auto const &rlp_index =
-            bytes_alloc_.emplace_back(rlp::encode_unsigned(i));
-        auto const &receipt = receipts[i];
-        auto const &encoded_receipt = bytes_alloc_.emplace_back(
-            encode_receipt_db(receipt, log_index_begin));
-        log_index_begin += receipt.logs.size();
-
-        receipt_updates.push_front(update_alloc_.emplace_back(Update{
-            .key = NibblesView{rlp_index},
-            .value = encoded_receipt,
-            .incarnation = false,
-            .next = UpdateList{},
-            .version = static_cast<int64_t>(block_number_)}));
+    std::vector<size_t> log_index_begin(receipts.size());
+    size_t num_logs = 0;
+    for (size_t i = 0; i < receipts.size(); ++i) {
+        log_index_begin[i] = num_logs;
+        num_logs += receipts[i].logs.size();
     }
-    updates_.push_front(update_alloc_.emplace_back(Update{
-        .key = receipt_nibbles,
-        .value = byte_string_view{},
-        .incarnation = true,
-        .next = std::move(receipt_updates),
-        .version = static_cast<int64_t>(block_number_)}));
+
+    Arena &arena = new_arena();
+    auto [receipt_updates] = build_parallel<1>(
+        tbb::blocked_range<uint32_t>{
+            0, static_cast<uint32_t>(receipts.size()), GRAIN_SIZE},
+        arena,
+        [&](tbb::blocked_range<uint32_t> const &range,
+            Arena &local,
+            std::array<std::vector<Update>, 1> &outputs) {
+            for (uint32_t i = range.begin(); i < range.end(); ++i) {
+                auto const &rlp_index =
+                    local.bytes.emplace_back(rlp::encode_unsigned(i));
+                auto const &encoded_receipt = local.bytes.emplace_back(
+                    encode_receipt_db(receipts[i], log_index_begin[i]));
+                outputs[0].push_back(Update{
+                    .key = NibblesView{rlp_index},
+                    .value = encoded_receipt,
+                    .incarnation = false,
+                    .next = UpdateList{},
+                    .version = static_cast<int64_t>(block_number_)});
+            }
+        });
+    add_subtrie(
+        arena,
+        Update{
+            .key = receipt_nibbles,
+            .value = byte_string_view{},
+            .incarnation = true,
+            .next = std::move(receipt_updates),
+            .version = static_cast<int64_t>(block_number_)});
 
     return *this;
 }
@@ -176,52 +283,63 @@ CommitBuilder &CommitBuilder::add_transactions(
     std::vector<Transaction> const &transactions,
     std::vector<Address> const &senders)
 {
-    UpdateList txn_updates;
-    UpdateList txn_hash_updates;
-
     MONAD_ASSERT(transactions.size() <= std::numeric_limits<uint32_t>::max());
     MONAD_ASSERT(transactions.size() == senders.size());
 
-    auto const encoded_block_number =
-        bytes_alloc_.emplace_back(rlp::encode_unsigned(block_number_));
-
-    for (uint32_t i = 0; i < static_cast<uint32_t>(transactions.size()); ++i) {
-        auto const &rlp_index =
-            bytes_alloc_.emplace_back(rlp::encode_unsigned(i));
-
-        auto const encoded_tx = rlp::encode_transaction(transactions[i]);
-        txn_updates.push_front(update_alloc_.emplace_back(Update{
-            .key = NibblesView{rlp_index},
-            .value = bytes_alloc_.emplace_back(
-                encode_transaction_db(encoded_tx, senders[i])),
-            .incarnation = false,
-            .next = UpdateList{},
-            .version = static_cast<int64_t>(block_number_)}));
-
-        txn_hash_updates.push_front(update_alloc_.emplace_back(Update{
-            .key = NibblesView{hash_alloc_.emplace_back(keccak256(encoded_tx))},
-            .value = bytes_alloc_.emplace_back(
-                rlp::encode_list2(encoded_block_number, rlp_index)),
-            .incarnation = false,
-            .next = UpdateList{},
-            .version = static_cast<int64_t>(block_number_)}));
-    }
+    auto const encoded_block_number = rlp::encode_unsigned(block_number_);
+
+    Arena &arena = new_arena();
+    auto [txn_updates, txn_hash_updates] = build_parallel<2>(
+        tbb::blocked_range<uint32_t>{
+            0, static_cast<uint32_t>(transactions.size()), GRAIN_SIZE},
+        arena,
+        [&](tbb::blocked_range<uint32_t> const &range,
+            Arena &local,
+            std::array<std::vector<Update>, 2> &outputs) {
+            for (uint32_t i = range.begin(); i < range.end(); ++i) {
+                auto const &rlp_index =
+                    local.bytes.emplace_back(rlp::encode_unsigned(i));
+
+                auto const encoded_tx =
+                    rlp::encode_transaction(transactions[i]);
+                outputs[0].push_back(Update{
+                    .key = NibblesView{rlp_index},
+                    .value = local.bytes.emplace_back(
+                        encode_transaction_db(encoded_tx, senders[i])),
+                    .incarnation = false,
+                    .next = UpdateList{},
+                    .version = static_cast<int64_t>(block_number_)});
+
+                outputs[1].push_back(Update{
+                    .key = NibblesView{
+                        local.hashes.emplace_back(keccak256(encoded_tx))},
+                    .value = local.bytes.emplace_back(
+                        rlp::encode_list2(encoded_block_number, rlp_index)),
+                    .incarnation = false,
+                    .next = UpdateList{},
+                    .version = static_cast<int64_t>(block_number_)});
+            }
+        });
 
     // txns subtrie
-    updates_.push_front(update_alloc_.emplace_back(Update{
-        .key = transaction_nibbles,
-        .value = byte_string_view{},
-        .incarnation = true,
-        .next = std::move(txn_updates),
-        .version = static_cast<int64_t>(block_number_)}));
+    add_subtrie(
+        arena,
+        Update{
+            .key = transaction_nibbles,
+            .value = byte_string_view{},
+            .incarnation = true,
+            .next = std::move(txn_updates),
+            .version = static_cast<int64_t>(block_number_)});
 
     // txns hash subtrie
-    updates_.push_front(update_alloc_.emplace_back(Update{
-        .key = tx_hash_nibbles,
-        .value = byte_string_view{},
-        .incarnation = false,
-        .next = std::move(txn_hash_updates),
-        .version = static_cast<int64_t>(block_number_)}));
+    add_subtrie(
+        arena,
+        Update{
+            .key = tx_hash_nibbles,
+            .value = byte_string_view{},
+            .incarnation = false,
+            .next = std::move(txn_hash_updates),
+            .version = static_cast<int64_t>(block_number_)});
 
     return *this;
 }
@@ -229,51 +347,65 @@ CommitBuilder &CommitBuilder::add_transactions(
 CommitBuilder &CommitBuilder::add_call_frames(
     std::vector<std::vector<CallFrame>> const &call_frames)
 {
-    UpdateList call_frame_updates;
-
     MONAD_ASSERT(call_frames.size() <= std::numeric_limits<uint32_t>::max());
 
-    for (uint32_t i = 0; i < static_cast<uint32_t>(call_frames.size()); ++i) {
-        byte_string_view frame_view =
-            bytes_alloc_.emplace_back(rlp::encode_call_frames(call_frames[i]));
-        uint8_t chunk_index = 0;
-        auto const call_frame_prefix =
-            serialize_as_big_endian<sizeof(uint32_t)>(i);
-
-        while (!frame_view.empty()) {
-            MONAD_ASSERT(chunk_index <= std::numeric_limits<uint8_t>::max());
-            byte_string_view chunk =
-                frame_view.substr(0, MAX_VALUE_LEN_OF_LEAF);
-            frame_view.remove_prefix(chunk.size());
-            byte_string const chunk_key =
-                byte_string{&chunk_index, sizeof(uint8_t)};
-            call_frame_updates.push_front(update_alloc_.emplace_back(Update{
-                .key = bytes_alloc_.emplace_back(call_frame_prefix + chunk_key),
-                .value = chunk,
-                .incarnation = false,
-                .next = UpdateList{},
-                .version = static_cast<int64_t>(block_number_)}));
-            ++chunk_index;
-        }
-    }
-    updates_.push_front(update_alloc_.emplace_back(Update{
-        .key = call_frame_nibbles,
-        .value = byte_string_view{},
-        .incarnation = true,
-        .next = std::move(call_frame_updates),
-        .version = static_cast<int64_t>(block_number_)}));
+    Arena &arena = new_arena();
+    auto [call_frame_updates] = build_parallel<1>(
+        tbb::blocked_range<uint32_t>{
+            0, static_cast<uint32_t>(call_frames.size()), GRAIN_SIZE},
+        arena,
+        [&](tbb::blocked_range<uint32_t> const &range,
+            Arena &local,
+            std::array<std::vector<Update>, 1> &outputs) {
+            for (uint32_t i = range.begin(); i < range.end(); ++i) {
+                byte_string_view frame_view = local.bytes.emplace_back(
+                    rlp::encode_call_frames(call_frames[i]));
+                uint8_t chunk_index = 0;
+                auto const call_frame_prefix =
+                    serialize_as_big_endian<sizeof(uint32_t)>(i);
+
+                while (!frame_view.empty()) {
+                    MONAD_ASSERT(
+                        chunk_index <= std::numeric_limits<uint8_t>::max());
+                    byte_string_view chunk =
+                        frame_view.substr(0, MAX_VALUE_LEN_OF_LEAF);
+                    frame_view.remove_prefix(chunk.size());
+                    byte_string const chunk_key =
+                        byte_string{&chunk_index, sizeof(uint8_t)};
+                    outputs[0].push_back(Update{
+                        .key = local.bytes.emplace_back(
+                            call_frame_prefix + chunk_key),
+                        .value = chunk,
+                        .incarnation = false,
+                        .next = UpdateList{},
+                        .version = static_cast<int64_t>(block_number_)});
+                    ++chunk_index;
+                }
+            }
+        });
+    add_subtrie(
+        arena,
+        Update{
+            .key = call_frame_nibbles,
+            .value = byte_string_view{},
+            .incarnation = true,
+            .next = std::move(call_frame_updates),
+            .version = static_cast<int64_t>(block_number_)});
 
     return *this;
 }
 
 CommitBuilder &CommitBuilder::add_ommers(std::vector<BlockHeader> const &ommers)
 {
-    updates_.push_front(update_alloc_.emplace_back(Update{
-        .key = ommer_nibbles,
-        .value = bytes_alloc_.emplace_back(rlp::encode_ommers(ommers)),
-        .incarnation = true,
-        .next = UpdateList{},
-        .version = static_cast<int64_t>(block_number_)}));
+    Arena &arena = new_arena();
+    add_subtrie(
+        arena,
+        Update{
+            .key = ommer_nibbles,
+            .value = arena.bytes.emplace_back(rlp::encode_ommers(ommers)),
+            .incarnation = true,
+            .next = UpdateList{},
+            .version = static_cast<int64_t>(block_number_)});
 
     return *this;
 }
@@ -281,68 +413,80 @@ CommitBuilder &CommitBuilder::add_ommers(std::vector<BlockHeader> const &ommers)
 CommitBuilder &
 CommitBuilder::add_withdrawals(std::vector<Withdrawal> const &withdrawals)
 {
+    Arena &arena = new_arena();
     UpdateList withdrawal_updates;
 
     for (size_t i = 0; i < withdrawals.size(); ++i) {
         auto const &rlp_index =
-            bytes_alloc_.emplace_back(rlp::encode_unsigned(i));
+            arena.bytes.emplace_back(rlp::encode_unsigned(i));
 
-        withdrawal_updates.push_front(update_alloc_.emplace_back(Update{
+        withdrawal_updates.push_front(arena.updates.emplace_back(Update{
             .key = NibblesView{rlp_index},
-            .value = bytes_alloc_.emplace_back(
+            .value = arena.bytes.emplace_back(
                 rlp::encode_withdrawal(withdrawals[i])),
             .incarnation = false,
             .next = UpdateList{},
             .version = static_cast<int64_t>(block_number_)}));
     }
-    updates_.push_front(update_alloc_.emplace_back(Update{
-        .key = withdrawal_nibbles,
-        .value = byte_string_view{},
-        .incarnation = true,
-        .next = std::move(withdrawal_updates),
-        .version = static_cast<int64_t>(block_number_)}));
+    add_subtrie(
+        arena,
+        Update{
+            .key = withdrawal_nibbles,
+            .value = byte_string_view{},
+            .incarnation = true,
+            .next = std::move(withdrawal_updates),
+            .version = static_cast<int64_t>(block_number_)});
 
     return *this;
 }
 
 CommitBuilder &CommitBuilder::add_block_header(BlockHeader const &header)
 {
+    Arena &arena = new_arena();
     auto const eth_header_rlp = rlp::encode_block_header(header);
 
     UpdateList block_hash_nested_updates;
-    block_hash_nested_updates.push_front(update_alloc_.emplace_back(Update{
-        .key = hash_alloc_.emplace_back(keccak256(eth_header_rlp)),
-        .value = bytes_alloc_.emplace_back(rlp::encode_unsigned(header.number)),
+    block_hash_nested_updates.push_front(arena.updates.emplace_back(Update{
+        .key = arena.hashes.emplace_back(keccak256(eth_header_rlp)),
+        .value = arena.bytes.emplace_back(rlp::encode_unsigned(header.number)),
         .incarnation = false,
         .next = UpdateList{},
         .version = static_cast<int64_t>(block_number_)}));
 
     // block header subtrie
-    updates_.push_front(update_alloc_.emplace_back(Update{
-        .key = block_header_nibbles,
-        .value = bytes_alloc_.emplace_back(eth_header_rlp),
-        .incarnation = true,
-        .next = UpdateList{},
-        .version = static_cast<int64_t>(block_number_)}));
+    add_subtrie(
+        arena,
+        Update{
+            .key = block_header_nibbles,
+            .value = arena.bytes.emplace_back(eth_header_rlp),
+            .incarnation = true,
+            .next = UpdateList{},
+            .version = static_cast<int64_t>(block_number_)});
 
     // block hash subtrie
-    updates_.push_front(update_alloc_.emplace_back(Update{
-        .key = block_hash_nibbles,
-        .value = byte_string_view{},
-        .incarnation = false,
-        .next = std::move(block_hash_nested_updates),
-        .version = static_cast<int64_t>(block_number_)}));
+    add_subtrie(
+        arena,
+        Update{
+            .key = block_hash_nibbles,
+            .value = byte_string_view{},
+            .incarnation = false,
+            .next = std::move(block_hash_nested_updates),
+            .version = static_cast<int64_t>(block_number_)});
 
     return *this;
 }
 
-UpdateList CommitBuilder::build(NibblesView const prefix)
+UpdateList
+CommitBuilder::build(NibblesView const prefix, bool const defer_write)
 {
+    Arena &arena = new_arena();
+    std::lock_guard const guard{mutex_};
     UpdateList root_update;
-    root_update.push_front(update_alloc_.emplace_back(Update{
+    root_update.push_front(arena.updates.emplace_back(Update{
         .key = prefix,
         .value = byte_string_view{},
         .incarnation = false,
+        .defer_write = defer_write,
         .next = std::move(updates_),
         .version = static_cast<int64_t>(block_number_)}));
     return root_update;
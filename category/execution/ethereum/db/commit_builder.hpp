@@ -18,10 +18,15 @@
 #include <category/core/byte_string.hpp>
 #include <category/core/bytes.hpp>
 #include <category/core/config.hpp>
+#include <category/execution/ethereum/db/key_hash_cache.hpp>
 #include <category/execution/ethereum/state2/state_deltas.hpp>
 #include <category/mpt/update.hpp>
+#include <category/mpt/update_batch.hpp>
 
+#include <array>
+#include <cstddef>
 #include <deque>
+#include <mutex>
 #include <vector>
 
 MONAD_NAMESPACE_BEGIN
@@ -32,16 +37,37 @@ struct BlockHeader;
 struct Receipt;
 struct Withdrawal;
 
+// Builds the updates of a block. The add_* calls may run concurrently with
+// each other, and the larger ones encode and hash in parallel themselves.
 class CommitBuilder
 {
-    std::deque<mpt::Update> update_alloc_;
-    std::deque<byte_string> bytes_alloc_;
-    std::deque<hash256> hash_alloc_;
+    // Storage of the updates and encodings made by one add_* call, or by one
+    // worker thread of a parallel one
+    struct Arena
+    {
+        std::deque<mpt::Update> updates;
+        std::deque<std::vector<mpt::Update>> update_arrays;
+        std::deque<mpt::UpdateBatch> batches;
+        std::deque<byte_string> bytes;
+        std::deque<hash256> hashes;
+    };
+
+    std::mutex mutex_;
+    std::deque<Arena> arenas_;
     mpt::UpdateList updates_;
     uint64_t block_number_;
+    KeyHashCache &key_hashes_;
+
+    Arena &new_arena();
+
+    void add_subtrie(Arena &, mpt::Update &&);
+
+    template <size_t N, class Range, class Body>
+    std::array<mpt::UpdateList, N>
+    build_parallel(Range const &, Arena &, Body const &);
 
 public:
-    explicit CommitBuilder(uint64_t block_number);
+    CommitBuilder(uint64_t block_number, KeyHashCache &);
 
     CommitBuilder &add_state_deltas(StateDeltas const &);
 
@@ -60,7 +86,9 @@ public:
 
     CommitBuilder &add_block_header(BlockHeader const &);
 
-    mpt::UpdateList build(mpt::NibblesView);
+    // With `defer_write`, the prefix node and the nodes above it are left
+    // unwritten for the next upsert of the block to write
+    mpt::UpdateList build(mpt::NibblesView, bool defer_write = false);
 };
 
 MONAD_NAMESPACE_END
@@ -97,6 +97,25 @@ struct Db
     {
         return {};
     }
+
+    // Running totals since construction, for export as metrics
+    struct Stats
+    {
+        uint64_t account_reads{0};
+        uint64_t account_cache_hits{0};
+        uint64_t storage_reads{0};
+        uint64_t storage_cache_hits{0};
+        uint64_t trie_bytes_written{0};
+        uint64_t trie_bytes_compacted{0};
+        // Versions erased by the last upsert to keep disk usage in band,
+        // the one value here that is not a running total
+        uint64_t trie_history_erase_rate{0};
+    };
+
+    virtual Stats stats()
+    {
+        return {};
+    }
 };
 
 MONAD_NAMESPACE_END
@@ -29,6 +29,8 @@
 
 #include <evmc/evmc.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <optional>
 
@@ -69,6 +71,11 @@ class DbCache final : public Db
     StorageCache storage_{10'000'000};
     Proposals proposals_;
 
+    std::atomic<uint64_t> n_account_reads_{0};
+    std::atomic<uint64_t> n_account_hits_{0};
+    std::atomic<uint64_t> n_storage_reads_{0};
+    std::atomic<uint64_t> n_storage_hits_{0};
+
 public:
     DbCache(Db &db)
         : db_{db}
@@ -77,14 +84,17 @@ public:
 
     virtual std::optional<Account> read_account(Address const &address) override
     {
+        n_account_reads_.fetch_add(1, std::memory_order_relaxed);
         bool truncated = false; // ancestors truncated
         std::optional<Account> result;
         if (proposals_.try_read_account(address, result, truncated)) {
+            n_account_hits_.fetch_add(1, std::memory_order_relaxed);
             return result;
         }
         if (!truncated) {
             AccountsCache::ConstAccessor acc{};
             if (accounts_.find(acc, address)) {
+                n_account_hits_.fetch_add(1, std::memory_order_relaxed);
                 return acc->second.value_;
             }
         }
@@ -95,16 +105,19 @@ public:
         Address const &address, Incarnation const incarnation,
         bytes32_t const &key) override
     {
+        n_storage_reads_.fetch_add(1, std::memory_order_relaxed);
         bool truncated = false;
         bytes32_t result;
         if (proposals_.try_read_storage(
                 address, incarnation, key, result, truncated)) {
+            n_storage_hits_.fetch_add(1, std::memory_order_relaxed);
             return result;
         }
         if (!truncated) {
             StorageKey const skey{address, incarnation, key};
             StorageCache::ConstAccessor acc{};
             if (storage_.find(acc, skey)) {
+                n_storage_hits_.fetch_add(1, std::memory_order_relaxed);
                 return acc->second.value_;
             }
         }
@@ -225,6 +238,18 @@ public:
                ",sc=" + storage_.print_stats();
     }
 
+    virtual Stats stats() override
+    {
+        Stats stats = db_.stats();
+        stats.account_reads = n_account_reads_.load(std::memory_order_relaxed);
+        stats.account_cache_hits =
+            n_account_hits_.load(std::memory_order_relaxed);
+        stats.storage_reads = n_storage_reads_.load(std::memory_order_relaxed);
+        stats.storage_cache_hits =
+            n_storage_hits_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
     virtual uint64_t get_block_number() const override
     {
         return db_.get_block_number();
@@ -0,0 +1,364 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/core/keccak.hpp>
+#include <category/core/unaligned.hpp>
+#include <category/execution/ethereum/db/key_bloom_filter.hpp>
+#include <category/execution/ethereum/db/key_hash_cache.hpp>
+#include <category/execution/ethereum/db/util.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/mpt/db.hpp>
+#include <category/mpt/nibbles_view.hpp>
+#include <category/mpt/node.hpp>
+#include <category/mpt/traverse.hpp>
+#include <category/mpt/util.hpp>
+
+#include <quill/Quill.h> // NOLINT
+#include <quill/detail/LogMacros.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <system_error>
+#include <utility>
+
+MONAD_NAMESPACE_BEGIN
+
+using namespace monad::mpt;
+
+namespace
+{
+    constexpr char FILE_MAGIC[8] = {'M', 'O', 'N', 'K', 'B', 'F', '0', '2'};
+
+    struct FileHeader
+    {
+        char magic[8];
+        uint64_t base_version;
+        uint64_t latest_version;
+        uint64_t num_blocks;
+        bytes32_t latest_roots;
+    };
+
+    // Trie keys are hashes, so their bytes are used as they are
+    uint64_t word_of(hash256 const &key, size_t const i)
+    {
+        return unaligned_load<uint64_t>(key.bytes + i * sizeof(uint64_t));
+    }
+
+    // Inserts the keys of the state trie into the filter
+    class PopulateMachine final : public TraverseMachine
+    {
+        KeyBloomFilter &filter_;
+        Nibbles path_{};
+
+        static hash256 to_hash(NibblesView const nibbles)
+        {
+            hash256 hash;
+            for (unsigned i = 0; i < sizeof(hash.bytes); ++i) {
+                hash.bytes[i] = static_cast<uint8_t>(
+                    nibbles.get(2 * i) << 4 | nibbles.get(2 * i + 1));
+            }
+            return hash;
+        }
+
+    public:
+        explicit PopulateMachine(KeyBloomFilter &filter)
+            : filter_(filter)
+        {
+        }
+
+        PopulateMachine(PopulateMachine const &) = default;
+
+        virtual bool down(unsigned char const branch, Node const &node) override
+        {
+            if (branch == INVALID_BRANCH) {
+                MONAD_ASSERT(node.path_nibble_view().nibble_size() == 0);
+                return true;
+            }
+            path_ = concat(NibblesView{path_}, branch, node.path_nibble_view());
+            NibblesView const path{path_};
+            if (path.nibble_size() == KECCAK256_SIZE * 2) {
+                filter_.insert_account(to_hash(path));
+            }
+            else if (path.nibble_size() == KECCAK256_SIZE * 4) {
+                filter_.insert_storage(
+                    to_hash(path.substr(0, KECCAK256_SIZE * 2)),
+                    to_hash(path.substr(KECCAK256_SIZE * 2)));
+            }
+            return true;
+        }
+
+        virtual void up(unsigned char const branch, Node const &node) override
+        {
+            NibblesView const path{path_};
+            auto const rem_size =
+                branch == INVALID_BRANCH
+                    ? 0
+                    : path.nibble_size() - 1 -
+                          node.path_nibble_view().nibble_size();
+            path_ = path.substr(0, static_cast<unsigned>(rem_size));
+        }
+
+        virtual std::unique_ptr<TraverseMachine> clone() const override
+        {
+            return std::make_unique<PopulateMachine>(*this);
+        }
+    };
+}
+
+KeyBloomFilter::KeyBloomFilter(size_t const bytes, uint64_t const base_version)
+    : num_blocks_{std::bit_floor(std::max(
+          bytes / (WORDS_PER_BLOCK * sizeof(uint64_t)), size_t{1}))}
+    , base_version_{base_version}
+{
+    words_ = std::make_unique<std::atomic<uint64_t>[]>(
+        num_blocks_ * WORDS_PER_BLOCK);
+}
+
+void KeyBloomFilter::insert(uint64_t const block, uint64_t bits)
+{
+    auto *const words = &words_[(block & (num_blocks_ - 1)) * WORDS_PER_BLOCK];
+    for (unsigned i = 0; i < WORDS_PER_BLOCK; ++i, bits >>= 6) {
+        uint64_t const mask = uint64_t{1} << (bits & 63);
+        if ((words[i].load(std::memory_order_relaxed) & mask) == 0) {
+            words[i].fetch_or(mask, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool KeyBloomFilter::may_contain(uint64_t const block, uint64_t bits) const
+{
+    auto const *const words =
+        &words_[(block & (num_blocks_ - 1)) * WORDS_PER_BLOCK];
+    for (unsigned i = 0; i < WORDS_PER_BLOCK; ++i, bits >>= 6) {
+        uint64_t const mask = uint64_t{1} << (bits & 63);
+        if ((words[i].load(std::memory_order_relaxed) & mask) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void KeyBloomFilter::insert_account(hash256 const &account)
+{
+    insert(word_of(account, 0), word_of(account, 1));
+}
+
+void KeyBloomFilter::insert_storage(hash256 const &account, hash256 const &slot)
+{
+    insert(
+        word_of(account, 0) ^ std::rotl(word_of(slot, 0), 32),
+        word_of(account, 1) ^ word_of(slot, 1));
+}
+
+bool KeyBloomFilter::may_contain_account(hash256 const &account) const
+{
+    return may_contain(word_of(account, 0), word_of(account, 1));
+}
+
+bool KeyBloomFilter::may_contain_storage(
+    hash256 const &account, hash256 const &slot) const
+{
+    return may_contain(
+        word_of(account, 0) ^ std::rotl(word_of(slot, 0), 32),
+        word_of(account, 1) ^ word_of(slot, 1));
+}
+
+void KeyBloomFilter::insert(
+    StateDeltas const &state_deltas, KeyHashCache &key_hashes)
+{
+    for (auto const &[addr, delta] : state_deltas) {
+        if (!delta.account.second.has_value()) {
+            continue;
+        }
+        auto const account = key_hashes.account(addr);
+        insert_account(account);
+        for (auto const &[key, storage_delta] : delta.storage) {
+            if (storage_delta.second != bytes32_t{}) {
+                insert_storage(account, key_hashes.slot(key));
+            }
+        }
+    }
+}
+
+bool KeyBloomFilter::save(
+    std::filesystem::path const &path, uint64_t const latest_version,
+    bytes32_t const &latest_roots) const
+{
+    FileHeader header{
+        .magic = {},
+        .base_version = base_version_,
+        .latest_version = latest_version,
+        .num_blocks = num_blocks_,
+        .latest_roots = latest_roots};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+
+    // write aside and rename, so a partial write never passes for a filter
+    auto const tmp = std::filesystem::path{path}.concat(".tmp");
+    {
+        std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+        out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+        static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t));
+        out.write(
+            reinterpret_cast<char const *>(words_.get()),
+            static_cast<std::streamsize>(size_bytes()));
+        if (!out.flush()) {
+            LOG_WARNING("Failed to write key bloom filter to {}", tmp);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        LOG_WARNING(
+            "Failed to save key bloom filter to {}: {}", path, ec.message());
+        return false;
+    }
+    LOG_INFO(
+        "Saved key bloom filter of {} MB to {}, covering versions {} to {}",
+        size_bytes() >> 20,
+        path,
+        base_version_,
+        latest_version);
+    return true;
+}
+
+std::unique_ptr<KeyBloomFilter> KeyBloomFilter::load(
+    std::filesystem::path const &path, uint64_t const latest_version,
+    bytes32_t const &latest_roots)
+{
+    std::ifstream in{path, std::ios::binary};
+    if (!in) {
+        return nullptr;
+    }
+    FileHeader header;
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+        !std::has_single_bit(header.num_blocks)) {
+        LOG_WARNING("Ignoring invalid key bloom filter at {}", path);
+        return nullptr;
+    }
+    if (header.latest_version != latest_version) {
+        LOG_WARNING(
+            "Ignoring stale key bloom filter at {}, it covers up to version "
+            "{} but the db is at version {}",
+            path,
+            header.latest_version,
+            latest_version);
+        return nullptr;
+    }
+    if (header.latest_roots != latest_roots) {
+        LOG_WARNING(
+            "Ignoring key bloom filter at {}, it was built on another fork "
+            "of version {}",
+            path,
+            latest_version);
+        return nullptr;
+    }
+    auto filter = std::make_unique<KeyBloomFilter>(
+        header.num_blocks * WORDS_PER_BLOCK * sizeof(uint64_t),
+        header.base_version);
+    MONAD_ASSERT(filter->num_blocks_ == header.num_blocks);
+    if (!in.read(
+            reinterpret_cast<char *>(filter->words_.get()),
+            static_cast<std::streamsize>(filter->size_bytes()))) {
+        LOG_WARNING("Ignoring truncated key bloom filter at {}", path);
+        return nullptr;
+    }
+    return filter;
+}
+
+std::unique_ptr<KeyBloomFilter>
+make_key_bloom_filter(mpt::Db &db, size_t const bytes)
+{
+    MONAD_ASSERT(db.is_on_disk());
+    auto const begin = std::chrono::steady_clock::now();
+    uint64_t const finalized = db.get_latest_finalized_version();
+    uint64_t const latest = db.get_latest_version();
+    auto filter = std::make_unique<KeyBloomFilter>(
+        bytes, finalized == INVALID_BLOCK_NUM ? 0 : finalized);
+    if (latest == INVALID_BLOCK_NUM) {
+        return filter;
+    }
+
+    PopulateMachine machine{*filter};
+    auto const populate = [&](Node::SharedPtr const &root,
+                              Nibbles const &prefix,
+                              uint64_t const version) {
+        auto const cursor =
+            db.find(root, concat(prefix, STATE_NIBBLE), version);
+        if (cursor.has_value() && cursor.value().is_valid()) {
+            MONAD_ASSERT(
+                db.traverse_blocking(cursor.value(), machine, version));
+        }
+    };
+    for (uint64_t v = filter->base_version(); v <= latest; ++v) {
+        auto const root = db.load_root_for_version(v);
+        if (root == nullptr) {
+            continue;
+        }
+        populate(root, finalized_nibbles, v);
+        for (bytes32_t const &block_id : get_proposal_block_ids(db, v)) {
+            populate(root, proposal_prefix(block_id), v);
+        }
+    }
+    LOG_INFO(
+        "Populated key bloom filter of {} MB from versions {} to {} in {}",
+        filter->size_bytes() >> 20,
+        filter->base_version(),
+        latest,
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - begin));
+    return filter;
+}
+
+bytes32_t state_roots_digest(mpt::Db &db, uint64_t const version)
+{
+    auto const root = db.load_root_for_version(version);
+    if (root == nullptr) {
+        return NULL_HASH;
+    }
+    byte_string roots;
+    auto const append_root = [&](Nibbles const &prefix) {
+        auto const cursor =
+            db.find(root, concat(prefix, STATE_NIBBLE), version);
+        if (cursor.has_value() && cursor.value().is_valid() &&
+            cursor.value().node->data().size() == sizeof(bytes32_t)) {
+            roots += cursor.value().node->data();
+        }
+        else {
+            roots += byte_string_view{NULL_ROOT.bytes, sizeof(bytes32_t)};
+        }
+    };
+    append_root(finalized_nibbles);
+    for (bytes32_t const &block_id : get_proposal_block_ids(db, version)) {
+        roots += byte_string_view{block_id.bytes, sizeof(bytes32_t)};
+        append_root(proposal_prefix(block_id));
+    }
+    return to_bytes(keccak256(roots));
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,130 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/core/keccak.hpp>
+#include <category/execution/ethereum/db/key_hash_cache.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <utility>
+
+MONAD_NAMESPACE_BEGIN
+
+namespace mpt
+{
+    class Db;
+}
+
+// Blocked bloom filter over the trie keys of every account and storage slot
+// that has held a value, so reads of keys that never existed are answered
+// without walking the trie. Each key sets one bit in each word of a single
+// cache line. Keys are never removed, deleted keys only cost false positives.
+//
+// The filter only answers for state at `base_version()` and later: older
+// versions may hold keys deleted before the filter was populated. Every
+// write to the state from then on must be inserted, which `TrieDb::commit`
+// does for an attached filter. Inserts and lookups are safe to run
+// concurrently.
+class KeyBloomFilter
+{
+    static constexpr unsigned WORDS_PER_BLOCK = 8;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> words_;
+    size_t num_blocks_;
+    uint64_t base_version_;
+
+    std::atomic<uint64_t> n_negative_{0};
+    std::atomic<uint64_t> n_false_positive_{0};
+
+    void insert(uint64_t block, uint64_t bits);
+    bool may_contain(uint64_t block, uint64_t bits) const;
+
+public:
+    // `bytes` is rounded down to a power of two number of cache lines
+    KeyBloomFilter(size_t bytes, uint64_t base_version);
+
+    uint64_t base_version() const noexcept
+    {
+        return base_version_;
+    }
+
+    size_t size_bytes() const noexcept
+    {
+        return num_blocks_ * WORDS_PER_BLOCK * sizeof(uint64_t);
+    }
+
+    void insert_account(hash256 const &account);
+    void insert_storage(hash256 const &account, hash256 const &slot);
+
+    // Inserts the accounts and storage slots the deltas leave with a value
+    void insert(StateDeltas const &, KeyHashCache &);
+
+    bool may_contain_account(hash256 const &account) const;
+    bool
+    may_contain_storage(hash256 const &account, hash256 const &slot) const;
+
+    // A lookup the filter answered, and a lookup it let through for a key
+    // the trie did not have
+    void record_negative()
+    {
+        n_negative_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void record_false_positive()
+    {
+        n_false_positive_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Number of lookups answered by the filter, and the number of false
+    // positives, since the last call
+    std::pair<uint64_t, uint64_t> take_stats()
+    {
+        return {
+            n_negative_.exchange(0, std::memory_order_relaxed),
+            n_false_positive_.exchange(0, std::memory_order_relaxed)};
+    }
+
+    // Persist the filter as covering the state up to `latest_version`, whose
+    // state roots digest to `latest_roots`
+    bool save(
+        std::filesystem::path const &, uint64_t latest_version,
+        bytes32_t const &latest_roots) const;
+
+    // Returns null if there is no saved filter, or it does not cover the state
+    // up to exactly `latest_version` on the fork digested by `latest_roots`.
+    // A filter saved on another fork would miss the keys only it inserted.
+    static std::unique_ptr<KeyBloomFilter> load(
+        std::filesystem::path const &, uint64_t latest_version,
+        bytes32_t const &latest_roots);
+};
+
+// Digest of the state roots at `version` of the finalized state and of every
+// proposal, which tells apart forks executed up to the same version
+bytes32_t state_roots_digest(mpt::Db &, uint64_t version);
+
+// Insert the keys of every state in the on disk `db` from the latest
+// finalized version on, finalized and proposed, into a new filter
+std::unique_ptr<KeyBloomFilter>
+make_key_bloom_filter(mpt::Db &, size_t bytes);
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,105 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/bytes.hpp>
+#include <category/core/bytes_hash_compare.hpp>
+#include <category/core/config.hpp>
+#include <category/core/keccak.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#include <oneapi/tbb/concurrent_hash_map.h>
+#pragma GCC diagnostic pop
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+MONAD_NAMESPACE_BEGIN
+
+// Trie keys of the accounts and storage slots touched by the current block.
+// The read path hashes each key once, and the commit of the block reuses
+// the hashes rather than computing them again. Each map stops taking new
+// keys at its capacity, which bounds the cache of a db that is only read
+// and never commits. Safe to use concurrently, except for clear().
+class KeyHashCache
+{
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 18;
+
+private:
+    template <class Key>
+    using Map =
+        oneapi::tbb::concurrent_hash_map<Key, hash256, BytesHashCompare<Key>>;
+
+    size_t const capacity_;
+    Map<Address> accounts_;
+    Map<bytes32_t> slots_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+
+    template <class Key>
+    hash256 get(Map<Key> &map, Key const &key)
+    {
+        if (typename Map<Key>::const_accessor acc; map.find(acc, key)) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return acc->second;
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        hash256 const hash = keccak256({key.bytes, sizeof(key.bytes)});
+        // Concurrent misses may overshoot the capacity by a few keys
+        if (map.size() < capacity_) {
+            map.emplace(key, hash);
+        }
+        return hash;
+    }
+
+public:
+    explicit KeyHashCache(size_t const capacity = DEFAULT_CAPACITY)
+        : capacity_{capacity}
+    {
+    }
+
+    hash256 account(Address const &address)
+    {
+        return get(accounts_, address);
+    }
+
+    hash256 slot(bytes32_t const &key)
+    {
+        return get(slots_, key);
+    }
+
+    // Number of lookups served from the cache, and the number that had to
+    // hash, since the last call
+    std::pair<uint64_t, uint64_t> take_stats()
+    {
+        return {
+            hits_.exchange(0, std::memory_order_relaxed),
+            misses_.exchange(0, std::memory_order_relaxed)};
+    }
+
+    void clear()
+    {
+        accounts_.clear();
+        slots_.clear();
+    }
+};
+
+MONAD_NAMESPACE_END
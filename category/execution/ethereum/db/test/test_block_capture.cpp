@@ -0,0 +1,260 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/fiber/priority_pool.hpp>
+#include <category/core/keccak.hpp>
+#include <category/execution/ethereum/block_hash_buffer.hpp>
+#include <category/execution/ethereum/chain/ethereum_mainnet.hpp>
+#include <category/execution/ethereum/core/account.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/core/rlp/block_rlp.hpp>
+#include <category/execution/ethereum/db/block_capture.hpp>
+#include <category/execution/ethereum/db/db.hpp>
+#include <category/execution/ethereum/db/trie_db.hpp>
+#include <category/execution/ethereum/db/util.hpp>
+#include <category/execution/ethereum/execute_block.hpp>
+#include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/execution/ethereum/trace/call_tracer.hpp>
+#include <category/execution/ethereum/trace/state_tracer.hpp>
+#include <category/mpt/db.hpp>
+#include <category/vm/evm/traits.hpp>
+#include <category/vm/vm.hpp>
+
+#include <gtest/gtest.h>
+
+#include <test_resource_data.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <variant>
+#include <vector>
+
+using namespace monad;
+using namespace monad::test;
+
+namespace
+{
+    using monad::literals::operator""_bytes;
+
+    constexpr auto key1 =
+        0x00000000000000000000000000000000000000000000000000000000cafebabe_bytes32;
+    constexpr auto key2 =
+        0x1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c_bytes32;
+    constexpr auto value1 =
+        0x0000000000000013370000000000000000000000000000000000000000000003_bytes32;
+    constexpr auto value2 =
+        0x0000000000000000000000000000000000000000000000000000000000000007_bytes32;
+
+    // Stores the hash of block 0 in slot 0 and clears slots 1 to 5
+    auto const BLOCKHASH_CODE =
+        0x6000406000556000600155600060025560006003556000600455600060055500_bytes;
+    auto const BLOCKHASH_CODE_HASH = to_bytes(keccak256(BLOCKHASH_CODE));
+    auto const BLOCKHASH_ICODE = vm::make_shared_intercode(BLOCKHASH_CODE);
+
+    // Executes `block` against `db` and commits the changes to it
+    void execute_and_commit(
+        Block const &block, Db &db, BlockHashBuffer const &block_hash_buffer)
+    {
+        vm::VM vm;
+        fiber::PriorityPool pool{1, 1};
+
+        auto const recovered_senders =
+            recover_senders(block.transactions, pool);
+        std::vector<Address> senders(block.transactions.size());
+        for (unsigned i = 0; i < recovered_senders.size(); ++i) {
+            ASSERT_TRUE(recovered_senders[i].has_value());
+            senders[i] = recovered_senders[i].value();
+        }
+        auto const recovered_authorities =
+            recover_authorities(block.transactions, pool);
+        std::vector<std::unique_ptr<CallTracerBase>> call_tracers;
+        std::vector<std::unique_ptr<trace::StateTracer>> state_tracers;
+        for (size_t i = 0; i < block.transactions.size(); ++i) {
+            call_tracers.emplace_back(std::make_unique<NoopCallTracer>());
+            state_tracers.emplace_back(
+                std::make_unique<trace::StateTracer>(std::monostate{}));
+        }
+
+        BlockState block_state{db, vm};
+        BlockMetrics metrics;
+        auto const receipts = execute_block<EvmTraits<EVMC_PRAGUE>>(
+            EthereumMainnet{},
+            block,
+            senders,
+            recovered_authorities,
+            block_state,
+            block_hash_buffer,
+            pool.fiber_group(),
+            metrics,
+            call_tracers,
+            state_tracers);
+        ASSERT_FALSE(receipts.has_error());
+        block_state.commit(
+            bytes32_t{block.header.number},
+            block.header,
+            receipts.value(),
+            {},
+            senders,
+            block.transactions,
+            block.ommers,
+            block.withdrawals);
+    }
+}
+
+TEST(BlockCapture, replay_serves_captured_reads)
+{
+    InMemoryMachine machine;
+    mpt::Db db{machine};
+    TrieDb tdb{db};
+    commit_sequential(
+        tdb,
+        StateDeltas{
+            {ADDR_A,
+             StateDelta{
+                 .account = {std::nullopt, Account{.balance = 1, .nonce = 1}},
+                 .storage = {{key1, {bytes32_t{}, value1}}}}}},
+        Code{},
+        BlockHeader{.number = 0});
+
+    CaptureDb capture_db{tdb};
+    auto const account = capture_db.read_account(ADDR_A);
+    ASSERT_TRUE(account.has_value());
+    EXPECT_EQ(capture_db.read_storage(ADDR_A, Incarnation{0, 0}, key1), value1);
+    EXPECT_FALSE(capture_db.read_account(ADDR_B).has_value());
+
+    // The untouched slot and account are left out of the changes
+    StateDeltas const deltas{
+        {ADDR_A,
+         StateDelta{
+             .account = {account, Account{.balance = 2, .nonce = 2}},
+             .storage =
+                 {{key1, {value1, value2}},
+                  {key2, {bytes32_t{}, bytes32_t{}}}}}},
+        {ADDR_B, StateDelta{.account = {std::nullopt, std::nullopt}}}};
+    commit_sequential(capture_db, deltas, Code{}, BlockHeader{.number = 1});
+
+    BlockCapture expected = capture_db.take();
+    EXPECT_EQ(expected.block.header.number, 1);
+    EXPECT_EQ(expected.accounts.size(), 2);
+    EXPECT_EQ(expected.storage.size(), 1);
+    EXPECT_EQ(expected.state_changes, encode_state_changes(deltas, {}));
+
+    byte_string const enc = encode_block_capture(expected);
+    byte_string_view view{enc};
+    auto const decoded = decode_block_capture(view);
+    ASSERT_FALSE(decoded.has_error());
+    EXPECT_TRUE(view.empty());
+    BlockCapture const &capture = decoded.value();
+    EXPECT_EQ(capture.state_changes, expected.state_changes);
+
+    ReplayDb replay_db{capture};
+    EXPECT_EQ(replay_db.read_account(ADDR_A), account);
+    EXPECT_EQ(replay_db.read_storage(ADDR_A, Incarnation{0, 0}, key1), value1);
+    EXPECT_FALSE(replay_db.read_account(ADDR_B).has_value());
+    EXPECT_EQ(replay_db.get_block_number(), 0);
+    replay_db.commit(deltas, Code{}, bytes32_t{1}, capture.block.header);
+    EXPECT_EQ(replay_db.state_changes(), capture.state_changes);
+}
+
+// Based on `TraitsTest.call_frames_refund`, with the callee reading a block
+// hash
+TEST(BlockCapture, replay_executes_captured_block)
+{
+    static constexpr auto from{
+        0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b_address};
+    static constexpr auto to{
+        0x2adc25665018aa1fe0e6bc666dac8fc2697ff9ba_address};
+    static constexpr auto ca{
+        0x095e7baea6a6c7c4c2dfeb977efac326af552d87_address};
+
+    InMemoryMachine machine;
+    mpt::Db db{machine};
+    TrieDb tdb{db};
+    commit_sequential(
+        tdb,
+        StateDeltas{
+            {from,
+             StateDelta{
+                 .account =
+                     {std::nullopt,
+                      Account{.balance = 0x989680, .code_hash = NULL_HASH}}}},
+            {to,
+             StateDelta{
+                 .account =
+                     {std::nullopt,
+                      Account{.code_hash = NULL_HASH, .nonce = 0x01}}}},
+            {ca,
+             StateDelta{
+                 .account =
+                     {std::nullopt,
+                      Account{
+                          .balance = 0x1b58,
+                          .code_hash = BLOCKHASH_CODE_HASH}},
+                 .storage =
+                     {{bytes32_t{0x01}, {bytes32_t{}, bytes32_t{0x01}}},
+                      {bytes32_t{0x02}, {bytes32_t{}, bytes32_t{0x01}}},
+                      {bytes32_t{0x03}, {bytes32_t{}, bytes32_t{0x01}}},
+                      {bytes32_t{0x04}, {bytes32_t{}, bytes32_t{0x01}}},
+                      {bytes32_t{0x05}, {bytes32_t{}, bytes32_t{0x01}}}}}}},
+        Code{{BLOCKHASH_CODE_HASH, BLOCKHASH_ICODE}},
+        BlockHeader{.number = 0});
+
+    byte_string const block_rlp =
+        0xf9025ff901f7a01e736f5755fc7023588f262b496b6cbc18aa9062d9c7a21b1c709f55ad66aad3a01dcc4de8dec75d7aab85b567b6ccd41ad312451b948a7413f0a142fd40d49347942adc25665018aa1fe0e6bc666dac8fc2697ff9baa096841c0823ec823fdb0b0b8ea019c8dd6691b9f335e0433d8cfe59146e8b884ca0f0f9b1e10ec75d9799e3a49da5baeeab089b431b0073fb05fa90035e830728b8a06c8ab36ec0629c97734e8ac823cdd8397de67efb76c7beb983be73dcd3c78141b90100000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000008302000001830f42408259e78203e800a00000000000000000000000000000000000000000000000000000000000000000880000000000000000f862f860800a830186a094095e7baea6a6c7c4c2dfeb977efac326af552d8780801ba0eac92a424c1599d71b1c116ad53800caa599233ea91907e639b7cb98fa0da3bba06be40f001771af85bfba5e6c4d579e038e6465af3f55e71b9490ab48fcfa5b1ec0_bytes;
+    byte_string_view block_rlp_view{block_rlp};
+    auto const block = rlp::decode_block(block_rlp_view);
+    ASSERT_FALSE(block.has_error());
+    bytes32_t const &parent_hash = block.value().header.parent_hash;
+
+    BlockHashBufferFinalized block_hash_buffer;
+    block_hash_buffer.set(0, parent_hash);
+
+    CaptureDb capture_db{tdb};
+    CaptureBlockHashBuffer capture_block_hash_buffer{block_hash_buffer};
+    execute_and_commit(block.value(), capture_db, capture_block_hash_buffer);
+    tdb.finalize(1, bytes32_t{1});
+    tdb.set_block_and_prefix(1);
+    EXPECT_EQ(
+        tdb.read_storage(ca, Incarnation{0, 0}, bytes32_t{}), parent_hash);
+
+    BlockCapture expected = capture_db.take();
+    expected.block_hashes = capture_block_hash_buffer.take();
+    ASSERT_EQ(expected.block_hashes.size(), 1);
+    EXPECT_EQ(expected.block_hashes[0].first, 0);
+    EXPECT_EQ(expected.block_hashes[0].second, parent_hash);
+    ASSERT_EQ(expected.code.size(), 1);
+    EXPECT_EQ(expected.code[0].second, BLOCKHASH_CODE);
+    EXPECT_FALSE(expected.state_changes.empty());
+
+    byte_string const enc = encode_block_capture(expected);
+    byte_string_view view{enc};
+    auto const decoded = decode_block_capture(view);
+    ASSERT_FALSE(decoded.has_error());
+    EXPECT_TRUE(view.empty());
+    BlockCapture const &capture = decoded.value();
+
+    // The block executes again from the capture alone and makes the same
+    // changes
+    ReplayDb replay_db{capture};
+    ReplayBlockHashBuffer const replay_block_hash_buffer{capture};
+    execute_and_commit(capture.block, replay_db, replay_block_hash_buffer);
+    EXPECT_EQ(replay_db.state_changes(), capture.state_changes);
+}
@@ -720,6 +720,35 @@ TEST_F(OnDiskTrieDbWithFileFixture, get_transactions)
     }
 }
 
+TEST_F(OnDiskTrieDbWithFileFixture, proposal_written_by_header_upsert)
+{
+    TrieDb tdb{this->db};
+    commit_sequential(tdb, StateDeltas{}, Code{}, BlockHeader{.number = 0});
+    tdb.set_block_and_prefix(0);
+
+    // the nodes above the tables of a proposal are only written when the
+    // header is inserted, so read them back through a fresh read-only Db
+    Account const acct{.nonce = 1};
+    bytes32_t const block_id{1};
+    tdb.commit(
+        StateDeltas{{ADDR_A, StateDelta{.account = {std::nullopt, acct}}}},
+        Code{},
+        block_id,
+        BlockHeader{.number = 1});
+    auto const header = tdb.read_eth_header();
+    EXPECT_EQ(header.number, 1);
+    EXPECT_EQ(header.state_root, tdb.state_root());
+
+    mpt::AsyncIOContext io_ctx{
+        mpt::ReadOnlyOnDiskDbConfig{.dbname_paths = {this->dbname}}};
+    mpt::Db ro_db{io_ctx};
+    TrieDb ro{ro_db};
+    ro.set_block_and_prefix(1, block_id);
+    EXPECT_EQ(ro.read_account(ADDR_A), acct);
+    EXPECT_EQ(ro.read_eth_header(), header);
+    EXPECT_EQ(ro.state_root(), header.state_root);
+}
+
 TYPED_TEST(DBTest, to_json)
 {
     // TODO: typed test doesn't really make sense here, split to two different
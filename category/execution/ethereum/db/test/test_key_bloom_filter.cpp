@@ -0,0 +1,153 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/bytes.hpp>
+#include <category/core/keccak.hpp>
+#include <category/execution/ethereum/core/account.hpp>
+#include <category/execution/ethereum/db/key_bloom_filter.hpp>
+#include <category/execution/ethereum/db/trie_db.hpp>
+#include <category/execution/ethereum/db/util.hpp>
+#include <category/execution/ethereum/state2/state_deltas.hpp>
+#include <category/mpt/db.hpp>
+#include <category/mpt/ondisk_db_config.hpp>
+
+#include <gtest/gtest.h>
+
+#include <test_resource_data.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <utility>
+
+using namespace monad;
+using namespace monad::test;
+
+namespace
+{
+    constexpr auto key1 =
+        0x00000000000000000000000000000000000000000000000000000000cafebabe_bytes32;
+    constexpr auto key2 =
+        0x1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c1c_bytes32;
+    constexpr auto value1 =
+        0x0000000000000013370000000000000000000000000000000000000000000003_bytes32;
+
+    hash256 hashed_key(uint64_t const n)
+    {
+        return keccak256({reinterpret_cast<unsigned char const *>(&n), 8});
+    }
+}
+
+TEST(KeyBloomFilter, no_false_negatives)
+{
+    constexpr uint64_t n = 10'000;
+    KeyBloomFilter filter{1 << 20, 0};
+    for (uint64_t i = 0; i < n; ++i) {
+        filter.insert_account(hashed_key(i));
+        filter.insert_storage(hashed_key(i), hashed_key(i + n));
+    }
+    for (uint64_t i = 0; i < n; ++i) {
+        EXPECT_TRUE(filter.may_contain_account(hashed_key(i)));
+        EXPECT_TRUE(
+            filter.may_contain_storage(hashed_key(i), hashed_key(i + n)));
+    }
+
+    uint64_t false_positives = 0;
+    for (uint64_t i = 2 * n; i < 12 * n; ++i) {
+        false_positives += filter.may_contain_account(hashed_key(i));
+        false_positives +=
+            filter.may_contain_storage(hashed_key(i - 2 * n), hashed_key(i));
+    }
+    EXPECT_LT(false_positives, 2 * 10 * n / 1000);
+}
+
+TEST(KeyBloomFilter, save_and_load)
+{
+    auto const path = std::filesystem::temp_directory_path() /
+                      "monad_key_bloom_filter_test";
+    KeyBloomFilter filter{1 << 16, 3};
+    filter.insert_account(hashed_key(1));
+    ASSERT_TRUE(filter.save(path, 7, key1));
+
+    EXPECT_EQ(KeyBloomFilter::load(path, 8, key1), nullptr);
+    // another fork executed up to the same version
+    EXPECT_EQ(KeyBloomFilter::load(path, 7, key2), nullptr);
+    auto const loaded = KeyBloomFilter::load(path, 7, key1);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->base_version(), 3);
+    EXPECT_EQ(loaded->size_bytes(), filter.size_bytes());
+    EXPECT_TRUE(loaded->may_contain_account(hashed_key(1)));
+    EXPECT_FALSE(loaded->may_contain_account(hashed_key(2)));
+    std::filesystem::remove(path);
+}
+
+TEST(KeyBloomFilter, trie_db_skips_absent_keys)
+{
+    OnDiskMachine machine;
+    mpt::Db db{machine, mpt::OnDiskDbConfig{}};
+    TrieDb tdb{db};
+    commit_sequential(
+        tdb,
+        StateDeltas{
+            {ADDR_A,
+             StateDelta{
+                 .account = {std::nullopt, Account{.nonce = 1}},
+                 .storage = {{key1, {bytes32_t{}, value1}}}}}},
+        Code{},
+        BlockHeader{.number = 0});
+
+    auto const filter = make_key_bloom_filter(db, 1 << 16);
+    tdb.set_key_filter(filter.get());
+    EXPECT_TRUE(filter->may_contain_account(
+        keccak256({ADDR_A.bytes, sizeof(ADDR_A.bytes)})));
+
+    EXPECT_TRUE(tdb.read_account(ADDR_A).has_value());
+    EXPECT_EQ(tdb.read_storage(ADDR_A, Incarnation{0, 0}, key1), value1);
+    EXPECT_FALSE(tdb.read_account(ADDR_B).has_value());
+    EXPECT_EQ(tdb.read_storage(ADDR_A, Incarnation{0, 0}, key2), bytes32_t{});
+    EXPECT_EQ(filter->take_stats(), std::make_pair(uint64_t{2}, uint64_t{0}));
+
+    // keys written after the filter is populated are inserted by the commit
+    commit_sequential(
+        tdb,
+        StateDeltas{
+            {ADDR_B,
+             StateDelta{
+                 .account = {std::nullopt, Account{.nonce = 1}},
+                 .storage = {{key2, {bytes32_t{}, value1}}}}}},
+        Code{},
+        BlockHeader{.number = 1});
+    EXPECT_TRUE(tdb.read_account(ADDR_B).has_value());
+    EXPECT_EQ(tdb.read_storage(ADDR_B, Incarnation{0, 0}, key2), value1);
+    EXPECT_EQ(filter->take_stats(), std::make_pair(uint64_t{0}, uint64_t{0}));
+}
+
+TEST(KeyBloomFilter, state_roots_digest_tells_forks_apart)
+{
+    auto const digest_of = [](StateDeltas const &deltas) {
+        OnDiskMachine machine;
+        mpt::Db db{machine, mpt::OnDiskDbConfig{}};
+        TrieDb tdb{db};
+        commit_sequential(tdb, deltas, Code{}, BlockHeader{.number = 0});
+        return state_roots_digest(db, 0);
+    };
+    auto const fork = [](Address const &address) {
+        return StateDeltas{
+            {address,
+             StateDelta{.account = {std::nullopt, Account{.nonce = 1}}}}};
+    };
+    EXPECT_EQ(digest_of(fork(ADDR_A)), digest_of(fork(ADDR_A)));
+    EXPECT_NE(digest_of(fork(ADDR_A)), digest_of(fork(ADDR_B)));
+}
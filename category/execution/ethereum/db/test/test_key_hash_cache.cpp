@@ -0,0 +1,67 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/bytes.hpp>
+#include <category/core/keccak.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/db/key_hash_cache.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <utility>
+
+using namespace monad;
+
+TEST(KeyHashCache, hashes_each_key_once)
+{
+    constexpr auto addr = 0x5353535353535353535353535353535353535353_address;
+    constexpr auto slot =
+        0x00000000000000000000000000000000000000000000000000000000cafebabe_bytes32;
+
+    KeyHashCache cache;
+    auto const expected_account =
+        to_bytes(keccak256({addr.bytes, sizeof(addr.bytes)}));
+    auto const expected_slot =
+        to_bytes(keccak256({slot.bytes, sizeof(slot.bytes)}));
+
+    EXPECT_EQ(to_bytes(cache.account(addr)), expected_account);
+    EXPECT_EQ(to_bytes(cache.account(addr)), expected_account);
+    EXPECT_EQ(to_bytes(cache.slot(slot)), expected_slot);
+    EXPECT_EQ(to_bytes(cache.slot(slot)), expected_slot);
+    EXPECT_EQ(cache.take_stats(), std::make_pair(uint64_t{2}, uint64_t{2}));
+
+    cache.clear();
+    EXPECT_EQ(to_bytes(cache.account(addr)), expected_account);
+    EXPECT_EQ(cache.take_stats(), std::make_pair(uint64_t{0}, uint64_t{1}));
+}
+
+TEST(KeyHashCache, stops_caching_at_capacity)
+{
+    constexpr auto addr1 = 0x5353535353535353535353535353535353535353_address;
+    constexpr auto addr2 = 0x6363636363636363636363636363636363636363_address;
+
+    KeyHashCache cache{1};
+    auto const expected =
+        to_bytes(keccak256({addr2.bytes, sizeof(addr2.bytes)}));
+
+    cache.account(addr1);
+    EXPECT_EQ(to_bytes(cache.account(addr2)), expected);
+    EXPECT_EQ(to_bytes(cache.account(addr2)), expected);
+    cache.account(addr1);
+    EXPECT_EQ(cache.take_stats(), std::make_pair(uint64_t{1}, uint64_t{3}));
+}
@@ -57,6 +57,8 @@
 #include <quill/bundled/fmt/core.h>
 #include <quill/bundled/fmt/format.h>
 
+#include <tbb/task_group.h>
+
 #include <algorithm>
 #include <atomic>
 #include <cstdint>
@@ -99,14 +101,22 @@ Node::SharedPtr const &TrieDb::get_root() const
 
 std::optional<Account> TrieDb::read_account(Address const &addr)
 {
+    auto const account = key_hashes_.account(addr);
+    bool const filtered =
+        key_filter_ && block_number_ >= key_filter_->base_version();
+    if (filtered && !key_filter_->may_contain_account(account)) {
+        key_filter_->record_negative();
+        stats_account_no_value();
+        return std::nullopt;
+    }
     auto const res = db_.find(
         curr_root_,
-        concat(
-            prefix_,
-            STATE_NIBBLE,
-            NibblesView{keccak256({addr.bytes, sizeof(addr.bytes)})}),
+        concat(prefix_, STATE_NIBBLE, NibblesView{account}),
         block_number_);
     if (res.has_error()) {
+        if (filtered) {
+            key_filter_->record_false_positive();
+        }
         stats_account_no_value();
         return std::nullopt;
     }
@@ -121,15 +131,24 @@ std::optional<Account> TrieDb::read_account(Address const &addr)
 bytes32_t
 TrieDb::read_storage(Address const &addr, Incarnation, bytes32_t const &key)
 {
+    auto const account = key_hashes_.account(addr);
+    auto const slot = key_hashes_.slot(key);
+    bool const filtered =
+        key_filter_ && block_number_ >= key_filter_->base_version();
+    if (filtered && !key_filter_->may_contain_storage(account, slot)) {
+        key_filter_->record_negative();
+        stats_storage_no_value();
+        return {};
+    }
     auto const res = db_.find(
         curr_root_,
         concat(
-            prefix_,
-            STATE_NIBBLE,
-            NibblesView{keccak256({addr.bytes, sizeof(addr.bytes)})},
-            NibblesView{keccak256({key.bytes, sizeof(key.bytes)})}),
+            prefix_, STATE_NIBBLE, NibblesView{account}, NibblesView{slot}),
         block_number_);
     if (res.has_error()) {
+        if (filtered) {
+            key_filter_->record_false_positive();
+        }
         stats_storage_no_value();
         return {};
     }
@@ -173,33 +192,42 @@ void TrieDb::commit(
         auto const dest_prefix = proposal_prefix(block_id);
         if (db_.get_latest_version() != INVALID_BLOCK_NUM) {
             MONAD_ASSERT(header.number != block_number_);
+            // shares the parent's subtries, the path to the new prefix is
+            // written by the upserts below
             curr_root_ = db_.copy_trie(
                 curr_root_,
                 prefix_,
                 db_.load_root_for_version(header.number),
                 dest_prefix,
                 header.number,
-                false);
+                false,
+                true);
         }
         proposal_block_id_ = block_id;
         prefix_ = dest_prefix;
     }
     block_number_ = header.number;
 
-    CommitBuilder builder(block_number_);
-    builder.add_state_deltas(state_deltas)
-        .add_code(code)
-        .add_receipts(receipts)
-        .add_transactions(transactions, senders)
-        .add_call_frames(call_frames)
-        .add_ommers(ommers);
+    CommitBuilder builder(block_number_, key_hashes_);
+    tbb::task_group encoders;
+    encoders.run([&] { builder.add_state_deltas(state_deltas); });
+    encoders.run([&] { builder.add_receipts(receipts); });
+    encoders.run([&] { builder.add_transactions(transactions, senders); });
+    encoders.run([&] { builder.add_call_frames(call_frames); });
+    if (key_filter_) {
+        encoders.run([&] { key_filter_->insert(state_deltas, key_hashes_); });
+    }
+    builder.add_code(code).add_ommers(ommers);
     if (withdrawals.has_value()) {
         builder.add_withdrawals(withdrawals.value());
     }
+    encoders.wait();
 
+    // The root and the nodes above the tables stay in memory unwritten, the
+    // header upsert below recreates and writes them once
     curr_root_ = db_.upsert(
         std::move(curr_root_),
-        builder.build(prefix_),
+        builder.build(prefix_, true),
         block_number_,
         true,
         true,
@@ -230,6 +258,9 @@ void TrieDb::commit(
         builder.build(prefix_),
         block_number_,
         enable_compaction);
+
+    // the next block touches a different set of keys
+    key_hashes_.clear();
 }
 
 void TrieDb::set_block_and_prefix(
@@ -364,12 +395,25 @@ BlockHeader TrieDb::read_eth_header()
 std::string TrieDb::print_stats()
 {
     std::string ret;
+    auto const [key_hash_hits, key_hash_misses] = key_hashes_.take_stats();
     ret += std::format(
-        ",ae={:4},ane={:4},sz={:4},snz={:4}",
+        ",ae={:4},ane={:4},sz={:4},snz={:4},khh={:4},khm={:4}",
         n_account_no_value_.load(std::memory_order_acquire),
         n_account_value_.load(std::memory_order_acquire),
         n_storage_no_value_.load(std::memory_order_acquire),
-        n_storage_value_.load(std::memory_order_acquire));
+        n_storage_value_.load(std::memory_order_acquire),
+        key_hash_hits,
+        key_hash_misses);
+    if (key_filter_) {
+        auto const [negatives, false_positives] = key_filter_->take_stats();
+        ret += std::format(
+            ",kfn={:4},kffp={:.4f}",
+            negatives,
+            negatives + false_positives == 0
+                ? 0.0
+                : static_cast<double>(false_positives) /
+                      static_cast<double>(negatives + false_positives));
+    }
     n_account_no_value_.store(0, std::memory_order_release);
     n_account_value_.store(0, std::memory_order_release);
     n_storage_no_value_.store(0, std::memory_order_release);
@@ -377,6 +421,14 @@ std::string TrieDb::print_stats()
     return ret;
 }
 
+Db::Stats TrieDb::stats()
+{
+    return Stats{
+        .trie_bytes_written = db_.get_total_bytes_written(),
+        .trie_bytes_compacted = db_.get_total_bytes_compacted(),
+        .trie_history_erase_rate = db_.get_history_erase_rate()};
+}
+
 nlohmann::json TrieDb::to_json(size_t const concurrency_limit)
 {
     struct Traverse : public TraverseMachine
@@ -524,4 +576,9 @@ uint64_t TrieDb::get_history_length() const
     return db_.get_history_length();
 }
 
+void TrieDb::set_key_filter(KeyBloomFilter *const key_filter)
+{
+    key_filter_ = key_filter;
+}
+
 MONAD_NAMESPACE_END
@@ -23,6 +23,8 @@
 #include <category/execution/ethereum/core/transaction.hpp>
 #include <category/execution/ethereum/db/commit_builder.hpp>
 #include <category/execution/ethereum/db/db.hpp>
+#include <category/execution/ethereum/db/key_bloom_filter.hpp>
+#include <category/execution/ethereum/db/key_hash_cache.hpp>
 #include <category/execution/ethereum/db/util.hpp>
 #include <category/execution/ethereum/trace/call_frame.hpp>
 #include <category/mpt/compute.hpp>
@@ -50,6 +52,8 @@ class TrieDb final : public ::monad::Db
     bytes32_t proposal_block_id_;
     ::monad::mpt::Nibbles prefix_;
     ::monad::mpt::Node::SharedPtr curr_root_;
+    KeyHashCache key_hashes_;
+    KeyBloomFilter *key_filter_{nullptr};
 
 public:
     explicit TrieDb(mpt::Db &);
@@ -89,11 +93,16 @@ public:
     virtual bytes32_t transactions_root() override;
     virtual std::optional<bytes32_t> withdrawals_root() override;
     virtual std::string print_stats() override;
+    virtual Stats stats() override;
     virtual uint64_t get_block_number() const override;
 
     nlohmann::json to_json(size_t concurrency_limit = 4096);
     uint64_t get_history_length() const;
 
+    // Reads at or after the base version of the filter skip the trie for
+    // keys it rules out, and commits insert the keys they write into it
+    void set_key_filter(KeyBloomFilter *);
+
 private:
     /// STATS
     std::atomic<uint64_t> n_account_no_value_{0};
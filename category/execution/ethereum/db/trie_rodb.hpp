@@ -69,6 +69,21 @@ public:
         block_number_ = block_number;
     }
 
+    // Reuses a prefix cursor resolved by `set_block_and_prefix` on another
+    // instance for the same block, avoiding the lookup of the block prefix.
+    void set_block_and_prefix_cursor(
+        uint64_t const block_number, mpt::NodeCursor const &prefix_cursor)
+    {
+        MONAD_ASSERT(prefix_cursor.is_valid());
+        prefix_cursor_ = prefix_cursor;
+        block_number_ = block_number;
+    }
+
+    mpt::NodeCursor const &prefix_cursor() const
+    {
+        return prefix_cursor_;
+    }
+
     virtual std::optional<Account> read_account(Address const &addr) override
     {
         auto acc_leaf_res = db_.find(
@@ -49,17 +49,22 @@
 #include <category/vm/evm/switch_traits.hpp>
 #include <category/vm/evm/traits.hpp>
 
+#include <boost/fiber/condition_variable.hpp>
 #include <boost/fiber/future/promise.hpp>
+#include <boost/fiber/mutex.hpp>
 #include <boost/outcome/try.hpp>
 #include <evmc/evmc.h>
 #include <intx/intx.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -107,75 +112,196 @@ void set_beacon_root(State &state, BlockHeader const &header)
     }
 }
 
-MONAD_ANONYMOUS_NAMESPACE_END
+// Hands the outputs of the transactions of a block to the sink in
+// transaction order, as each transaction finishes
+struct OrderedOutputs
+{
+    TransactionOutputSink &sink;
+    uint64_t cumulative_gas_used{0};
+    Result<void> status{outcome::success()};
 
-MONAD_NAMESPACE_BEGIN
+    boost::fibers::mutex mutex;
+    boost::fibers::condition_variable cv;
+    size_t n_appended{0};
 
-std::vector<std::optional<Address>> recover_senders(
-    std::span<Transaction const> const transactions,
-    fiber::PriorityPool &priority_pool)
+    explicit OrderedOutputs(TransactionOutputSink &output_sink)
+        : sink{output_sink}
+    {
+    }
+
+    void append(
+        size_t const i, Transaction const &transaction,
+        std::optional<Result<Receipt>> &&result)
+    {
+        wait_appended(i);
+
+        // An empty result means the transaction threw, which is rethrown to
+        // the caller through the merge order promises
+        if (result.has_value() && status.has_value()) {
+            if (MONAD_UNLIKELY(result->has_error())) {
+                LOG_ERROR(
+                    "tx {} {} validation failed: {}",
+                    i,
+                    transaction,
+                    result->assume_error().message().c_str());
+                status = std::move(*result).as_failure();
+            }
+            else {
+                // YP eq. 22
+                Receipt &receipt = result->value();
+                cumulative_gas_used += receipt.gas_used;
+                receipt.gas_used = cumulative_gas_used;
+                sink.consume(i, std::move(receipt));
+            }
+        }
+        sink.release(i);
+
+        {
+            std::unique_lock const lock{mutex};
+            ++n_appended;
+        }
+        cv.notify_all();
+    }
+
+    void wait_appended(size_t const n)
+    {
+        std::unique_lock lock{mutex};
+        cv.wait(lock, [this, n] { return n_appended >= n; });
+    }
+};
+
+// Hands out the tracers the caller made for every transaction of the block
+// and keeps every receipt
+class ReceiptCollector final : public TransactionOutputSink
 {
-    std::vector<std::optional<Address>> senders{transactions.size()};
+    std::span<std::unique_ptr<CallTracerBase>> call_tracers_;
+    std::span<std::unique_ptr<trace::StateTracer>> state_tracers_;
+
+public:
+    std::vector<Receipt> receipts;
+
+    ReceiptCollector(
+        std::span<std::unique_ptr<CallTracerBase>> const call_tracers,
+        std::span<std::unique_ptr<trace::StateTracer>> const state_tracers)
+        : call_tracers_{call_tracers}
+        , state_tracers_{state_tracers}
+    {
+        receipts.reserve(call_tracers.size());
+    }
 
-    std::shared_ptr<boost::fibers::promise<void>[]> promises{
-        new boost::fibers::promise<void>[transactions.size()]};
+    CallTracerBase &call_tracer(uint64_t const i) override
+    {
+        return *call_tracers_[i];
+    }
 
-    for (unsigned i = 0; i < transactions.size(); ++i) {
-        priority_pool.submit(
-            i,
-            [i = i,
-             promises = promises,
-             &sender = senders[i],
-             &transaction = transactions[i]] {
-                sender = recover_sender(transaction);
-                promises[i].set_value();
+    trace::StateTracer &state_tracer(uint64_t const i) override
+    {
+        return *state_tracers_[i];
+    }
+
+    void consume(uint64_t, Receipt &&receipt) override
+    {
+        receipts.push_back(std::move(receipt));
+    }
+
+    void release(uint64_t) override {}
+};
+
+// Signatures recovered by each fiber task. A recovery costs tens of
+// microseconds, so a chunk is long enough to amortize the task and its
+// promise while still spreading a block over every thread.
+constexpr size_t RECOVERY_CHUNK_SIZE = 16;
+
+// Runs recover(k) for each k in [0, n) on the fiber group, a chunk per task
+// at the priority of its first element, and waits for all of them
+template <class Priority, class Recover>
+void recover_in_chunks(
+    fiber::FiberGroup &fiber_group, size_t const n, Priority const &priority,
+    Recover const &recover)
+{
+    size_t const n_chunks =
+        (n + RECOVERY_CHUNK_SIZE - 1) / RECOVERY_CHUNK_SIZE;
+    std::shared_ptr<boost::fibers::promise<void>[]> promises{
+        new boost::fibers::promise<void>[n_chunks]};
+
+    for (size_t c = 0; c < n_chunks; ++c) {
+        size_t const begin = c * RECOVERY_CHUNK_SIZE;
+        size_t const end = std::min(n, begin + RECOVERY_CHUNK_SIZE);
+        fiber_group.submit(
+            priority(begin), [c, begin, end, promises, &recover] {
+                for (size_t k = begin; k < end; ++k) {
+                    recover(k);
+                }
+                promises[c].set_value();
             });
     }
 
-    for (unsigned i = 0; i < transactions.size(); ++i) {
-        promises[i].get_future().wait();
+    for (size_t c = 0; c < n_chunks; ++c) {
+        promises[c].get_future().wait();
     }
+}
 
+MONAD_ANONYMOUS_NAMESPACE_END
+
+MONAD_NAMESPACE_BEGIN
+
+std::vector<std::optional<Address>> recover_senders(
+    std::span<Transaction const> const transactions,
+    fiber::FiberGroup &fiber_group)
+{
+    std::vector<std::optional<Address>> senders{transactions.size()};
+    recover_in_chunks(
+        fiber_group,
+        transactions.size(),
+        [](size_t const i) { return i; },
+        [&](size_t const i) { senders[i] = recover_sender(transactions[i]); });
     return senders;
 }
 
-std::vector<std::vector<std::optional<Address>>> recover_authorities(
+std::vector<std::optional<Address>> recover_senders(
     std::span<Transaction const> const transactions,
     fiber::PriorityPool &priority_pool)
+{
+    return recover_senders(transactions, priority_pool.fiber_group());
+}
+
+std::vector<std::vector<std::optional<Address>>> recover_authorities(
+    std::span<Transaction const> const transactions,
+    fiber::FiberGroup &fiber_group)
 {
     std::vector<std::vector<std::optional<Address>>> authorities{
         transactions.size()};
-    std::vector<std::shared_ptr<boost::fibers::promise<void>[]>> promises{
-        transactions.size()};
-
-    for (auto i = 0u; i < transactions.size(); ++i) {
-        authorities[i] = std::vector<std::optional<Address>>{
-            transactions[i].authorization_list.size()};
-        promises[i] = std::shared_ptr<boost::fibers::promise<void>[]>{
-            new boost::fibers::promise<void>[authorities[i].size()]};
-
-        for (auto j = 0u; j < authorities[i].size(); ++j) {
-            priority_pool.submit(
-                i,
-                [j = j,
-                 auth_promises = promises[i],
-                 &auth = authorities[i][j],
-                 &auth_entry = transactions[i].authorization_list[j]]() {
-                    auth = recover_authority(auth_entry);
-                    auth_promises[j].set_value();
-                });
-        }
-    }
 
-    for (auto i = 0u; i < transactions.size(); ++i) {
-        for (auto j = 0u; j < transactions[i].authorization_list.size(); ++j) {
-            promises[i][j].get_future().wait();
+    // The authorization lists of the block flattened into (transaction,
+    // entry) pairs, so that chunks span transactions
+    std::vector<std::pair<uint32_t, uint32_t>> entries;
+    for (uint32_t i = 0; i < transactions.size(); ++i) {
+        auto const n = transactions[i].authorization_list.size();
+        authorities[i].resize(n);
+        for (uint32_t j = 0; j < n; ++j) {
+            entries.emplace_back(i, j);
         }
     }
 
+    recover_in_chunks(
+        fiber_group,
+        entries.size(),
+        [&](size_t const k) { return entries[k].first; },
+        [&](size_t const k) {
+            auto const [i, j] = entries[k];
+            authorities[i][j] =
+                recover_authority(transactions[i].authorization_list[j]);
+        });
     return authorities;
 }
 
+std::vector<std::vector<std::optional<Address>>> recover_authorities(
+    std::span<Transaction const> const transactions,
+    fiber::PriorityPool &priority_pool)
+{
+    return recover_authorities(transactions, priority_pool.fiber_group());
+}
+
 template <Traits traits>
 void execute_block_header(
     Chain const &chain, BlockState &block_state, BlockHeader const &header)
@@ -211,38 +337,43 @@ void execute_block_header(
 EXPLICIT_TRAITS(execute_block_header);
 
 template <Traits traits>
-Result<std::vector<Receipt>> execute_block_transactions(
+Result<void> stream_block_transactions(
     Chain const &chain, BlockHeader const &header,
     std::span<Transaction const> const transactions,
     std::span<Address const> const senders,
     std::span<std::vector<std::optional<Address>> const> const authorities,
     BlockState &block_state, BlockHashBuffer const &block_hash_buffer,
     fiber::FiberGroup &priority_pool, BlockMetrics &block_metrics,
-    std::span<std::unique_ptr<CallTracerBase>> const call_tracers,
-    std::span<std::unique_ptr<trace::StateTracer>> const state_tracers,
-    RevertTransactionFn const &revert_transaction)
+    TransactionOutputSink &sink, RevertTransactionFn const &revert_transaction)
 {
     MONAD_ASSERT(senders.size() == transactions.size());
-    MONAD_ASSERT(senders.size() == call_tracers.size());
-    MONAD_ASSERT(senders.size() == state_tracers.size());
 
-    std::shared_ptr<boost::fibers::promise<void>[]> promises{
-        new boost::fibers::promise<void>[transactions.size() + 1]};
-    promises[0].set_value();
+    // Each transaction waits on the merge order promise of the one before it
+    // and sets its own, so only the transactions in flight hold a promise
+    auto prev = std::make_shared<boost::fibers::promise<void>>();
+    prev->set_value();
 
-    std::shared_ptr<std::optional<Result<Receipt>>[]> const results{
-        new std::optional<Result<Receipt>>[transactions.size()]};
+    // A transaction is only submitted once the one a window before it has
+    // been handed to the sink
+    size_t const window =
+        SUBMISSION_WINDOW_PER_FIBER * priority_pool.num_fibers();
     std::atomic<size_t> txn_exec_finished = 0;
     size_t const txn_count = transactions.size();
+    auto const outputs = std::make_shared<OrderedOutputs>(sink);
 
     auto const tx_exec_begin = std::chrono::steady_clock::now();
     for (unsigned i = 0; i < txn_count; ++i) {
+        if (i >= window) {
+            outputs->wait_appended(i - window + 1);
+        }
+        auto next = std::make_shared<boost::fibers::promise<void>>();
         priority_pool.submit(
             i,
             [&chain = chain,
              i = i,
-             results = results,
-             promises = promises,
+             prev = prev,
+             next = next,
+             outputs = outputs,
              &transaction = transactions[i],
              &sender = senders[i],
              &authorities = authorities[i],
@@ -250,13 +381,14 @@ Result<std::vector<Receipt>> execute_block_transactions(
              &block_hash_buffer = block_hash_buffer,
              &block_state,
              &block_metrics,
-             &call_tracer = *call_tracers[i],
-             &state_tracer = *state_tracers[i],
+             &call_tracer = sink.call_tracer(i),
+             &state_tracer = sink.state_tracer(i),
              &txn_exec_finished,
              &revert_transaction = revert_transaction] {
                 record_txn_marker_event(MONAD_EXEC_TXN_PERF_EVM_ENTER, i);
+                std::optional<Result<Receipt>> result;
                 try {
-                    results[i] = dispatch_transaction<traits>(
+                    result = dispatch_transaction<traits>(
                         chain,
                         i,
                         transaction,
@@ -266,65 +398,47 @@ Result<std::vector<Receipt>> execute_block_transactions(
                         block_hash_buffer,
                         block_state,
                         block_metrics,
-                        promises[i],
+                        *prev,
                         call_tracer,
                         state_tracer,
                         revert_transaction);
-                    promises[i + 1].set_value();
-                    if (results[i]->has_error()) {
-                        record_txn_error_event(i, results[i]->error());
+                    next->set_value();
+                    if (result->has_error()) {
+                        record_txn_error_event(i, result->error());
                     }
                     record_txn_marker_event(MONAD_EXEC_TXN_PERF_EVM_EXIT, i);
                 }
                 catch (...) {
-                    promises[i + 1].set_exception(std::current_exception());
+                    next->set_exception(std::current_exception());
                 }
+                outputs->append(i, transaction, std::move(result));
                 txn_exec_finished.fetch_add(1, std::memory_order::relaxed);
             });
+        prev = std::move(next);
     }
 
-    auto const last = static_cast<std::ptrdiff_t>(transactions.size());
-    promises[last].get_future().get();
+    prev->get_future().get();
     block_metrics.set_tx_exec_time(
         std::chrono::duration_cast<std::chrono::microseconds>(
             std::chrono::steady_clock::now() - tx_exec_begin));
 
     // All transactions have released their merge-order synchronization
-    // primitive (promises[i + 1]) but some stragglers could still be running
+    // primitive (next) but some stragglers could still be running
     // post-execution code that occurs immediately after that, e.g.
-    // `record_txn_exec_result_events`. This waits for everything to finish
-    // so that it's safe to assume we're the only ones using `results`.
+    // `record_txn_exec_result_events` or handing outputs to the sink.
+    // This waits for everything to finish
+    // so that it's safe to assume we're the only ones using `outputs`.
     while (txn_exec_finished.load() < txn_count) {
         cpu_relax();
     }
 
-    std::vector<Receipt> retvals;
-    for (unsigned i = 0; i < transactions.size(); ++i) {
-        MONAD_ASSERT(results[i].has_value());
-        if (MONAD_UNLIKELY(results[i].value().has_error())) {
-            LOG_ERROR(
-                "tx {} {} validation failed: {}",
-                i,
-                transactions[i],
-                results[i].value().assume_error().message().c_str());
-        }
-        BOOST_OUTCOME_TRY(auto retval, std::move(results[i].value()));
-        retvals.push_back(std::move(retval));
-    }
-
-    // YP eq. 22
-    uint64_t cumulative_gas_used = 0;
-    for (auto &receipt : retvals) {
-        cumulative_gas_used += receipt.gas_used;
-        receipt.gas_used = cumulative_gas_used;
-    }
-
-    return retvals;
+    return std::move(outputs->status);
 }
 
 template <Traits traits>
-Result<std::vector<Receipt>> execute_block(
-    Chain const &chain, Block const &block,
+Result<std::vector<Receipt>> execute_block_transactions(
+    Chain const &chain, BlockHeader const &header,
+    std::span<Transaction const> const transactions,
     std::span<Address const> const senders,
     std::span<std::vector<std::optional<Address>> const> const authorities,
     BlockState &block_state, BlockHashBuffer const &block_hash_buffer,
@@ -332,30 +446,53 @@ Result<std::vector<Receipt>> execute_block(
     std::span<std::unique_ptr<CallTracerBase>> const call_tracers,
     std::span<std::unique_ptr<trace::StateTracer>> const state_tracers,
     RevertTransactionFn const &revert_transaction)
+{
+    MONAD_ASSERT(senders.size() == call_tracers.size());
+    MONAD_ASSERT(senders.size() == state_tracers.size());
+
+    ReceiptCollector collector{call_tracers, state_tracers};
+    BOOST_OUTCOME_TRY(stream_block_transactions<traits>(
+        chain,
+        header,
+        transactions,
+        senders,
+        authorities,
+        block_state,
+        block_hash_buffer,
+        priority_pool,
+        block_metrics,
+        collector,
+        revert_transaction));
+    return std::move(collector.receipts);
+}
+
+template <Traits traits>
+Result<void> stream_block(
+    Chain const &chain, Block const &block,
+    std::span<Address const> const senders,
+    std::span<std::vector<std::optional<Address>> const> const authorities,
+    BlockState &block_state, BlockHashBuffer const &block_hash_buffer,
+    fiber::FiberGroup &priority_pool, BlockMetrics &block_metrics,
+    TransactionOutputSink &sink, RevertTransactionFn const &revert_transaction)
 {
     TRACE_BLOCK_EVENT(StartBlock);
 
     MONAD_ASSERT(senders.size() == block.transactions.size());
-    MONAD_ASSERT(senders.size() == call_tracers.size());
-    MONAD_ASSERT(senders.size() == state_tracers.size());
 
     execute_block_header<traits>(chain, block_state, block.header);
 
-    BOOST_OUTCOME_TRY(
-        auto const retvals,
-        execute_block_transactions<traits>(
-            chain,
-            block.header,
-            block.transactions,
-            senders,
-            authorities,
-            block_state,
-            block_hash_buffer,
-            priority_pool,
-            block_metrics,
-            call_tracers,
-            state_tracers,
-            revert_transaction));
+    BOOST_OUTCOME_TRY(stream_block_transactions<traits>(
+        chain,
+        block.header,
+        block.transactions,
+        senders,
+        authorities,
+        block_state,
+        block_hash_buffer,
+        priority_pool,
+        block_metrics,
+        sink,
+        revert_transaction));
 
     State state{
         block_state, Incarnation{block.header.number, Incarnation::LAST_TX}};
@@ -374,11 +511,42 @@ Result<std::vector<Receipt>> execute_block(
     block_state.merge(state);
     record_account_access_events(MONAD_ACCT_ACCESS_BLOCK_EPILOGUE, state);
 
-    return retvals;
+    return outcome::success();
+}
+
+template <Traits traits>
+Result<std::vector<Receipt>> execute_block(
+    Chain const &chain, Block const &block,
+    std::span<Address const> const senders,
+    std::span<std::vector<std::optional<Address>> const> const authorities,
+    BlockState &block_state, BlockHashBuffer const &block_hash_buffer,
+    fiber::FiberGroup &priority_pool, BlockMetrics &block_metrics,
+    std::span<std::unique_ptr<CallTracerBase>> const call_tracers,
+    std::span<std::unique_ptr<trace::StateTracer>> const state_tracers,
+    RevertTransactionFn const &revert_transaction)
+{
+    MONAD_ASSERT(senders.size() == call_tracers.size());
+    MONAD_ASSERT(senders.size() == state_tracers.size());
+
+    ReceiptCollector collector{call_tracers, state_tracers};
+    BOOST_OUTCOME_TRY(stream_block<traits>(
+        chain,
+        block,
+        senders,
+        authorities,
+        block_state,
+        block_hash_buffer,
+        priority_pool,
+        block_metrics,
+        collector,
+        revert_transaction));
+    return std::move(collector.receipts);
 }
 
 // Explicit instantiations using EXPLICIT_TRAITS macro
+EXPLICIT_TRAITS(stream_block_transactions);
 EXPLICIT_TRAITS(execute_block_transactions);
+EXPLICIT_TRAITS(stream_block);
 EXPLICIT_TRAITS(execute_block);
 
 MONAD_NAMESPACE_END
@@ -27,6 +27,8 @@
 
 #include <evmc/evmc.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <span>
@@ -46,6 +48,33 @@ namespace fiber
     class PriorityPool;
 } // namespace fiber
 
+// Transactions submitted ahead of the ones already handed to the output sink,
+// per fiber executing them
+inline constexpr size_t SUBMISSION_WINDOW_PER_FIBER = 4;
+
+// Receives the outputs of the transactions of a block in transaction order,
+// as each transaction merges. At most SUBMISSION_WINDOW_PER_FIBER transactions
+// per fiber are in flight, so a sink that recycles its tracers and does not
+// keep the receipts runs a block of any size in bounded memory.
+class TransactionOutputSink
+{
+public:
+    virtual ~TransactionOutputSink() = default;
+
+    // Tracers of transaction i, taken before it is submitted and kept until
+    // release(i)
+    virtual CallTracerBase &call_tracer(uint64_t i) = 0;
+    virtual trace::StateTracer &state_tracer(uint64_t i) = 0;
+
+    // Receipt of transaction i, with the cumulative gas used of the block.
+    // Only called while every transaction before it was valid.
+    virtual void consume(uint64_t i, Receipt &&) = 0;
+
+    // Called for every transaction once it is done with its tracers, after
+    // consume(i) if any
+    virtual void release(uint64_t i) = 0;
+};
+
 template <Traits traits>
 void execute_block_header(Chain const &, BlockState &, BlockHeader const &);
 
@@ -70,9 +99,36 @@ Result<std::vector<Receipt>> execute_block(
     RevertTransactionFn const & = [](Address const &, Transaction const &,
                                      uint64_t, State &) { return false; });
 
+template <Traits traits>
+Result<void> stream_block_transactions(
+    Chain const &, BlockHeader const &, std::span<Transaction const>,
+    std::span<Address const> senders,
+    std::span<std::vector<std::optional<Address>> const> authorities,
+    BlockState &, BlockHashBuffer const &, fiber::FiberGroup &, BlockMetrics &,
+    TransactionOutputSink &,
+    RevertTransactionFn const & = [](Address const &, Transaction const &,
+                                     uint64_t, State &) { return false; });
+
+template <Traits traits>
+Result<void> stream_block(
+    Chain const &, Block const &, std::span<Address const> senders,
+    std::span<std::vector<std::optional<Address>> const> authorities,
+    BlockState &, BlockHashBuffer const &, fiber::FiberGroup &, BlockMetrics &,
+    TransactionOutputSink &,
+    RevertTransactionFn const & = [](Address const &, Transaction const &,
+                                     uint64_t, State &) { return false; });
+
+// Senders and authorities are recovered in fixed size chunks of signatures
+// across the whole block, one fiber task per chunk
+std::vector<std::optional<Address>>
+recover_senders(std::span<Transaction const>, fiber::FiberGroup &);
+
 std::vector<std::optional<Address>>
 recover_senders(std::span<Transaction const>, fiber::PriorityPool &);
 
+std::vector<std::vector<std::optional<Address>>>
+recover_authorities(std::span<Transaction const>, fiber::FiberGroup &);
+
 std::vector<std::vector<std::optional<Address>>>
 recover_authorities(std::span<Transaction const>, fiber::PriorityPool &);
 
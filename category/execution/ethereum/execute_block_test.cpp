@@ -19,8 +19,11 @@
 #include <category/execution/ethereum/block_hash_buffer.hpp>
 #include <category/execution/ethereum/chain/ethereum_mainnet.hpp>
 #include <category/execution/ethereum/core/rlp/block_rlp.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
 #include <category/execution/ethereum/execute_block.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/state3/state.hpp>
+#include <category/execution/ethereum/trace/call_tracer.hpp>
 #include <category/execution/ethereum/trace/rlp/call_frame_rlp.hpp>
 #include <category/execution/monad/chain/monad_mainnet.hpp>
 #include <category/mpt/traverse_util.hpp>
@@ -28,6 +31,12 @@
 
 #include <test_resource_data.h>
 
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
 using namespace monad;
 using namespace monad::test;
 
@@ -99,6 +108,90 @@ namespace
         MONAD_ASSERT(view.empty());
         return call_frame.value();
     }
+
+    Address make_address(uint64_t const tag, uint64_t const n)
+    {
+        Address address{};
+        std::memcpy(address.bytes, &tag, sizeof(tag));
+        std::memcpy(address.bytes + 12, &n, sizeof(n));
+        return address;
+    }
+
+    // Recycles a few tracers across the block and checks each receipt as it
+    // arrives instead of keeping it
+    class PooledSink final : public TransactionOutputSink
+    {
+        struct Tracers
+        {
+            std::unique_ptr<NoopCallTracer> call_tracer;
+            std::unique_ptr<trace::StateTracer> state_tracer;
+        };
+
+        std::mutex mutex_;
+        std::vector<Tracers> free_;
+        std::unordered_map<uint64_t, Tracers> in_use_;
+
+        Tracers &acquire(uint64_t const i)
+        {
+            std::unique_lock const lock{mutex_};
+            auto const it = in_use_.find(i);
+            if (it != in_use_.end()) {
+                return it->second;
+            }
+            Tracers tracers;
+            if (free_.empty()) {
+                ++n_allocated;
+                tracers.call_tracer = std::make_unique<NoopCallTracer>();
+                tracers.state_tracer =
+                    std::make_unique<trace::StateTracer>(std::monostate{});
+            }
+            else {
+                tracers = std::move(free_.back());
+                free_.pop_back();
+            }
+            auto &acquired = in_use_[i];
+            acquired = std::move(tracers);
+            max_in_use = std::max(max_in_use, in_use_.size());
+            return acquired;
+        }
+
+    public:
+        size_t n_allocated{0};
+        size_t max_in_use{0};
+        uint64_t n_consumed{0};
+        uint64_t n_released{0};
+        uint64_t cumulative_gas_used{0};
+
+        CallTracerBase &call_tracer(uint64_t const i) override
+        {
+            return *acquire(i).call_tracer;
+        }
+
+        trace::StateTracer &state_tracer(uint64_t const i) override
+        {
+            return *acquire(i).state_tracer;
+        }
+
+        void consume(uint64_t const i, Receipt &&receipt) override
+        {
+            EXPECT_EQ(i, n_consumed);
+            EXPECT_EQ(receipt.status, 1);
+            EXPECT_EQ(receipt.gas_used, cumulative_gas_used + 21'000);
+            cumulative_gas_used = receipt.gas_used;
+            ++n_consumed;
+        }
+
+        void release(uint64_t const i) override
+        {
+            EXPECT_EQ(i, n_released);
+            ++n_released;
+            std::unique_lock const lock{mutex_};
+            auto const it = in_use_.find(i);
+            ASSERT_NE(it, in_use_.end());
+            free_.push_back(std::move(it->second));
+            in_use_.erase(it);
+        }
+    };
 }
 
 // test referenced from
@@ -510,3 +603,104 @@ TYPED_TEST(TraitsTest, call_frames_refund)
 
     EXPECT_EQ(actual_call_frames[0], expected);
 }
+
+TEST(RecoverAuthorities, chunks_span_transactions)
+{
+    using intx::operator""_u256;
+
+    // Authorization lists of uneven sizes, so the chunks of the block wide
+    // batch start and end in the middle of transactions
+    std::vector<Transaction> transactions;
+    uint64_t nonce = 0;
+    for (size_t const n : {0u, 3u, 20u, 1u, 0u, 17u}) {
+        Transaction &tx = transactions.emplace_back();
+        for (size_t j = 0; j < n; ++j) {
+            tx.authorization_list.push_back(AuthorizationEntry{
+                .sc =
+                    {.r =
+                         0x462186579a4be0ad8a63224059a11693b4c0684b9939f6c2394d1fbe045275f2_u256,
+                     .s =
+                         0x59d73f99e037295a5f8c0e656acdb5c8b9acd28ec73c320c277df61f2e2d54f9_u256,
+                     .chain_id = 1,
+                     .y_parity = static_cast<uint8_t>(nonce % 3)},
+                .nonce = nonce++});
+        }
+    }
+
+    fiber::PriorityPool pool{2, 4};
+    auto const authorities = recover_authorities(transactions, pool);
+    ASSERT_EQ(authorities.size(), transactions.size());
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        auto const &list = transactions[i].authorization_list;
+        ASSERT_EQ(authorities[i].size(), list.size());
+        for (size_t j = 0; j < list.size(); ++j) {
+            EXPECT_EQ(authorities[i][j], recover_authority(list[j]));
+        }
+    }
+}
+
+TEST(StreamBlock, tracers_bounded_by_window)
+{
+    using traits = EvmTraits<EVMC_PRAGUE>;
+    using intx::operator""_u256;
+
+    InMemoryMachine machine;
+    mpt::Db db{machine};
+    db_t tdb{db};
+    vm::VM vm;
+    BlockState bs{tdb, vm};
+    BlockMetrics metrics;
+
+    // A block larger than the window, so that tracers must be recycled
+    constexpr uint64_t n_txns = 2'000;
+    std::vector<Address> senders;
+    std::vector<Transaction> transactions;
+    {
+        State state{bs, Incarnation{0, 0}};
+        for (uint64_t i = 0; i < n_txns; ++i) {
+            senders.push_back(make_address(1, i));
+            state.add_to_balance(senders.back(), 1'000'000'000'000'000'000);
+            transactions.push_back(Transaction{
+                .sc =
+                    {.r =
+                         0x5fd883bb01a10915ebc06621b925bd6d624cb6768976b73c0d468b31f657d15b_u256,
+                     .s =
+                         0x121d855c539a23aadf6f06ac21165db1ad5efd261842e82a719c9863ca4ac04c_u256},
+                .nonce = 0,
+                .max_fee_per_gas = 10,
+                .gas_limit = 21'000,
+                .value = 1'000 + i,
+                .to = make_address(2, i),
+            });
+        }
+        bs.merge(state);
+    }
+    std::vector<std::vector<std::optional<Address>>> const authorities(
+        n_txns);
+
+    BlockHeader const header{
+        .number = 1, .beneficiary = make_address(3, 0), .base_fee_per_gas = 1};
+    BlockHashBufferFinalized const block_hash_buffer;
+    fiber::PriorityPool pool{2, 4};
+    PooledSink sink;
+
+    auto const result = stream_block_transactions<traits>(
+        EthereumMainnet{},
+        header,
+        transactions,
+        senders,
+        authorities,
+        bs,
+        block_hash_buffer,
+        pool.fiber_group(),
+        metrics,
+        sink);
+    ASSERT_TRUE(result.has_value());
+
+    EXPECT_EQ(sink.n_consumed, n_txns);
+    EXPECT_EQ(sink.n_released, n_txns);
+    EXPECT_EQ(sink.cumulative_gas_used, n_txns * 21'000);
+    size_t const window = SUBMISSION_WINDOW_PER_FIBER * pool.num_fibers();
+    EXPECT_LE(sink.max_in_use, window);
+    EXPECT_LE(sink.n_allocated, window);
+}
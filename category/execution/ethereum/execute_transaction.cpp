@@ -14,17 +14,20 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <category/core/assert.h>
+#include <category/core/bytes.hpp>
 #include <category/core/int.hpp>
 #include <category/core/likely.h>
 #include <category/execution/ethereum/block_hash_buffer.hpp>
 #include <category/execution/ethereum/chain/chain.hpp>
 #include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/core/receipt.hpp>
 #include <category/execution/ethereum/core/transaction.hpp>
 #include <category/execution/ethereum/event/record_txn_events.hpp>
 #include <category/execution/ethereum/evm.hpp>
 #include <category/execution/ethereum/evmc_host.hpp>
 #include <category/execution/ethereum/execute_transaction.hpp>
 #include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/precompiles.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
 #include <category/execution/ethereum/state3/state.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
@@ -33,6 +36,7 @@
 #include <category/execution/ethereum/transaction_gas.hpp>
 #include <category/execution/ethereum/tx_context.hpp>
 #include <category/execution/ethereum/validate_transaction.hpp>
+#include <category/execution/monad/validate_monad_transaction.hpp>
 #include <category/vm/evm/delegation.hpp>
 #include <category/vm/evm/explicit_traits.hpp>
 #include <category/vm/evm/switch_traits.hpp>
@@ -45,7 +49,10 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <span>
 #include <utility>
+#include <variant>
 
 MONAD_ANONYMOUS_NAMESPACE_BEGIN
 
@@ -71,6 +78,38 @@ constexpr void irrevocable_change(
     state.subtract_from_balance(sender, upfront_cost + blob_gas);
 }
 
+// The pipeline is instantiated for the revision the chain runs at for the
+// block, so the chain rules resolve at compile time rather than through a
+// virtual call and a revision lookup for every transaction
+template <Traits traits>
+Result<void> validate_transaction_for_chain(
+    Transaction const &tx, Address const &sender, State &state,
+    uint256_t const &base_fee_per_gas,
+    std::span<std::optional<Address> const> const authorities)
+{
+    if constexpr (is_monad_trait_v<traits>) {
+        return validate_monad_transaction<traits>(
+            tx, sender, state, base_fee_per_gas, authorities);
+    }
+    else {
+        return validate_transaction<traits>(tx, sender, state);
+    }
+}
+
+// A call to an ordinary address that carries no access list or
+// authorizations and is not traced only moves value when the recipient turns
+// out to have no code, so it can skip the host and the VM altogether
+template <Traits traits>
+bool is_plain_transfer(
+    Transaction const &tx, CallTracerBase &call_tracer,
+    trace::StateTracer const &state_tracer)
+{
+    return tx.to.has_value() && tx.access_list.empty() &&
+           tx.authorization_list.empty() && !is_precompile<traits>(*tx.to) &&
+           dynamic_cast<NoopCallTracer *>(&call_tracer) != nullptr &&
+           std::holds_alternative<std::monostate>(state_tracer);
+}
+
 MONAD_ANONYMOUS_NAMESPACE_END
 
 MONAD_NAMESPACE_BEGIN
@@ -290,12 +329,15 @@ ExecuteTransaction<traits>::ExecuteTransaction(
     RevertTransactionFn const &revert_transaction)
     : ExecuteTransactionNoValidation<
           traits>{chain, tx, sender, authorities, header, i, revert_transaction}
+    , chain_id_{chain.get_chain_id()}
     , block_hash_buffer_{block_hash_buffer}
     , block_state_{block_state}
     , block_metrics_{block_metrics}
     , prev_{prev}
     , call_tracer_{call_tracer}
     , state_tracer_{state_tracer}
+    , plain_transfer_{
+          is_plain_transfer<traits>(tx, call_tracer, state_tracer)}
 {
     record_txn_header_events(static_cast<uint32_t>(i), tx, sender, authorities);
 }
@@ -304,9 +346,7 @@ template <Traits traits>
 Result<evmc::Result> ExecuteTransaction<traits>::execute_impl2(State &state)
 {
     auto const validate_lambda = [this, &state] {
-        auto result = chain_.validate_transaction(
-            header_.number,
-            header_.timestamp,
+        auto result = validate_transaction_for_chain<traits>(
             tx_,
             sender_,
             state,
@@ -322,8 +362,15 @@ Result<evmc::Result> ExecuteTransaction<traits>::execute_impl2(State &state)
     };
     BOOST_OUTCOME_TRY(validate_lambda());
 
+    // The code hash is read through the state, so a contract deployed to the
+    // recipient by an earlier transaction fails the merge and the retry
+    // takes the full path
+    if (plain_transfer_ && state.get_code_hash(*tx_.to) == NULL_HASH) {
+        return execute_transfer(state);
+    }
+
     auto const tx_context =
-        get_tx_context<traits>(tx_, sender_, header_, chain_.get_chain_id());
+        get_tx_context<traits>(tx_, sender_, header_, chain_id_);
     EvmcHost<traits> host{
         call_tracer_, tx_context, block_hash_buffer_, state, [this, &state] {
             return revert_transaction_(sender_, tx_, i_, state);
@@ -332,6 +379,47 @@ Result<evmc::Result> ExecuteTransaction<traits>::execute_impl2(State &state)
     return ExecuteTransactionNoValidation<traits>::operator()(state, host);
 }
 
+// Same state changes as `ExecuteTransactionNoValidation` followed by a call
+// that runs no code
+template <Traits traits>
+evmc::Result ExecuteTransaction<traits>::execute_transfer(State &state)
+{
+    irrevocable_change<traits>(
+        state,
+        tx_,
+        sender_,
+        header_.base_fee_per_gas.value_or(0),
+        header_.excess_blob_gas.value_or(0));
+
+    // EIP-3651, where the host treats precompiles as always warm
+    if constexpr (traits::evm_rev() >= EVMC_SHANGHAI) {
+        if (!is_precompile<traits>(header_.beneficiary)) {
+            state.access_account(header_.beneficiary);
+        }
+    }
+    state.access_account(sender_);
+    state.access_account(*tx_.to);
+
+    auto const gas =
+        static_cast<int64_t>(tx_.gas_limit - intrinsic_gas<traits>(tx_));
+
+    state.push();
+    if (MONAD_UNLIKELY(
+            !state.record_balance_constraint_for_debit(sender_, tx_.value))) {
+        state.pop_reject();
+        return evmc::Result{EVMC_INSUFFICIENT_BALANCE, gas};
+    }
+    state.subtract_from_balance(sender_, tx_.value);
+    state.add_to_balance(*tx_.to, tx_.value);
+
+    if (revert_transaction_(sender_, tx_, i_, state)) {
+        state.pop_reject();
+        return evmc::Result{EVMC_MONAD_RESERVE_BALANCE_VIOLATION, gas};
+    }
+    state.pop_accept();
+    return evmc::Result{EVMC_SUCCESS, gas};
+}
+
 template <Traits traits>
 Receipt ExecuteTransaction<traits>::execute_final(
     State &state, evmc::Result const &result)
@@ -377,9 +465,9 @@ Receipt ExecuteTransaction<traits>::execute_final(
         .status = result.status_code == EVMC_SUCCESS ? 1u : 0u,
         .gas_used = gas_used,
         .type = tx_.type};
-    for (auto const &log : state.logs()) {
-        receipt.add_log(std::move(log));
-    }
+    // Hash the addresses and topics of all the logs as one batch
+    receipt.logs.assign(state.logs().begin(), state.logs().end());
+    populate_bloom(receipt.bloom, receipt.logs);
 
     return receipt;
 }
@@ -393,7 +481,7 @@ Result<Receipt> ExecuteTransaction<traits>::operator()()
         tx_,
         header_.base_fee_per_gas,
         header_.excess_blob_gas,
-        chain_.get_chain_id()));
+        chain_id_));
 
     {
         TRACE_TXN_EVENT(StartExecution);
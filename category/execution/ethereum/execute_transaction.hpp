@@ -16,6 +16,7 @@
 #pragma once
 
 #include <category/core/config.hpp>
+#include <category/core/int.hpp>
 #include <category/core/result.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/ethereum/core/receipt.hpp>
@@ -75,7 +76,6 @@ public:
 template <Traits traits>
 class ExecuteTransaction : public ExecuteTransactionNoValidation<traits>
 {
-    using ExecuteTransactionNoValidation<traits>::chain_;
     using ExecuteTransactionNoValidation<traits>::tx_;
     using ExecuteTransactionNoValidation<traits>::sender_;
     using ExecuteTransactionNoValidation<traits>::authorities_;
@@ -83,14 +83,17 @@ class ExecuteTransaction : public ExecuteTransactionNoValidation<traits>
     using ExecuteTransactionNoValidation<traits>::i_;
     using ExecuteTransactionNoValidation<traits>::revert_transaction_;
 
+    uint256_t const chain_id_;
     BlockHashBuffer const &block_hash_buffer_;
     BlockState &block_state_;
     BlockMetrics &block_metrics_;
     boost::fibers::promise<void> &prev_;
     CallTracerBase &call_tracer_;
     trace::StateTracer &state_tracer_;
+    bool const plain_transfer_;
 
     Result<evmc::Result> execute_impl2(State &);
+    evmc::Result execute_transfer(State &);
     Receipt execute_final(State &, evmc::Result const &);
 
 public:
@@ -13,6 +13,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <category/core/assert.h>
 #include <category/core/int.hpp>
 #include <category/execution/ethereum/block_hash_buffer.hpp>
 #include <category/execution/ethereum/chain/ethereum_mainnet.hpp>
@@ -24,6 +25,7 @@
 #include <category/execution/ethereum/metrics/block_metrics.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
 #include <category/execution/ethereum/state3/state.hpp>
+#include <category/execution/ethereum/trace/call_frame.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
 #include <category/execution/ethereum/trace/state_tracer.hpp>
 #include <category/execution/ethereum/tx_context.hpp>
@@ -40,8 +42,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <vector>
 
 using namespace monad;
 
@@ -609,3 +613,145 @@ TYPED_TEST(TraitsTest, refunds_delete_then_set)
         }
     }
 }
+
+TYPED_TEST(TraitsTest, plain_transfer_matches_traced_execution)
+{
+    using intx::operator""_u256;
+
+    static constexpr auto from{
+        0xf8636377b7a998b51a3cf2bd711b870b3ab0ad56_address};
+    static constexpr auto to{
+        0x00000000000000000000000000000000cccccccc_address};
+    static constexpr auto bene{
+        0x5353535353535353535353535353535353535353_address};
+
+    static constexpr uint256_t initial_balance{56'000'000'000'000'000};
+    static constexpr uint256_t value{1'000'000};
+
+    Transaction const tx{
+        .sc =
+            {.r =
+                 0x5fd883bb01a10915ebc06621b925bd6d624cb6768976b73c0d468b31f657d15b_u256,
+             .s =
+                 0x121d855c539a23aadf6f06ac21165db1ad5efd261842e82a719c9863ca4ac04c_u256},
+        .nonce = 25,
+        .max_fee_per_gas = 10,
+        .gas_limit = 30'000,
+        .value = value,
+        .to = to,
+    };
+    BlockHeader const header{.beneficiary = bene};
+    BlockHashBufferFinalized const block_hash_buffer;
+
+    struct Outcome
+    {
+        uint64_t status;
+        uint64_t gas_used;
+        uint256_t from_balance;
+        uint256_t to_balance;
+        uint256_t bene_balance;
+        uint64_t from_nonce;
+    };
+
+    auto const no_revert =
+        [](Address const &, Transaction const &, uint64_t, State &) {
+            return false;
+        };
+
+    // Only the untraced run takes the transfer path, the traced one runs the
+    // empty code of the recipient through the VM
+    auto const run = [&](uint256_t const &balance,
+                         RevertTransactionFn const &revert_transaction,
+                         CallTracerBase &call_tracer) {
+        InMemoryMachine machine;
+        mpt::Db db{machine};
+        db_t tdb{db};
+        vm::VM vm;
+        BlockState bs{tdb, vm};
+        BlockMetrics metrics;
+        {
+            State state{bs, Incarnation{0, 0}};
+            state.add_to_balance(from, balance);
+            state.set_nonce(from, 25);
+            bs.merge(state);
+        }
+
+        boost::fibers::promise<void> prev{};
+        prev.set_value();
+        trace::StateTracer state_tracer = std::monostate{};
+
+        auto const receipt = ExecuteTransaction<typename TestFixture::Trait>(
+            EthereumMainnet{},
+            0,
+            tx,
+            from,
+            {},
+            header,
+            block_hash_buffer,
+            bs,
+            metrics,
+            prev,
+            call_tracer,
+            state_tracer,
+            revert_transaction)();
+        MONAD_ASSERT(receipt.has_value());
+
+        State state{bs, Incarnation{0, 0}};
+        return Outcome{
+            .status = receipt.value().status,
+            .gas_used = receipt.value().gas_used,
+            .from_balance = state.get_balance(from),
+            .to_balance = state.get_balance(to),
+            .bene_balance = state.get_balance(bene),
+            .from_nonce = state.get_nonce(from)};
+    };
+
+    std::vector<CallFrame> call_frames;
+    auto const compare = [&](uint256_t const &balance,
+                             RevertTransactionFn const &revert_transaction) {
+        NoopCallTracer noop_call_tracer;
+        auto const fast = run(balance, revert_transaction, noop_call_tracer);
+
+        call_frames.clear();
+        CallTracer call_tracer{tx, call_frames};
+        auto const full = run(balance, revert_transaction, call_tracer);
+
+        EXPECT_EQ(fast.status, full.status);
+        EXPECT_EQ(fast.gas_used, full.gas_used);
+        EXPECT_EQ(fast.from_balance, full.from_balance);
+        EXPECT_EQ(fast.to_balance, full.to_balance);
+        EXPECT_EQ(fast.bene_balance, full.bene_balance);
+        EXPECT_EQ(fast.from_nonce, full.from_nonce);
+        return fast;
+    };
+
+    auto const success = compare(initial_balance, no_revert);
+    EXPECT_EQ(call_frames.size(), 1u);
+    EXPECT_EQ(success.status, 1u);
+    EXPECT_EQ(success.to_balance, value);
+    EXPECT_EQ(success.from_nonce, 26);
+
+    if constexpr (is_monad_trait_v<typename TestFixture::Trait>) {
+        // The value moved is rolled back, the fee is still charged
+        auto const violation = compare(
+            initial_balance,
+            [](Address const &, Transaction const &, uint64_t, State &) {
+                return true;
+            });
+        EXPECT_EQ(violation.status, 0u);
+        EXPECT_EQ(violation.to_balance, uint256_t{0});
+        EXPECT_EQ(violation.from_nonce, 26);
+        EXPECT_LT(violation.from_balance, initial_balance);
+
+        // From MONAD_FOUR the sender only has to cover the fee, so the value
+        // can exceed the balance left once the fee is debited
+        if constexpr (TestFixture::Trait::monad_rev() >= MONAD_FOUR) {
+            uint256_t const max_fee =
+                uint256_t{tx.gas_limit} * tx.max_fee_per_gas;
+            auto const insufficient = compare(max_fee + value - 1, no_revert);
+            EXPECT_EQ(insufficient.status, 0u);
+            EXPECT_EQ(insufficient.to_balance, uint256_t{0});
+            EXPECT_EQ(insufficient.from_nonce, 26);
+        }
+    }
+}
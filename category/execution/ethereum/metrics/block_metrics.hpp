@@ -25,6 +25,9 @@ class BlockMetrics
 {
     uint32_t n_retries_{0};
     std::chrono::microseconds tx_exec_time_{1};
+    std::chrono::microseconds sender_recovery_time_{0};
+    std::chrono::microseconds commit_time_{0};
+    std::chrono::microseconds block_time_{0};
 
 public:
     void inc_retries()
@@ -46,6 +49,37 @@ public:
     {
         return tx_exec_time_;
     }
+
+    void set_sender_recovery_time(std::chrono::microseconds const time)
+    {
+        sender_recovery_time_ = time;
+    }
+
+    std::chrono::microseconds sender_recovery_time() const
+    {
+        return sender_recovery_time_;
+    }
+
+    // Commit of the state changes, including the merkle root calculations
+    void set_commit_time(std::chrono::microseconds const time)
+    {
+        commit_time_ = time;
+    }
+
+    std::chrono::microseconds commit_time() const
+    {
+        return commit_time_;
+    }
+
+    void set_block_time(std::chrono::microseconds const time)
+    {
+        block_time_ = time;
+    }
+
+    std::chrono::microseconds block_time() const
+    {
+        return block_time_;
+    }
 };
 
 MONAD_NAMESPACE_END
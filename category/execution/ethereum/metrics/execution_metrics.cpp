@@ -0,0 +1,123 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/config.hpp>
+#include <category/core/fiber/priority_pool.hpp>
+#include <category/execution/ethereum/db/db.hpp>
+#include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/metrics/execution_metrics.hpp>
+#include <category/execution/ethereum/metrics/metrics_registry.hpp>
+#include <category/vm/vm.hpp>
+
+#include <cstdint>
+#include <memory>
+
+MONAD_NAMESPACE_BEGIN
+
+std::unique_ptr<ExecutionMetrics> g_execution_metrics;
+
+ExecutionMetrics::ExecutionMetrics()
+    : blocks_{registry.counter(
+          "monad_execution_blocks_total", "Blocks executed and committed")}
+    , transactions_{registry.counter(
+          "monad_execution_transactions_total", "Transactions executed")}
+    , gas_{registry.counter("monad_execution_gas_total", "Gas used")}
+    , retries_{registry.counter(
+          "monad_execution_transaction_retries_total",
+          "Transactions executed again after a conflict")}
+    , sender_recovery_us_{registry.histogram(
+          "monad_execution_sender_recovery_microseconds",
+          "Time to recover the senders and authorities of a block")}
+    , tx_exec_us_{registry.histogram(
+          "monad_execution_tx_exec_microseconds",
+          "Time to execute the transactions of a block")}
+    , commit_us_{registry.histogram(
+          "monad_execution_commit_microseconds",
+          "Time to commit a block, including the merkle root calculations")}
+    , block_us_{registry.histogram(
+          "monad_execution_block_microseconds", "Time to process a block")}
+    , account_reads_{registry.counter(
+          "monad_state_account_reads_total", "Account reads")}
+    , account_cache_hits_{registry.counter(
+          "monad_state_account_cache_hits_total",
+          "Account reads answered without reading the trie")}
+    , storage_reads_{registry.counter(
+          "monad_state_storage_reads_total", "Storage slot reads")}
+    , storage_cache_hits_{registry.counter(
+          "monad_state_storage_cache_hits_total",
+          "Storage slot reads answered without reading the trie")}
+    , trie_bytes_written_{registry.counter(
+          "monad_trie_bytes_written_total", "Bytes written to the trie db")}
+    , trie_bytes_compacted_{registry.counter(
+          "monad_trie_bytes_compacted_total",
+          "Bytes copied by trie db compaction")}
+    , trie_history_erase_rate_{registry.gauge(
+          "monad_trie_history_erase_rate",
+          "Versions erased by the last upsert to keep disk usage in band")}
+    , varcode_cache_hits_{registry.counter(
+          "monad_vm_varcode_cache_hits_total",
+          "Code lookups that found code ready to execute")}
+    , varcode_cache_misses_{registry.counter(
+          "monad_vm_varcode_cache_misses_total",
+          "Code lookups that did not find code ready to execute")}
+    , varcode_cache_size_{registry.gauge(
+          "monad_vm_varcode_cache_size", "Contracts in the code cache")}
+    , varcode_cache_weight_kb_{registry.gauge(
+          "monad_vm_varcode_cache_weight_kilobytes",
+          "Approximate size of the code cache")}
+    , fiber_queue_depth_{registry.gauge(
+          "monad_fiber_queue_depth",
+          "Tasks submitted to the priority pool and not yet started")}
+{
+}
+
+void ExecutionMetrics::record_block(
+    BlockMetrics const &block_metrics, uint64_t const ntxs, uint64_t const gas,
+    Db &db, vm::VM &vm, fiber::PriorityPool &priority_pool)
+{
+    blocks_.add();
+    transactions_.add(ntxs);
+    gas_.add(gas);
+    retries_.add(block_metrics.num_retries());
+    sender_recovery_us_.observe(
+        static_cast<uint64_t>(block_metrics.sender_recovery_time().count()));
+    tx_exec_us_.observe(
+        static_cast<uint64_t>(block_metrics.tx_exec_time().count()));
+    commit_us_.observe(
+        static_cast<uint64_t>(block_metrics.commit_time().count()));
+    block_us_.observe(
+        static_cast<uint64_t>(block_metrics.block_time().count()));
+
+    auto const stats = db.stats();
+    account_reads_.set(stats.account_reads);
+    account_cache_hits_.set(stats.account_cache_hits);
+    storage_reads_.set(stats.storage_reads);
+    storage_cache_hits_.set(stats.storage_cache_hits);
+    trie_bytes_written_.set(stats.trie_bytes_written);
+    trie_bytes_compacted_.set(stats.trie_bytes_compacted);
+    trie_history_erase_rate_.set(
+        static_cast<int64_t>(stats.trie_history_erase_rate));
+
+    auto const &varcode_cache = vm.compiler().varcode_cache();
+    varcode_cache_hits_.set(varcode_cache.hits());
+    varcode_cache_misses_.set(varcode_cache.misses());
+    varcode_cache_size_.set(static_cast<int64_t>(varcode_cache.size()));
+    varcode_cache_weight_kb_.set(
+        static_cast<int64_t>(varcode_cache.approx_weight()));
+
+    fiber_queue_depth_.set(static_cast<int64_t>(priority_pool.num_pending()));
+}
+
+MONAD_NAMESPACE_END
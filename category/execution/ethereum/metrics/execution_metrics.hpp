@@ -0,0 +1,91 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+#include <category/core/fiber/config.hpp>
+#include <category/execution/ethereum/metrics/metrics_registry.hpp>
+
+#include <cstdint>
+#include <memory>
+
+MONAD_NAMESPACE_BEGIN
+
+class BlockMetrics;
+struct Db;
+
+namespace fiber
+{
+    class PriorityPool;
+}
+
+namespace vm
+{
+    class VM;
+}
+
+// Metrics of block execution, and of the state, code and fiber resources it
+// uses, as exported by the process
+class ExecutionMetrics
+{
+public:
+    MetricsRegistry registry;
+
+private:
+    MetricsCounter &blocks_;
+    MetricsCounter &transactions_;
+    MetricsCounter &gas_;
+    MetricsCounter &retries_;
+    MetricsHistogram &sender_recovery_us_;
+    MetricsHistogram &tx_exec_us_;
+    MetricsHistogram &commit_us_;
+    MetricsHistogram &block_us_;
+    MetricsCounter &account_reads_;
+    MetricsCounter &account_cache_hits_;
+    MetricsCounter &storage_reads_;
+    MetricsCounter &storage_cache_hits_;
+    MetricsCounter &trie_bytes_written_;
+    MetricsCounter &trie_bytes_compacted_;
+    MetricsGauge &trie_history_erase_rate_;
+    MetricsCounter &varcode_cache_hits_;
+    MetricsCounter &varcode_cache_misses_;
+    MetricsGauge &varcode_cache_size_;
+    MetricsGauge &varcode_cache_weight_kb_;
+    MetricsGauge &fiber_queue_depth_;
+
+public:
+    ExecutionMetrics();
+
+    // Record a block once it is executed and committed
+    void record_block(
+        BlockMetrics const &, uint64_t ntxs, uint64_t gas, Db &, vm::VM &,
+        fiber::PriorityPool &);
+};
+
+// Set by the process if it exports metrics, null otherwise. A plain global
+// for the same reason as `g_exec_event_recorder`.
+extern std::unique_ptr<ExecutionMetrics> g_execution_metrics;
+
+inline void record_block_metrics(
+    BlockMetrics const &block_metrics, uint64_t const ntxs, uint64_t const gas,
+    Db &db, vm::VM &vm, fiber::PriorityPool &priority_pool)
+{
+    if (auto *const m = g_execution_metrics.get()) {
+        m->record_block(block_metrics, ntxs, gas, db, vm, priority_pool);
+    }
+}
+
+MONAD_NAMESPACE_END
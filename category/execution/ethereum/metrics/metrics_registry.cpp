@@ -0,0 +1,140 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/config.hpp>
+#include <category/execution/ethereum/metrics/metrics_registry.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+MONAD_NAMESPACE_BEGIN
+
+namespace
+{
+    bool is_valid_name(std::string const &name)
+    {
+        return !name.empty() &&
+               !(name.front() >= '0' && name.front() <= '9') &&
+               std::all_of(name.begin(), name.end(), [](char const c) {
+                   return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                          (c >= '0' && c <= '9') || c == '_' || c == ':';
+               });
+    }
+}
+
+template <class T>
+T &MetricsRegistry::get_or_register(std::string name, std::string help)
+{
+    MONAD_ASSERT_PRINTF(
+        is_valid_name(name), "invalid metric name %s", name.c_str());
+    std::lock_guard const lock{mutex_};
+    for (auto &metric : metrics_) {
+        if (metric.name == name) {
+            MONAD_ASSERT_PRINTF(
+                std::holds_alternative<T>(metric.value),
+                "metric %s registered with another type",
+                name.c_str());
+            return std::get<T>(metric.value);
+        }
+    }
+    auto &metric = metrics_.emplace_back();
+    metric.name = std::move(name);
+    metric.help = std::move(help);
+    return metric.value.template emplace<T>();
+}
+
+MetricsCounter &MetricsRegistry::counter(std::string name, std::string help)
+{
+    return get_or_register<MetricsCounter>(std::move(name), std::move(help));
+}
+
+MetricsGauge &MetricsRegistry::gauge(std::string name, std::string help)
+{
+    return get_or_register<MetricsGauge>(std::move(name), std::move(help));
+}
+
+MetricsHistogram &
+MetricsRegistry::histogram(std::string name, std::string help)
+{
+    return get_or_register<MetricsHistogram>(
+        std::move(name), std::move(help));
+}
+
+std::string MetricsRegistry::to_prometheus() const
+{
+    std::string out;
+    auto it = std::back_inserter(out);
+    std::lock_guard const lock{mutex_};
+    for (auto const &metric : metrics_) {
+        std::format_to(it, "# HELP {} {}\n", metric.name, metric.help);
+        std::visit(
+            [&]<class T>(T const &value) {
+                auto const &name = metric.name;
+                if constexpr (std::is_same_v<T, MetricsCounter>) {
+                    std::format_to(
+                        it,
+                        "# TYPE {} counter\n{} {}\n",
+                        name,
+                        name,
+                        value.value());
+                }
+                else if constexpr (std::is_same_v<T, MetricsGauge>) {
+                    std::format_to(
+                        it,
+                        "# TYPE {} gauge\n{} {}\n",
+                        name,
+                        name,
+                        value.value());
+                }
+                else {
+                    std::format_to(it, "# TYPE {} histogram\n", name);
+                    uint64_t count = 0;
+                    unsigned const last = MetricsHistogram::NUM_BUCKETS - 1;
+                    for (unsigned i = 0; i < last; ++i) {
+                        count += value.bucket(i);
+                        std::format_to(
+                            it,
+                            "{}_bucket{{le=\"{}\"}} {}\n",
+                            name,
+                            MetricsHistogram::upper_bound(i),
+                            count);
+                    }
+                    count += value.bucket(last);
+                    std::format_to(
+                        it,
+                        "{}_bucket{{le=\"+Inf\"}} {}\n{}_sum {}\n"
+                        "{}_count {}\n",
+                        name,
+                        count,
+                        name,
+                        value.sum(),
+                        name,
+                        count);
+                }
+            },
+            metric.value);
+    }
+    return out;
+}
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,142 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <variant>
+
+MONAD_NAMESPACE_BEGIN
+
+// Monotonic count. Safe to add to concurrently.
+class MetricsCounter
+{
+    std::atomic<uint64_t> value_{0};
+
+public:
+    void add(uint64_t const n = 1) noexcept
+    {
+        value_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Publish a running total counted elsewhere
+    void set(uint64_t const total) noexcept
+    {
+        value_.store(total, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const noexcept
+    {
+        return value_.load(std::memory_order_relaxed);
+    }
+};
+
+class MetricsGauge
+{
+    std::atomic<int64_t> value_{0};
+
+public:
+    void set(int64_t const value) noexcept
+    {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+    void add(int64_t const n) noexcept
+    {
+        value_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    int64_t value() const noexcept
+    {
+        return value_.load(std::memory_order_relaxed);
+    }
+};
+
+// Distribution of samples over power of two buckets: bucket `i` counts the
+// samples of bit width `i`, the last bucket also the wider ones. Observing a
+// sample is two relaxed atomic adds, safe to do concurrently.
+class MetricsHistogram
+{
+public:
+    static constexpr unsigned NUM_BUCKETS = 40;
+
+private:
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets_{};
+    std::atomic<uint64_t> sum_{0};
+
+public:
+    void observe(uint64_t const sample) noexcept
+    {
+        auto const i = std::min(
+            static_cast<unsigned>(std::bit_width(sample)), NUM_BUCKETS - 1);
+        buckets_[i].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(sample, std::memory_order_relaxed);
+    }
+
+    // Largest sample counted by bucket `i`, except for the last bucket
+    static constexpr uint64_t upper_bound(unsigned const i) noexcept
+    {
+        return (uint64_t{1} << i) - 1;
+    }
+
+    uint64_t bucket(unsigned const i) const noexcept
+    {
+        return buckets_[i].load(std::memory_order_relaxed);
+    }
+
+    uint64_t sum() const noexcept
+    {
+        return sum_.load(std::memory_order_relaxed);
+    }
+};
+
+// Named metrics, rendered in the Prometheus text exposition format.
+// Registering takes a lock, so metrics are registered up front and updated
+// through the returned references, which stay valid for the lifetime of the
+// registry.
+class MetricsRegistry
+{
+    struct Metric
+    {
+        std::string name;
+        std::string help;
+        std::variant<MetricsCounter, MetricsGauge, MetricsHistogram> value;
+    };
+
+    mutable std::mutex mutex_;
+    std::deque<Metric> metrics_;
+
+    template <class T>
+    T &get_or_register(std::string name, std::string help);
+
+public:
+    // Registering a name again returns the metric already registered
+    MetricsCounter &counter(std::string name, std::string help);
+    MetricsGauge &gauge(std::string name, std::string help);
+    MetricsHistogram &histogram(std::string name, std::string help);
+
+    std::string to_prometheus() const;
+};
+
+MONAD_NAMESPACE_END
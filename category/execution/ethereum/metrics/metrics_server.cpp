@@ -0,0 +1,179 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/config.hpp>
+#include <category/execution/ethereum/metrics/metrics_registry.hpp>
+#include <category/execution/ethereum/metrics/metrics_server.hpp>
+
+#include <quill/Quill.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+MONAD_NAMESPACE_BEGIN
+
+namespace
+{
+    // How long a client gets to send its request
+    constexpr int REQUEST_TIMEOUT_MS = 100;
+
+    void send_all(int const fd, std::string_view buf)
+    {
+        while (!buf.empty()) {
+            ssize_t const res =
+                ::send(fd, buf.data(), buf.size(), MSG_NOSIGNAL);
+            if (res == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                LOG_WARNING("Failed to send metrics: {}", strerror(errno));
+                return;
+            }
+            buf.remove_prefix(static_cast<size_t>(res));
+        }
+    }
+}
+
+MetricsServer::MetricsServer(
+    MetricsRegistry const &registry, std::filesystem::path path)
+    : registry_{registry}
+    , path_{std::move(path)}
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    MONAD_ASSERT_PRINTF(
+        path_.native().size() < sizeof(addr.sun_path),
+        "metrics socket path too long: %s",
+        path_.c_str());
+    strncpy(addr.sun_path, path_.c_str(), sizeof(addr.sun_path) - 1);
+
+    // a socket left behind by an earlier run
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    MONAD_ASSERT_PRINTF(
+        listen_fd_ >= 0, "failed to create socket: %s", strerror(errno));
+    MONAD_ASSERT_PRINTF(
+        bind(listen_fd_, (sockaddr *)&addr, sizeof(addr)) == 0,
+        "failed to bind metrics socket %s: %s",
+        path_.c_str(),
+        strerror(errno));
+    MONAD_ASSERT_PRINTF(
+        listen(listen_fd_, 16) == 0,
+        "failed to listen on metrics socket: %s",
+        strerror(errno));
+    shutdown_eventfd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    MONAD_ASSERT_PRINTF(
+        shutdown_eventfd_ >= 0,
+        "failed to create eventfd: %s",
+        strerror(errno));
+
+    thread_ = std::thread{[this] {
+        pthread_setname_np(pthread_self(), "metrics server");
+        run();
+    }};
+    LOG_INFO("Serving metrics on {}", path_);
+}
+
+MetricsServer::~MetricsServer()
+{
+    uint64_t const val = 1;
+    if (write(shutdown_eventfd_, &val, sizeof(val)) != sizeof(val)) {
+        LOG_WARNING("Failed to signal shutdown eventfd: {}", strerror(errno));
+    }
+    thread_.join();
+    close(shutdown_eventfd_);
+    close(listen_fd_);
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+}
+
+void MetricsServer::run()
+{
+    while (true) {
+        std::array<pollfd, 2> pfds{};
+        pfds[0].fd = listen_fd_;
+        pfds[0].events = POLLIN;
+        pfds[1].fd = shutdown_eventfd_;
+        pfds[1].events = POLLIN;
+        if (poll(pfds.data(), pfds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("Metrics server poll failed: {}", strerror(errno));
+            return;
+        }
+        if (pfds[1].revents & POLLIN) {
+            return;
+        }
+        if (pfds[0].revents & POLLIN) {
+            int const fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd >= 0) {
+                serve(fd);
+                close(fd);
+            }
+        }
+    }
+}
+
+void MetricsServer::serve(int const fd) const
+{
+    // Read the request headers, whatever they ask for
+    std::string request;
+    std::array<char, 1024> buf;
+    while (request.find("\r\n\r\n") == std::string::npos &&
+           request.size() < 16 * 1024) {
+        pollfd pfd{.fd = fd, .events = POLLIN, .revents = 0};
+        if (poll(&pfd, 1, REQUEST_TIMEOUT_MS) <= 0) {
+            break;
+        }
+        ssize_t const res = ::recv(fd, buf.data(), buf.size(), 0);
+        if (res <= 0) {
+            break;
+        }
+        request.append(buf.data(), static_cast<size_t>(res));
+    }
+
+    auto const body = registry_.to_prometheus();
+    send_all(
+        fd,
+        std::format(
+            "HTTP/1.0 200 OK\r\n"
+            "Content-Type: text/plain; version=0.0.4\r\n"
+            "Content-Length: {}\r\n"
+            "Connection: close\r\n\r\n",
+            body.size()));
+    send_all(fd, body);
+}
+
+MONAD_NAMESPACE_END
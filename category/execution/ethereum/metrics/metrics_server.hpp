@@ -0,0 +1,50 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/core/config.hpp>
+
+#include <filesystem>
+#include <thread>
+
+MONAD_NAMESPACE_BEGIN
+
+class MetricsRegistry;
+
+// Serves the metrics of a registry over a unix domain socket, as a plain
+// HTTP response in the Prometheus text format to every connection, e.g. for
+// `curl --unix-socket <path> http://localhost/metrics`
+class MetricsServer
+{
+    MetricsRegistry const &registry_;
+    std::filesystem::path path_;
+    int listen_fd_{-1};
+    int shutdown_eventfd_{-1};
+    std::thread thread_;
+
+    void run();
+    void serve(int fd) const;
+
+public:
+    MetricsServer(MetricsRegistry const &, std::filesystem::path);
+
+    MetricsServer(MetricsServer const &) = delete;
+    MetricsServer &operator=(MetricsServer const &) = delete;
+
+    ~MetricsServer();
+};
+
+MONAD_NAMESPACE_END
@@ -0,0 +1,111 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/execution/ethereum/metrics/metrics_registry.hpp>
+#include <category/execution/ethereum/metrics/metrics_server.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <string_view>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace monad;
+
+TEST(MetricsRegistry, counter_and_gauge)
+{
+    MetricsRegistry registry;
+    auto &counter = registry.counter("test_total", "A counter");
+    counter.add();
+    counter.add(2);
+    EXPECT_EQ(&registry.counter("test_total", "A counter"), &counter);
+    registry.gauge("test_depth", "A gauge").set(-4);
+
+    EXPECT_EQ(
+        registry.to_prometheus(),
+        "# HELP test_total A counter\n"
+        "# TYPE test_total counter\n"
+        "test_total 3\n"
+        "# HELP test_depth A gauge\n"
+        "# TYPE test_depth gauge\n"
+        "test_depth -4\n");
+}
+
+TEST(MetricsRegistry, histogram)
+{
+    MetricsRegistry registry;
+    auto &histogram = registry.histogram("test_us", "A histogram");
+    histogram.observe(0);
+    histogram.observe(1);
+    histogram.observe(5);
+    histogram.observe(7);
+    histogram.observe(uint64_t{1} << 60);
+    EXPECT_EQ(histogram.bucket(0), 1);
+    EXPECT_EQ(histogram.bucket(1), 1);
+    EXPECT_EQ(histogram.bucket(3), 2);
+    EXPECT_EQ(histogram.bucket(MetricsHistogram::NUM_BUCKETS - 1), 1);
+
+    auto const text = registry.to_prometheus();
+    EXPECT_NE(text.find("# TYPE test_us histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("test_us_bucket{le=\"0\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_us_bucket{le=\"3\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("test_us_bucket{le=\"7\"} 4\n"), std::string::npos);
+    EXPECT_NE(text.find("test_us_bucket{le=\"+Inf\"} 5\n"), std::string::npos);
+    EXPECT_NE(text.find("test_us_count 5\n"), std::string::npos);
+    EXPECT_NE(
+        text.find(std::format("test_us_sum {}\n", 13 + (uint64_t{1} << 60))),
+        std::string::npos);
+}
+
+TEST(MetricsServer, serves_registry)
+{
+    auto const path =
+        std::filesystem::temp_directory_path() / "monad_metrics_test.sock";
+    MetricsRegistry registry;
+    registry.counter("test_total", "A counter").add(42);
+    MetricsServer const server{registry, path};
+
+    int const fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(fd, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    ASSERT_EQ(connect(fd, (sockaddr *)&addr, sizeof(addr)), 0);
+    std::string_view const request =
+        "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    ASSERT_EQ(
+        send(fd, request.data(), request.size(), 0),
+        static_cast<ssize_t>(request.size()));
+
+    std::string response;
+    std::array<char, 1024> buf;
+    ssize_t res;
+    while ((res = recv(fd, buf.data(), buf.size(), 0)) > 0) {
+        response.append(buf.data(), static_cast<size_t>(res));
+    }
+    close(fd);
+    EXPECT_TRUE(response.starts_with("HTTP/1.0 200 OK\r\n"));
+    EXPECT_TRUE(response.ends_with("\r\n\r\n" + registry.to_prometheus()));
+    EXPECT_NE(response.find("test_total 42\n"), std::string::npos);
+}
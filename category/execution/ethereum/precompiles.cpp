@@ -28,6 +28,7 @@
 #include <evmc/helpers.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <utility>
@@ -61,55 +62,89 @@ static std::optional<uint64_t> fmap_optional(byte_string_view const a)
     return f(a);
 }
 
+// Ethereum precompiles occupy the low addresses 0x01 to 0x11
+inline constexpr size_t PRECOMPILE_TABLE_SIZE = 0x12;
+
+inline constexpr uint16_t P256_VERIFY_INDEX = 0x0100;
+
 template <Traits traits>
-std::optional<PrecompiledContract> resolve_precompile(Address const &address)
+consteval std::array<PrecompiledContract, PRECOMPILE_TABLE_SIZE>
+make_precompile_table()
 {
-#define CASE(addr, gas_cost, execute)                                          \
-    do {                                                                       \
-        if (MONAD_UNLIKELY(Address{(addr)} == address)) {                      \
-            return PrecompiledContract{fmap_optional<(gas_cost)>, (execute)};  \
-        }                                                                      \
-    }                                                                          \
-    while (false)
-
-    // Ethereum precompiles
-    CASE(0x01, ecrecover_gas_cost<traits>, ecrecover_execute);
-    CASE(0x02, sha256_gas_cost<traits>, sha256_execute);
-    CASE(0x03, ripemd160_gas_cost<traits>, ripemd160_execute);
-    CASE(0x04, identity_gas_cost, identity_execute);
+    std::array<PrecompiledContract, PRECOMPILE_TABLE_SIZE> table{};
+
+#define ENTRY(addr, gas_cost, execute)                                         \
+    table[(addr)] = PrecompiledContract{fmap_optional<(gas_cost)>, (execute)}
+
+    ENTRY(0x01, ecrecover_gas_cost<traits>, ecrecover_execute);
+    ENTRY(0x02, sha256_gas_cost<traits>, sha256_execute);
+    ENTRY(0x03, ripemd160_gas_cost<traits>, ripemd160_execute);
+    ENTRY(0x04, identity_gas_cost, identity_execute);
 
     if constexpr (traits::evm_rev() >= EVMC_BYZANTIUM) {
-        CASE(0x05, expmod_gas_cost<traits>, expmod_execute);
-        CASE(0x06, ecadd_gas_cost<traits>, ecadd_execute);
-        CASE(0x07, ecmul_gas_cost<traits>, ecmul_execute);
-        CASE(0x08, snarkv_gas_cost<traits>, snarkv_execute);
+        ENTRY(0x05, expmod_gas_cost<traits>, expmod_execute);
+        ENTRY(0x06, ecadd_gas_cost<traits>, ecadd_execute);
+        ENTRY(0x07, ecmul_gas_cost<traits>, ecmul_execute);
+        ENTRY(0x08, snarkv_gas_cost<traits>, snarkv_execute);
     }
 
     if constexpr (traits::evm_rev() >= EVMC_ISTANBUL) {
-        CASE(0x09, blake2bf_gas_cost<traits>, blake2bf_execute);
+        ENTRY(0x09, blake2bf_gas_cost<traits>, blake2bf_execute);
     }
 
     if constexpr (traits::evm_rev() >= EVMC_CANCUN) {
-        CASE(0x0A, point_evaluation_gas_cost<traits>, point_evaluation_execute);
+        ENTRY(
+            0x0A, point_evaluation_gas_cost<traits>, point_evaluation_execute);
     }
 
     if constexpr (traits::evm_rev() >= EVMC_PRAGUE) {
-        CASE(0x0B, bls12_g1_add_gas_cost, bls12_g1_add_execute);
-        CASE(0x0C, bls12_g1_msm_gas_cost, bls12_g1_msm_execute);
-        CASE(0x0D, bls12_g2_add_gas_cost, bls12_g2_add_execute);
-        CASE(0x0E, bls12_g2_msm_gas_cost, bls12_g2_msm_execute);
-        CASE(0x0F, bls12_pairing_check_gas_cost, bls12_pairing_check_execute);
-        CASE(0x10, bls12_map_fp_to_g1_gas_cost, bls12_map_fp_to_g1_execute);
-        CASE(0x11, bls12_map_fp2_to_g2_gas_cost, bls12_map_fp2_to_g2_execute);
+        ENTRY(0x0B, bls12_g1_add_gas_cost, bls12_g1_add_execute);
+        ENTRY(0x0C, bls12_g1_msm_gas_cost, bls12_g1_msm_execute);
+        ENTRY(0x0D, bls12_g2_add_gas_cost, bls12_g2_add_execute);
+        ENTRY(0x0E, bls12_g2_msm_gas_cost, bls12_g2_msm_execute);
+        ENTRY(0x0F, bls12_pairing_check_gas_cost, bls12_pairing_check_execute);
+        ENTRY(0x10, bls12_map_fp_to_g1_gas_cost, bls12_map_fp_to_g1_execute);
+        ENTRY(0x11, bls12_map_fp2_to_g2_gas_cost, bls12_map_fp2_to_g2_execute);
+    }
+
+#undef ENTRY
+
+    return table;
+}
+
+template <Traits traits>
+struct PrecompileTable
+{
+    alignas(64) static constexpr std::array<
+        PrecompiledContract, PRECOMPILE_TABLE_SIZE> entries =
+        make_precompile_table<traits>();
+};
+
+template <Traits traits>
+std::optional<PrecompiledContract> resolve_precompile(Address const &address)
+{
+    auto const index = precompile_index(address);
+    if (MONAD_LIKELY(!index.has_value())) {
+        return std::nullopt;
+    }
+
+    if (*index < PRECOMPILE_TABLE_SIZE) {
+        PrecompiledContract const &entry =
+            PrecompileTable<traits>::entries[*index];
+        if (entry.execute_func == nullptr) {
+            return std::nullopt;
+        }
+        return entry;
     }
 
     // Rollup precompiles
     if constexpr (traits::eip_7951_active()) {
-        CASE(0x0100, p256_verify_gas_cost, p256_verify_execute);
+        if (*index == P256_VERIFY_INDEX) {
+            return PrecompiledContract{
+                fmap_optional<p256_verify_gas_cost>, p256_verify_execute};
+        }
     }
 
-#undef CASE
-
     return std::nullopt;
 }
 
@@ -25,6 +25,8 @@
 #include <evmc/evmc.h>
 #include <evmc/evmc.hpp>
 
+#include <cstdint>
+#include <cstring>
 #include <optional>
 
 MONAD_NAMESPACE_BEGIN
@@ -33,6 +35,23 @@ bool init_trusted_setup();
 
 inline constexpr Address ripemd_address{3};
 
+// Precompiles live at addresses whose leading bytes are all zero. Returns
+// the low two bytes of such an address, so that a precompile is resolved
+// with one compare and a table index rather than a compare per precompile
+inline std::optional<uint16_t> precompile_index(Address const &address)
+{
+    uint64_t hi;
+    uint64_t mid;
+    uint16_t top;
+    std::memcpy(&hi, address.bytes, sizeof(hi));
+    std::memcpy(&mid, address.bytes + 8, sizeof(mid));
+    std::memcpy(&top, address.bytes + 16, sizeof(top));
+    if ((hi | mid | top) != 0) {
+        return std::nullopt;
+    }
+    return static_cast<uint16_t>((address.bytes[18] << 8) | address.bytes[19]);
+}
+
 template <Traits traits>
 bool is_eth_precompile(Address const &);
 
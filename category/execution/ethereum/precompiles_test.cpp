@@ -669,3 +669,24 @@ TYPED_TEST(TraitsTest, p256_verify)
             "p256_verify", "p256Verify.json", 0x0100_address);
     }
 }
+
+TEST(Precompiles, precompile_index)
+{
+    EXPECT_EQ(precompile_index(0x01_address), 0x01);
+    EXPECT_EQ(precompile_index(0x0100_address), 0x0100);
+    EXPECT_EQ(precompile_index(0xffff_address), 0xffff);
+    EXPECT_FALSE(precompile_index(0x010000_address).has_value());
+    EXPECT_FALSE(
+        precompile_index(0x0100000000000000000000000000000000000001_address)
+            .has_value());
+}
+
+TYPED_TEST(TraitsTest, not_precompile)
+{
+    using traits = typename TestFixture::Trait;
+    EXPECT_FALSE(is_precompile<traits>(0x00_address));
+    EXPECT_FALSE(is_precompile<traits>(0x12_address));
+    EXPECT_FALSE(is_precompile<traits>(0x0101_address));
+    EXPECT_FALSE(is_precompile<traits>(
+        0x0100000000000000000000000000000000000001_address));
+}
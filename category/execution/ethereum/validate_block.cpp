@@ -57,9 +57,7 @@ Receipt::Bloom compute_bloom(std::vector<Receipt> const &receipts)
 {
     Receipt::Bloom bloom{};
     for (auto const &receipt : receipts) {
-        for (unsigned i = 0; i < bloom.size(); ++i) {
-            bloom[i] |= receipt.bloom[i];
-        }
+        accumulate_bloom(bloom, receipt.bloom);
     }
     return bloom;
 }
@@ -32,37 +32,37 @@ Result<Receipt> dispatch_transaction(
     trace::StateTracer &state_tracer,
     RevertTransactionFn const &revert_transaction)
 {
-    if (traits::monad_rev() >= MONAD_FOUR && sender == SYSTEM_SENDER) {
-        // System transactions is a concept used in Monad for consensus to
-        // communicate state changes to execution this code handles these in a
-        // separate executor.
-        return ExecuteSystemTransaction<traits>{
-            chain,
-            i,
-            transaction,
-            sender,
-            header,
-            block_state,
-            block_metrics,
-            prev,
-            call_tracer}();
-    }
-    else {
-        return ExecuteTransaction<traits>{
-            chain,
-            i,
-            transaction,
-            sender,
-            authorities,
-            header,
-            block_hash_buffer,
-            block_state,
-            block_metrics,
-            prev,
-            call_tracer,
-            state_tracer,
-            revert_transaction}();
+    if constexpr (traits::monad_rev() >= MONAD_FOUR) {
+        if (sender == SYSTEM_SENDER) {
+            // System transactions is a concept used in Monad for consensus to
+            // communicate state changes to execution this code handles these
+            // in a separate executor.
+            return ExecuteSystemTransaction<traits>{
+                chain,
+                i,
+                transaction,
+                sender,
+                header,
+                block_state,
+                block_metrics,
+                prev,
+                call_tracer}();
+        }
     }
+    return ExecuteTransaction<traits>{
+        chain,
+        i,
+        transaction,
+        sender,
+        authorities,
+        header,
+        block_hash_buffer,
+        block_state,
+        block_metrics,
+        prev,
+        call_tracer,
+        state_tracer,
+        revert_transaction}();
 }
 
 EXPLICIT_MONAD_TRAITS(dispatch_transaction)
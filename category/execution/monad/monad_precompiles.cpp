@@ -13,6 +13,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <category/core/likely.h>
 #include <category/execution/ethereum/chain/chain.hpp>
 #include <category/execution/ethereum/state3/state.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
@@ -76,6 +77,9 @@ bool is_precompile(Address const &address)
     // Note that if new Monad-specific precompiles are added, identifying them
     // as a precompile should be gated behind the revision they were activated
     // in.
+    if (MONAD_LIKELY(!precompile_index(address).has_value())) {
+        return false;
+    }
     return is_eth_precompile<traits>(address) ||
            (address == staking::STAKING_CA);
 }
@@ -86,6 +90,9 @@ template <Traits traits>
 std::optional<evmc::Result> check_call_precompile(
     State &state, CallTracerBase &call_tracer, evmc_message const &msg)
 {
+    if (MONAD_LIKELY(!precompile_index(msg.code_address).has_value())) {
+        return std::nullopt;
+    }
     if (auto maybe_result = check_call_eth_precompile<traits>(msg)) {
         return maybe_result;
     }
@@ -42,11 +42,20 @@
 #include <optional>
 #include <ranges>
 
-unsigned monad_default_max_reserve_balance_mon(enum monad_revision)
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+constexpr unsigned default_max_reserve_balance_mon(monad_revision)
 {
     return 10;
 }
 
+MONAD_ANONYMOUS_NAMESPACE_END
+
+unsigned monad_default_max_reserve_balance_mon(enum monad_revision const rev)
+{
+    return default_max_reserve_balance_mon(rev);
+}
+
 MONAD_ANONYMOUS_NAMESPACE_BEGIN
 
 template <Traits traits>
@@ -185,9 +194,10 @@ uint256_t get_max_reserve(Address const &)
 {
     // TODO: implement precompile (support reading from orig)
     constexpr uint256_t WEI_PER_MON{1000000000000000000};
-    return uint256_t{
-               monad_default_max_reserve_balance_mon(traits::monad_rev())} *
-           WEI_PER_MON;
+    constexpr uint256_t max_reserve =
+        uint256_t{default_max_reserve_balance_mon(traits::monad_rev())} *
+        WEI_PER_MON;
+    return max_reserve;
 }
 
 EXPLICIT_MONAD_TRAITS(get_max_reserve);
@@ -13,6 +13,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <category/core/assert.h>
 #include <category/core/config.hpp>
 #include <category/core/likely.h>
 #include <category/execution/ethereum/state3/state.hpp>
@@ -20,6 +21,9 @@
 #include <category/execution/ethereum/validate_transaction.hpp>
 #include <category/execution/monad/system_sender.hpp>
 #include <category/execution/monad/validate_monad_transaction.hpp>
+#include <category/vm/evm/explicit_traits.hpp>
+#include <category/vm/evm/switch_traits.hpp>
+#include <category/vm/evm/traits.hpp>
 
 #include <boost/outcome/success_failure.hpp>
 
@@ -28,21 +32,21 @@
 
 MONAD_NAMESPACE_BEGIN
 
+template <Traits traits>
 Result<void> validate_monad_transaction(
-    monad_revision const monad_rev, evmc_revision const rev,
     Transaction const &tx, Address const &sender, State &state,
     uint256_t const &base_fee_per_gas,
     std::span<std::optional<Address> const> const authorities)
 {
-    auto res = ::monad::validate_transaction(rev, tx, sender, state);
-    if (MONAD_LIKELY(monad_rev >= MONAD_FOUR)) {
+    auto res = ::monad::validate_transaction<traits>(tx, sender, state);
+    if constexpr (traits::monad_rev() >= MONAD_FOUR) {
         if (res.has_error() &&
             res.error() != TransactionError::InsufficientBalance) {
             return res;
         }
 
         uint256_t const gas_fee =
-            uint256_t{tx.gas_limit} * gas_price(rev, tx, base_fee_per_gas);
+            uint256_t{tx.gas_limit} * gas_price<traits>(tx, base_fee_per_gas);
         if (MONAD_UNLIKELY(state.get_balance(sender) < gas_fee)) {
             return MonadTransactionError::InsufficientBalanceForFee;
         }
@@ -50,15 +54,29 @@ Result<void> validate_monad_transaction(
         if (MONAD_UNLIKELY(std::ranges::contains(authorities, SYSTEM_SENDER))) {
             return MonadTransactionError::SystemTransactionSenderIsAuthority;
         }
-    }
-    else if (monad_rev >= MONAD_ZERO) {
-        return res;
+
+        return outcome::success();
     }
     else {
-        MONAD_ABORT("invalid revision");
+        return res;
     }
+}
 
-    return outcome::success();
+EXPLICIT_MONAD_TRAITS(validate_monad_transaction);
+
+Result<void> validate_monad_transaction(
+    monad_revision const rev, Transaction const &tx, Address const &sender,
+    State &state, uint256_t const &base_fee_per_gas,
+    std::span<std::optional<Address> const> const authorities)
+{
+    SWITCH_MONAD_TRAITS(
+        validate_monad_transaction,
+        tx,
+        sender,
+        state,
+        base_fee_per_gas,
+        authorities);
+    MONAD_ABORT("invalid revision");
 }
 
 MONAD_NAMESPACE_END
@@ -20,6 +20,7 @@
 #include <category/core/result.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/vm/evm/monad/revision.h>
+#include <category/vm/evm/traits.hpp>
 
 #include <evmc/evmc.h>
 
@@ -49,8 +50,14 @@ enum class MonadTransactionError
     SystemTransactionSenderIsAuthority,
 };
 
+template <Traits traits>
 Result<void> validate_monad_transaction(
-    monad_revision, evmc_revision, Transaction const &, Address const &sender,
+    Transaction const &, Address const &sender, State &,
+    uint256_t const &base_fee_per_gas,
+    std::span<std::optional<Address> const> authorities);
+
+Result<void> validate_monad_transaction(
+    monad_revision, Transaction const &, Address const &sender,
     State &, uint256_t const &base_fee_per_gas,
     std::span<std::optional<Address> const> authorities);
 
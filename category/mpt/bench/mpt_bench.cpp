@@ -20,6 +20,7 @@
 #include <category/mpt/db.hpp>
 #include <category/mpt/ondisk_db_config.hpp>
 #include <category/mpt/update.hpp>
+#include <category/mpt/update_batch.hpp>
 #include <category/mpt/util.hpp>
 #include <category/mpt/test/test_fixtures_base.hpp>
 
@@ -27,6 +28,8 @@
 #include <quill/Quill.h>
 
 #include <chrono>
+#include <ctime>
+#include <deque>
 #include <filesystem>
 #include <iostream>
 #include <vector>
@@ -60,6 +63,13 @@ static uint64_t get_dir_size(const std::filesystem::path& path) {
     return size;
 }
 
+// CPU time of the whole process, including the threads the upsert fans out to
+static double process_cpu_seconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
 int main(int argc, char** argv) {
     int nAccounts = 100;
     int nSlots = 1000;
@@ -68,6 +78,7 @@ int main(int argc, char** argv) {
     int fileSizeGB = 2;
     std::vector<std::filesystem::path> dbPathList;
     bool clearDB = true;
+    bool useBatch = false;
 
     CLI::App app{"MonadDB MPT Benchmark"};
     app.add_option("-n", nAccounts, "Number of accounts to create")->default_val(100);
@@ -77,6 +88,7 @@ int main(int argc, char** argv) {
     app.add_option("--size", fileSizeGB, "File size in GB")->default_val(2);
     app.add_option("--db", dbPathList, "Path to database file")->required();
     app.add_flag("--clear", clearDB, "Clear database before starting")->default_val(true);
+    app.add_flag("--batch", useBatch, "Build blocks as sorted UpdateBatches instead of UpdateLists")->default_val(false);
 
     try {
         app.parse(argc, argv);
@@ -130,6 +142,8 @@ int main(int argc, char** argv) {
     auto phase1Start = std::chrono::steady_clock::now();
     int64_t totalSlotsCreated = 0;
     uint64_t currentVersion = 0;
+    double buildCpuSec = 0;
+    double upsertCpuSec = 0;
 
     for (int i = 0; i < nAccounts; i += kCommit) {
         int batchEnd = std::min(i + kCommit, nAccounts);
@@ -170,9 +184,20 @@ int main(int argc, char** argv) {
         std::list<monad::mpt::Update> accountUpdates;
         std::list<monad::mpt::UpdateList> slotUpdateLists;
         std::list<std::list<monad::mpt::Update>> slotUpdatesPerAccount;
+        std::deque<monad::mpt::UpdateBatch> slotBatches;
+        monad::mpt::UpdateBatch accountBatch;
         monad::mpt::UpdateList batchUpdateList;
 
+        double const buildCpuStart = process_cpu_seconds();
         for (auto& [addr, acc] : batchData) {
+            if (useBatch) {
+                auto& slotBatch = slotBatches.emplace_back();
+                for (auto const& [sKey, sVal] : acc.slots) {
+                    slotBatch.push_back(monad::mpt::make_update(sKey, sVal));
+                }
+                accountBatch.push_back(monad::mpt::make_update(addr, acc.value, false, slotBatch.finalize()));
+                continue;
+            }
             slotUpdateLists.emplace_back();
             auto& currentSlotUpdateList = slotUpdateLists.back();
             slotUpdatesPerAccount.emplace_back();
@@ -187,9 +212,15 @@ int main(int argc, char** argv) {
             accountUpdates.back().next = std::move(currentSlotUpdateList);
             batchUpdateList.push_front(accountUpdates.back());
         }
+        if (useBatch) {
+            batchUpdateList = accountBatch.finalize();
+        }
+        buildCpuSec += process_cpu_seconds() - buildCpuStart;
 
         currentVersion++;
+        double const upsertCpuStart = process_cpu_seconds();
         root = db.upsert(std::move(root), std::move(batchUpdateList), currentVersion);
+        upsertCpuSec += process_cpu_seconds() - upsertCpuStart;
         
         std::cout << "[Batch " << currentVersion << "] Disk: " 
                   << std::fixed << std::setprecision(2) << (double)get_dir_size(dbPath) / 1024 / 1024 << " MB" << std::endl;
@@ -199,6 +230,9 @@ int main(int argc, char** argv) {
     double p1Sec = std::chrono::duration<double>(p1Elapsed).count();
     std::cout << "\nCreation finished in " << p1Sec << "s." << std::endl;
     std::cout << "Total Slots Created: " << totalSlotsCreated << " | Throughput: " << (double)totalSlotsCreated / p1Sec << " slots/s" << std::endl;
+    std::cout << "Update build CPU: " << buildCpuSec << "s | Upsert CPU: " << upsertCpuSec << "s (" << (useBatch ? "UpdateBatch" : "UpdateList") << ")" << std::endl;
+    buildCpuSec = 0;
+    upsertCpuSec = 0;
 
     // Phase 2: Modification
     mModify = std::min(mModify, nAccounts);
@@ -239,9 +273,20 @@ int main(int argc, char** argv) {
         std::list<monad::mpt::Update> accountUpdates;
         std::list<monad::mpt::UpdateList> slotUpdateLists;
         std::list<std::list<monad::mpt::Update>> slotUpdatesPerAccount;
+        std::deque<monad::mpt::UpdateBatch> slotBatches;
+        monad::mpt::UpdateBatch accountBatch;
         monad::mpt::UpdateList batchUpdateList;
 
+        double const buildCpuStart = process_cpu_seconds();
         for (auto& [addr, slots] : batchModData) {
+            if (useBatch) {
+                auto& slotBatch = slotBatches.emplace_back();
+                for (auto const& [sKey, sVal] : slots) {
+                    slotBatch.push_back(monad::mpt::make_update(sKey, sVal));
+                }
+                accountBatch.push_back(monad::mpt::make_update(addr, slotBatch.finalize()));
+                continue;
+            }
             slotUpdateLists.emplace_back();
             auto& currentSlotUpdateList = slotUpdateLists.back();
             slotUpdatesPerAccount.emplace_back();
@@ -255,9 +300,15 @@ int main(int argc, char** argv) {
             accountUpdates.push_back(monad::mpt::make_update(addr, std::move(currentSlotUpdateList)));
             batchUpdateList.push_front(accountUpdates.back());
         }
+        if (useBatch) {
+            batchUpdateList = accountBatch.finalize();
+        }
+        buildCpuSec += process_cpu_seconds() - buildCpuStart;
 
         currentVersion++;
+        double const upsertCpuStart = process_cpu_seconds();
         root = db.upsert(std::move(root), std::move(batchUpdateList), currentVersion);
+        upsertCpuSec += process_cpu_seconds() - upsertCpuStart;
         std::cout << "[Mod Batch " << currentVersion << "] committed. Disk: " << (double)get_dir_size(dbPath) / 1024 / 1024 << " MB" << std::endl;
     }
 
@@ -265,6 +316,7 @@ int main(int argc, char** argv) {
     double p2Sec = std::chrono::duration<double>(p2Elapsed).count();
     std::cout << "\nModification finished in " << p2Sec << "s." << std::endl;
     std::cout << "Total Slots Modified: " << totalSlotsModified << " | Throughput: " << (double)totalSlotsModified / p2Sec << " slots/s" << std::endl;
+    std::cout << "Update build CPU: " << buildCpuSec << "s | Upsert CPU: " << upsertCpuSec << "s (" << (useBatch ? "UpdateBatch" : "UpdateList") << ")" << std::endl;
 
     std::cout << "\n--- Final Report ---" << std::endl;
     std::cout << "Database Path: " << dbPath << std::endl;
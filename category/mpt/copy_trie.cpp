@@ -36,7 +36,7 @@ MONAD_MPT_NAMESPACE_BEGIN
 Node::SharedPtr create_node_add_new_branch(
     UpdateAuxImpl &aux, Node *const node, unsigned char const new_branch,
     Node::SharedPtr new_child, uint64_t const new_version,
-    std::optional<byte_string_view> opt_value)
+    std::optional<byte_string_view> opt_value, bool const write_new_child)
 {
     uint16_t const mask =
         static_cast<uint16_t>(node->mask | (1u << new_branch));
@@ -47,7 +47,7 @@ Node::SharedPtr create_node_add_new_branch(
             child.branch = (unsigned char)i;
             child.ptr = std::move(new_child);
             child.subtrie_min_version = calc_min_version(*child.ptr);
-            if (aux.is_on_disk()) {
+            if (aux.is_on_disk() && write_new_child) {
                 child.offset =
                     async_write_node_set_spare(aux, *child.ptr, true);
                 std::tie(child.min_offset_fast, child.min_offset_slow) =
@@ -83,7 +83,8 @@ Node::SharedPtr create_node_add_new_branch(
 Node::SharedPtr create_node_with_two_children(
     UpdateAuxImpl &aux, NibblesView const path, unsigned char const branch0,
     Node::SharedPtr child0, unsigned char const branch1, Node::SharedPtr child1,
-    uint64_t const new_version, std::optional<byte_string_view> opt_value)
+    uint64_t const new_version, std::optional<byte_string_view> opt_value,
+    bool const write_child0)
 {
     // mismatch: split node's path: turn node to a branch node with two
     // children
@@ -96,7 +97,7 @@ Node::SharedPtr create_node_with_two_children(
         child.ptr = std::move(child0);
         child.subtrie_min_version = calc_min_version(*child.ptr);
         child.branch = branch0;
-        if (aux.is_on_disk()) {
+        if (aux.is_on_disk() && write_child0) {
             child.offset = async_write_node_set_spare(aux, *child.ptr, true);
             std::tie(child.min_offset_fast, child.min_offset_slow) =
                 calc_min_offsets(*child.ptr);
@@ -125,7 +126,7 @@ Node::SharedPtr create_node_with_two_children(
 Node::SharedPtr copy_trie_impl(
     UpdateAuxImpl &aux, Node::SharedPtr src_root, NibblesView const src_prefix,
     Node::SharedPtr dest_root, NibblesView const dest_prefix,
-    uint64_t const dest_version)
+    uint64_t const dest_version, bool const write_dest_path)
 {
     auto [src_cursor, res] =
         find_blocking(aux, src_root, src_prefix, aux.db_history_max_version());
@@ -140,7 +141,7 @@ Node::SharedPtr copy_trie_impl(
         ChildData child{
             .ptr = std::move(new_node), .branch = dest_prefix.get(0)};
         child.subtrie_min_version = calc_min_version(*child.ptr);
-        if (aux.is_on_disk()) {
+        if (aux.is_on_disk() && write_dest_path) {
             child.offset = async_write_node_set_spare(aux, *child.ptr, true);
             std::tie(child.min_offset_fast, child.min_offset_slow) =
                 calc_min_offsets(
@@ -209,7 +210,8 @@ Node::SharedPtr copy_trie_impl(
                 dest_version,
                 node.get() == dest_root.get()
                     ? std::make_optional(src_root->value())
-                    : std::nullopt);
+                    : std::nullopt,
+                write_dest_path);
             break;
         }
         // end of node path
@@ -245,7 +247,8 @@ Node::SharedPtr copy_trie_impl(
             dest_version,
             node.get() == dest_root.get()
                 ? std::make_optional(src_root->value())
-                : std::nullopt);
+                : std::nullopt,
+            write_dest_path);
         break;
     }
 
@@ -271,6 +274,12 @@ Node::SharedPtr copy_trie_impl(
         // serialize nodes of insert path up until root (excludes root)
         while (!parents_and_indexes.empty()) {
             auto const &[p, i] = parents_and_indexes.top();
+            if (!write_dest_path) {
+                // left in memory for the upsert that recreates the path
+                p->set_fnext(i, INVALID_OFFSET);
+                parents_and_indexes.pop();
+                continue;
+            }
             auto &node = *p->next(i);
             p->set_fnext(i, async_write_node_set_spare(aux, node, true));
             auto const [min_offset_fast, min_offset_slow] =
@@ -288,8 +297,10 @@ Node::SharedPtr copy_trie_impl(
 Node::SharedPtr copy_trie_to_dest(
     UpdateAuxImpl &aux, Node::SharedPtr src_root, NibblesView const src_prefix,
     Node::SharedPtr dest_root, NibblesView const dest_prefix,
-    uint64_t const dest_version, bool const write_root)
+    uint64_t const dest_version, bool const write_root,
+    bool const defer_dest_path_write)
 {
+    MONAD_ASSERT(!(write_root && defer_dest_path_write));
     auto impl = [&]() -> Node::SharedPtr {
         dest_root = copy_trie_impl(
             aux,
@@ -297,7 +308,8 @@ Node::SharedPtr copy_trie_to_dest(
             src_prefix,
             std::move(dest_root),
             dest_prefix,
-            dest_version);
+            dest_version,
+            !defer_dest_path_write);
         if (aux.is_on_disk() && write_root) {
             write_new_root_node(aux, *dest_root, dest_version);
             MONAD_ASSERT(aux.db_history_max_version() >= dest_version);
@@ -83,7 +83,8 @@ struct Db::Impl
         bool can_write_to_fast, bool write_root) = 0;
     virtual Node::SharedPtr copy_trie_fiber_blocking(
         Node::SharedPtr src_root, NibblesView src, Node::SharedPtr dest_root,
-        NibblesView dest, uint64_t dest_version, bool write_root = true) = 0;
+        NibblesView dest, uint64_t dest_version, bool write_root = true,
+        bool defer_dest_path_write = false) = 0;
     virtual find_cursor_result_type find_fiber_blocking(
         NodeCursor const &root, NibblesView const &key, uint64_t version) = 0;
     virtual size_t prefetch_fiber_blocking(Node::SharedPtr const &) = 0;
@@ -222,7 +223,7 @@ public:
 
     virtual Node::SharedPtr copy_trie_fiber_blocking(
         Node::SharedPtr, NibblesView, Node::SharedPtr, NibblesView, uint64_t,
-        bool) override
+        bool, bool) override
     {
         MONAD_ABORT();
     }
@@ -280,7 +281,7 @@ public:
 
     virtual Node::SharedPtr copy_trie_fiber_blocking(
         Node::SharedPtr, NibblesView, Node::SharedPtr, NibblesView, uint64_t,
-        bool) override
+        bool, bool) override
     {
         MONAD_ABORT();
     }
@@ -343,6 +344,7 @@ struct OnDiskWithWorkerThreadImpl
         NibblesView dest;
         uint64_t dest_version;
         bool write_root;
+        bool defer_dest_path_write;
     };
 
     struct FiberLoadAllFromBlockRequest
@@ -643,7 +645,8 @@ struct OnDiskWithWorkerThreadImpl
                             std::move(req->dest_root),
                             req->dest,
                             req->dest_version,
-                            req->write_root);
+                            req->write_root,
+                            req->defer_dest_path_write);
                         req->promise->set_value(std::move(root));
                     }
                     did_nothing = false;
@@ -929,7 +932,8 @@ public:
     virtual Node::SharedPtr copy_trie_fiber_blocking(
         Node::SharedPtr src_root, NibblesView const src_prefix,
         Node::SharedPtr dest_root, NibblesView const dest_prefix,
-        uint64_t const dest_version, bool const write_root = true) override
+        uint64_t const dest_version, bool const write_root = true,
+        bool const defer_dest_path_write = false) override
     {
         if (unflushed_version_ != INVALID_BLOCK_NUM &&
             unflushed_version_ != dest_version) {
@@ -951,7 +955,8 @@ public:
             .dest_root = std::move(dest_root),
             .dest = dest_prefix,
             .dest_version = dest_version,
-            .write_root = write_root});
+            .write_root = write_root,
+            .defer_dest_path_write = defer_dest_path_write});
         // promise is racily emptied after this point
         if (worker_->sleeping.load(std::memory_order_acquire)) {
             std::unique_lock const g(lock_);
@@ -1170,7 +1175,8 @@ Node::SharedPtr Db::upsert(
 Node::SharedPtr Db::copy_trie(
     Node::SharedPtr src_root, NibblesView const src_prefix,
     Node::SharedPtr dest_root, NibblesView const dest_prefix,
-    uint64_t const dest_version, bool const write_root)
+    uint64_t const dest_version, bool const write_root,
+    bool const defer_dest_path_write)
 {
     MONAD_ASSERT(impl_);
     return impl_->copy_trie_fiber_blocking(
@@ -1179,7 +1185,8 @@ Node::SharedPtr Db::copy_trie(
         std::move(dest_root),
         dest_prefix,
         dest_version,
-        write_root);
+        write_root,
+        defer_dest_path_write);
 }
 
 void Db::move_trie_version_forward(uint64_t const src, uint64_t const dest)
@@ -1332,6 +1339,21 @@ uint64_t Db::get_history_length() const
     return is_on_disk() ? impl_->aux().version_history_length() : 1;
 }
 
+uint64_t Db::get_history_erase_rate() const
+{
+    return is_on_disk() ? impl_->aux().history_erase_rate() : 0;
+}
+
+uint64_t Db::get_total_bytes_written() const
+{
+    return is_on_disk() ? impl_->aux().total_bytes_written() : 0;
+}
+
+uint64_t Db::get_total_bytes_compacted() const
+{
+    return is_on_disk() ? impl_->aux().total_bytes_compacted() : 0;
+}
+
 AsyncContext::AsyncContext(Db &db, size_t node_lru_max_mem)
     : aux(db.impl_->aux())
     , node_cache(node_lru_max_mem)
@@ -112,10 +112,18 @@ public:
 
     Node::SharedPtr load_root_for_version(uint64_t block_id) const;
 
+    // With `defer_dest_path_write`, the nodes the copy creates on the path
+    // to `dest_prefix` are left in memory and unwritten, with an invalid
+    // offset in their parent. The next upsert of `dest_version` on this root
+    // must update keys under `dest_prefix`, which recreates and writes that
+    // path. A node is never written while a child of it is unwritten, so a
+    // root write or an upsert elsewhere that would do so is an assertion
+    // failure. Requires `!write_root`.
     Node::SharedPtr copy_trie(
         Node::SharedPtr src_root, NibblesView src_prefix,
         Node::SharedPtr dest_root, NibblesView dest_prefix,
-        uint64_t dest_version, bool write_root = true);
+        uint64_t dest_version, bool write_root = true,
+        bool defer_dest_path_write = false);
 
     Node::SharedPtr upsert(
         Node::SharedPtr root, UpdateList, uint64_t block_id,
@@ -149,6 +157,13 @@ public:
     uint64_t get_latest_version() const;
     uint64_t get_earliest_version() const;
     uint64_t get_history_length() const;
+    // Versions erased by the last upsert to keep disk usage in band, not
+    // counting the one that rolls off with every new version
+    uint64_t get_history_erase_rate() const;
+    // Bytes written to disk by upserts since startup, and of those the bytes
+    // copied by compaction
+    uint64_t get_total_bytes_written() const;
+    uint64_t get_total_bytes_compacted() const;
     // This function moves trie from source to destination version in db
     // history. Only the RWDb can call this API for state sync purposes.
     void move_trie_version_forward(uint64_t src, uint64_t dest);
@@ -51,12 +51,29 @@ namespace detail
         unsigned compacted_bytes_in_slow{0}; // copied from slow to slow
         unsigned bytes_copied_slow_to_fast_for_slow{0};
 
+        unsigned total_compacted_bytes() const noexcept
+        {
+            return compacted_bytes_in_fast + compacted_bytes_in_slow +
+                   bytes_copied_slow_to_fast_for_slow;
+        }
+
         // expire stats
         unsigned nodes_updated_expire{0};
         unsigned nreads_expire{0};
+
+        // nested tries whose compacted nodes were written together, and the
+        // number of those nodes
+        unsigned compact_clusters{0};
+        unsigned compact_cluster_nodes{0};
 #else
         unsigned compacted_bytes_in_slow{0};
-        char padding[4];
+        // the same bytes as total_compacted_bytes() with stats collected
+        unsigned compacted_bytes{0};
+
+        unsigned total_compacted_bytes() const noexcept
+        {
+            return compacted_bytes;
+        }
 #endif
 
         void reset()
@@ -67,7 +84,7 @@ namespace detail
     };
 
 #ifdef MONAD_MPT_COLLECT_STATS
-    static_assert(sizeof(TrieUpdateCollectedStats) == 80);
+    static_assert(sizeof(TrieUpdateCollectedStats) == 88);
 #else
     static_assert(sizeof(TrieUpdateCollectedStats) == 8);
 #endif
@@ -56,6 +56,8 @@ namespace detail
         return ret.x[sizeof(v) - 1]; // last byte
     }
 #endif
+    inline uint64_t
+    db_copy_header(db_metadata *dest, db_metadata const *src);
     inline void
     db_copy(db_metadata *dest, db_metadata const *src, size_t bytes);
 
@@ -66,6 +68,8 @@ namespace detail
         static constexpr unsigned MAGIC_STRING_LEN = 8;
 
         friend class MONAD_MPT_NAMESPACE::UpdateAuxImpl;
+        friend inline uint64_t
+        db_copy_header(db_metadata *dest, db_metadata const *src);
         friend inline void
         db_copy(db_metadata *dest, db_metadata const *src, size_t bytes);
 
@@ -154,8 +158,47 @@ namespace detail
         bytes32_t latest_voted_block_id;
         bytes32_t latest_proposed_block_id;
 
+        // What this copy has written since its dirty bit was last raised, so
+        // a copy left dirty by a sudden exit can be healed from the other copy
+        // by replaying just these records rather than copying all of it. The
+        // scalar fields preceding `chunk_info` are always healed, so only
+        // chunk infos and root offset slots are recorded. Databases created
+        // before this existed have all bits set here, which reads as
+        // overflowed until the next write.
+        struct journal_t
+        {
+            static constexpr uint32_t CAPACITY = 255;
+
+            enum class kind : uint8_t
+            {
+                chunk_info = 1,
+                root_offset = 2
+            };
+
+            uint32_t count; // exceeds CAPACITY once overflowed
+            uint32_t unused0_;
+            uint64_t records[CAPACITY]; // kind in the top byte, index below
+
+            bool overflowed() const noexcept
+            {
+                return count > CAPACITY;
+            }
+
+            static kind kind_of(uint64_t const record) noexcept
+            {
+                return kind(record >> 56);
+            }
+
+            static uint64_t index_of(uint64_t const record) noexcept
+            {
+                return record & ((uint64_t(1) << 56) - 1);
+            }
+        } journal;
+
+        static_assert(sizeof(journal_t) == 2048);
+
         // padding for adding future atomics without requiring DB reset
-        uint8_t future_variables_unused[4032];
+        uint8_t future_variables_unused[4032 - sizeof(journal_t)];
 
         // used to know if the metadata was being
         // updated when the process suddenly exited
@@ -241,10 +284,17 @@ namespace detail
             {
                 db_metadata *parent;
 
+                // The dirty byte counts nested holders, so it only clears
+                // once the outermost one, which began with a consistent copy,
+                // is released. That is also where the journal restarts.
                 explicit holder_t(db_metadata *p)
                     : parent(p)
                 {
-                    parent->is_dirty().store(1, std::memory_order_release);
+                    if (parent->is_dirty().fetch_add(
+                            1, std::memory_order_acq_rel) == 0) {
+                        std::atomic_ref<uint32_t>(parent->journal.count)
+                            .store(0, std::memory_order_release);
+                    }
                 }
 
                 holder_t(holder_t const &) = delete;
@@ -258,7 +308,15 @@ namespace detail
                 ~holder_t()
                 {
                     if (parent != nullptr) {
-                        parent->is_dirty().store(0, std::memory_order_release);
+                        auto &dirty = parent->is_dirty();
+                        auto v = dirty.load(std::memory_order_relaxed);
+                        while (v != 0 &&
+                               !dirty.compare_exchange_weak(
+                                   v,
+                                   uint8_t(v - 1),
+                                   std::memory_order_release,
+                                   std::memory_order_relaxed)) {
+                        }
                     }
                 }
             };
@@ -347,10 +405,50 @@ namespace detail
             return &chunk_info[idx];
         }
 
+        // Must be called while holding dirty, before the write it records
+        void journal_(journal_t::kind const k, uint64_t const index) noexcept
+        {
+            MONAD_DEBUG_ASSERT(is_dirty().load(std::memory_order_relaxed));
+            MONAD_DEBUG_ASSERT(journal_t::index_of(index) == index);
+            std::atomic_ref<uint32_t> count(journal.count);
+            auto const n = count.load(std::memory_order_relaxed);
+            uint64_t const record = (uint64_t(k) << 56) | index;
+            if (n == 0 || n > journal_t::CAPACITY ||
+                journal.records[n - 1] != record) {
+                if (n < journal_t::CAPACITY) {
+                    journal.records[n] = record;
+                    count.store(n + 1, std::memory_order_release);
+                }
+                else if (n == journal_t::CAPACITY) {
+                    count.store(n + 1, std::memory_order_release);
+                }
+            }
+        }
+
+        void journal_root_offset_(uint64_t const version) noexcept
+        {
+            // The ring capacity is a power of two, so the slot survives
+            // truncating the version
+            journal_(
+                journal_t::kind::root_offset,
+                journal_t::index_of(version));
+        }
+
+        void journal_overflow_() noexcept
+        {
+            MONAD_DEBUG_ASSERT(is_dirty().load(std::memory_order_relaxed));
+            std::atomic_ref<uint32_t>(journal.count)
+                .store(journal_t::CAPACITY + 1, std::memory_order_release);
+        }
+
         void append_(id_pair &list, chunk_info_t *i) noexcept
         {
             // Insertion count is assigned to chunk_info_t *i atomically
             auto const g = hold_dirty();
+            journal_(journal_t::kind::chunk_info, i->index(this));
+            if (list.end != UINT32_MAX) {
+                journal_(journal_t::kind::chunk_info, list.end);
+            }
             chunk_info_t info;
             info.in_fast_list = (&list == &fast_list);
             info.in_slow_list = (&list == &slow_list);
@@ -395,6 +493,13 @@ namespace detail
                 return free_list;
             };
             auto const g = hold_dirty();
+            journal_(journal_t::kind::chunk_info, i->index(this));
+            if (i->prev_chunk_id != chunk_info_t::INVALID_CHUNK_ID) {
+                journal_(journal_t::kind::chunk_info, i->prev_chunk_id);
+            }
+            if (i->next_chunk_id != chunk_info_t::INVALID_CHUNK_ID) {
+                journal_(journal_t::kind::chunk_info, i->next_chunk_id);
+            }
             if (i->prev_chunk_id == chunk_info_t::INVALID_CHUNK_ID &&
                 i->next_chunk_id == chunk_info_t::INVALID_CHUNK_ID) {
                 id_pair &list = get_list();
@@ -503,27 +608,46 @@ namespace detail
         }
     }
 
-    /* A dirty bit setting memcpy implementation, so the dirty bit gets held
-    high during the memory copy.
+    /* The first half of db_copy(): copies everything but the chunk infos
+    into `dest`, which must be held dirty, and returns the next version to
+    store once they are copied too. Both the journal of `dest` and the one
+    copied over it read as overflowed, so a sudden exit before the chunk
+    infos are copied is healed by another full copy rather than by replaying
+    an empty journal over stale chunk infos.
     */
-    inline void db_copy(db_metadata *dest, db_metadata const *src, size_t bytes)
+    inline uint64_t db_copy_header(db_metadata *dest, db_metadata const *src)
     {
+        MONAD_ASSERT(dest->is_dirty().load(std::memory_order_acquire));
         alignas(db_metadata) std::byte buffer[sizeof(db_metadata)];
         memcpy(buffer, src, sizeof(db_metadata));
         auto *intr = start_lifetime_as<db_metadata>(buffer);
         MONAD_ASSERT(intr->is_dirty().load(std::memory_order_acquire) == false);
-        auto const g1 = intr->hold_dirty();
-        auto const g2 = dest->hold_dirty();
+        auto const g = intr->hold_dirty();
+        intr->journal_overflow_();
+        dest->journal_overflow_();
         dest->root_offsets.next_version_ = 0; // INVALID_BLOCK_NUM
         auto const old_next_version = intr->root_offsets.next_version_;
         intr->root_offsets.next_version_ = 0; // INVALID_BLOCK_NUM
         atomic_memcpy((void *)dest, buffer, sizeof(db_metadata));
+        return old_next_version;
+    }
+
+    /* A dirty bit setting memcpy implementation, so the dirty bit gets held
+    high during the memory copy.
+    */
+    inline void db_copy(db_metadata *dest, db_metadata const *src, size_t bytes)
+    {
+        auto const g = dest->hold_dirty();
+        auto const old_next_version = db_copy_header(dest, src);
         atomic_memcpy(
             ((std::byte *)dest) + sizeof(db_metadata),
             ((std::byte const *)src) + sizeof(db_metadata),
             bytes - sizeof(db_metadata));
         std::atomic_ref<uint64_t>(dest->root_offsets.next_version_)
             .store(old_next_version, std::memory_order_release);
+        // The copies now match, so the journal restarts empty
+        std::atomic_ref<uint32_t>(dest->journal.count)
+            .store(0, std::memory_order_release);
     };
 }
 
@@ -426,10 +426,12 @@ void ChildData::erase()
 {
     MONAD_ASSERT(!ptr);
     branch = INVALID_BRANCH;
+    defer_write = false;
 }
 
 void ChildData::finalize(
-    Node::SharedPtr node, Compute &compute, bool const cache)
+    Node::SharedPtr node, Compute &compute, bool const cache,
+    bool const defer)
 {
     MONAD_DEBUG_ASSERT(is_valid());
     ptr = std::move(node);
@@ -437,6 +439,7 @@ void ChildData::finalize(
     MONAD_DEBUG_ASSERT(length <= std::numeric_limits<uint8_t>::max());
     len = static_cast<uint8_t>(length);
     cache_node = cache;
+    defer_write = defer;
     subtrie_min_version = calc_min_version(*ptr);
 }
 
@@ -341,10 +341,12 @@ struct ChildData
     uint8_t branch{INVALID_BRANCH};
     uint8_t len{0};
     bool cache_node{true}; // attach ptr to parent if cache, free otherwise
+    bool defer_write{false}; // leave unwritten, the next upsert writes it
 
     bool is_valid() const;
     void erase();
-    void finalize(Node::SharedPtr, Compute &, bool cache);
+    void finalize(
+        Node::SharedPtr, Compute &, bool cache, bool defer_write = false);
     void copy_old_child(Node *old, unsigned i);
 };
 
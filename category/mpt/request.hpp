@@ -20,8 +20,11 @@
 #include <category/mpt/update.hpp>
 #include <category/mpt/util.hpp>
 
+#include <algorithm>
 #include <bit>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <optional>
 
 MONAD_MPT_NAMESPACE_BEGIN
@@ -85,6 +88,9 @@ struct Requests
     unsigned
     split_into_sublists(UpdateList &&updates, unsigned const prefix_index)
     {
+        if (!updates.empty() && updates.front().in_batch) {
+            return split_batch_into_sublists(std::move(updates), prefix_index);
+        }
         reset(prefix_index);
         unsigned n = 0;
         while (!updates.empty()) {
@@ -104,6 +110,48 @@ struct Requests
         }
         return n;
     }
+
+private:
+    // Same as above for a list finalized by an UpdateBatch, or a sublist of
+    // one: the updates are contiguous in memory, sorted by key and share
+    // their first `prefix_index` nibbles, so each sublist is a subrange found
+    // by binary search and moved with a constant time splice.
+    unsigned
+    split_batch_into_sublists(UpdateList &&updates, unsigned const prefix_index)
+    {
+        reset(prefix_index);
+        Update *first = &updates.front();
+        Update *const last = first + updates.size();
+        MONAD_DEBUG_ASSERT(
+            &*std::next(updates.begin(), std::ptrdiff_t(updates.size() - 1)) ==
+            last - 1);
+        if (prefix_index == first->key.nibble_size()) {
+            updates.pop_front();
+            opt_leaf = std::move(*first);
+            ++first;
+        }
+        unsigned n = 0;
+        while (first != last) {
+            MONAD_ASSERT(first->key.nibble_size() > prefix_index);
+            auto const branch = first->key.get(prefix_index);
+            Update *const end =
+                std::partition_point(first, last, [&](Update const &req) {
+                    return req.key.get(prefix_index) <= branch;
+                });
+            MONAD_DEBUG_ASSERT(sublists[branch].empty());
+            sublists[branch].splice_after(
+                sublists[branch].before_begin(),
+                updates,
+                updates.before_begin(),
+                UpdateList::s_iterator_to(*(end - 1)),
+                static_cast<size_t>(end - first));
+            mask |= uint16_t(1u << branch);
+            ++n;
+            first = end;
+        }
+        MONAD_DEBUG_ASSERT(updates.empty());
+        return n;
+    }
 };
 
 static_assert(sizeof(Requests) == 352);
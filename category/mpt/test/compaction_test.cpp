@@ -17,14 +17,21 @@
 #include "test_fixtures_gtest.hpp"
 
 #include <category/async/config.hpp>
+#include <category/core/byte_string.hpp>
+#include <category/core/keccak.h>
 #include <category/mpt/config.hpp>
 #include <category/mpt/node.hpp>
+#include <category/mpt/node_cursor.hpp>
 #include <category/mpt/trie.hpp>
 #include <category/mpt/update.hpp>
+#include <category/mpt/util.hpp>
 
 #include <category/core/test_util/gtest_signal_stacktrace_printer.hpp> // NOLINT
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <iostream>
 #include <ostream>
 #include <utility>
@@ -70,3 +77,122 @@ TEST_F(CompactionTest, first_chunk_is_compacted)
     // TODO DO COMPACTION
     // TODO CHECK POOL'S FIRST CHUNK WAS DEFINITELY RELEASED
 }
+
+namespace
+{
+    monad::byte_string hashed_key(uint64_t const n)
+    {
+        monad::byte_string key(32, 0);
+        keccak256((unsigned char const *)&n, 8, key.data());
+        return key;
+    }
+
+    struct NodeExtent
+    {
+        chunk_offset_t offset;
+        unsigned size;
+    };
+
+    void collect_subtrie_extents(
+        UpdateAuxImpl const &aux, Node &node, std::vector<NodeExtent> &out)
+    {
+        for (unsigned j = 0; j < node.number_of_children(); ++j) {
+            auto child = node.next(j);
+            if (!child) {
+                child = read_node_blocking(aux, node.fnext(j), 0);
+            }
+            ASSERT_TRUE(child);
+            out.push_back({node.fnext(j), child->get_disk_size()});
+            collect_subtrie_extents(aux, *child, out);
+        }
+    }
+}
+
+TEST_F(
+    monad::test::OnDiskMerkleTrieGTest, nested_tries_compacted_contiguously)
+{
+    constexpr uint64_t num_accounts = 64;
+    constexpr uint64_t num_slots = 8;
+    auto const value = hashed_key(~uint64_t{0});
+
+    // Every upsert adds one slot to the storage of every account, so the
+    // storage of an account is spread across all of the upserts
+    for (uint64_t slot = 0; slot < num_slots; ++slot) {
+        std::deque<Update> alloc;
+        std::deque<monad::byte_string> keys;
+        UpdateList accounts;
+        for (uint64_t i = 0; i < num_accounts; ++i) {
+            UpdateList storage;
+            storage.push_front(alloc.emplace_back(make_update(
+                keys.emplace_back(hashed_key((i << 32) | slot)), value)));
+            accounts.push_front(alloc.emplace_back(make_update(
+                keys.emplace_back(hashed_key(i)),
+                value,
+                false,
+                std::move(storage))));
+        }
+        this->root = upsert(
+            this->aux,
+            0,
+            *this->sm,
+            std::move(this->root),
+            std::move(accounts));
+    }
+    // Move the writer more than a compaction unit past the accounts
+    {
+        monad::byte_string const filler(128 * 1024, 0);
+        auto const filler_key = hashed_key(num_accounts);
+        UpdateList updates;
+        Update update = make_update(filler_key, filler);
+        updates.push_front(update);
+        this->root = upsert(
+            this->aux, 0, *this->sm, std::move(this->root), std::move(updates));
+    }
+
+    // Compact everything written so far, with nothing cached so the nested
+    // tries are read back in whatever order the reads complete
+    this->root =
+        read_node_blocking(this->aux, this->aux.get_latest_root_offset(), 0);
+    this->aux.compact_offset_fast = compact_virtual_chunk_offset_t{
+        this->aux.physical_to_virtual(
+            this->aux.node_writer_fast->sender().offset())};
+    this->root =
+        upsert(this->aux, 0, *this->sm, std::move(this->root), UpdateList{});
+    EXPECT_EQ(this->aux.stats.compact_clusters, num_accounts);
+
+    for (uint64_t i = 0; i < num_accounts; ++i) {
+        auto const account_key = hashed_key(i);
+        auto [account, res] =
+            find_blocking(this->aux, this->root, account_key, 0);
+        ASSERT_EQ(res, find_result::success);
+        for (uint64_t slot = 0; slot < num_slots; ++slot) {
+            auto const [leaf, slot_res] = find_blocking(
+                this->aux,
+                account,
+                hashed_key((i << 32) | slot),
+                0);
+            ASSERT_EQ(slot_res, find_result::success);
+            EXPECT_EQ(
+                (monad::byte_string_view{
+                    leaf.node->value_data(), leaf.node->value_len}),
+                value);
+        }
+
+        // The storage landed back to back
+        std::vector<NodeExtent> extents;
+        collect_subtrie_extents(this->aux, *account.node, extents);
+        ASSERT_FALSE(extents.empty());
+        std::sort(
+            extents.begin(),
+            extents.end(),
+            [](NodeExtent const &a, NodeExtent const &b) {
+                return a.offset.offset < b.offset.offset;
+            });
+        for (size_t n = 1; n < extents.size(); ++n) {
+            EXPECT_EQ(extents[n].offset.id, extents[0].offset.id);
+            EXPECT_EQ(
+                extents[n].offset.offset,
+                extents[n - 1].offset.offset + extents[n - 1].size);
+        }
+    }
+}
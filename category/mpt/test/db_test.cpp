@@ -46,6 +46,7 @@
 #include <boost/fiber/future/promise.hpp>
 #include <boost/fiber/operations.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -827,13 +828,6 @@ TEST(DbTest, history_length_adjustment_never_under_min)
     std::deque<Update> updates_alloc;
     auto const &large_value =
         bytes_alloc.emplace_back(monad::byte_string(8 * 1024, 0xf));
-    for (size_t i = 0; i < nkeys; ++i) {
-        updates_alloc.push_back(Update{
-            .key = bytes_alloc.emplace_back(keccak_int_to_string(i)),
-            .value = large_value,
-            .incarnation = false,
-            .next = UpdateList{}});
-    }
 
     // construct a read-only aux
     monad::async::storage_pool::creation_flags pool_options;
@@ -848,9 +842,17 @@ TEST(DbTest, history_length_adjustment_never_under_min)
     monad::async::AsyncIO io_ctx(pool, read_buffers);
     UpdateAux aux_reader{io_ctx};
 
+    // Every version inserts new keys, so that the state keeps growing however
+    // short the history gets
     auto batch_upsert_once = [&](uint64_t const version) {
         UpdateList ls;
-        for (auto &u : updates_alloc) {
+        for (size_t i = 0; i < nkeys; ++i) {
+            auto &u = updates_alloc.emplace_back(Update{
+                .key = bytes_alloc.emplace_back(
+                    keccak_int_to_string(version * nkeys + i)),
+                .value = large_value,
+                .incarnation = false,
+                .next = UpdateList{}});
             ls.push_front(u);
         }
         root = db.upsert(std::move(root), std::move(ls), version);
@@ -872,6 +874,63 @@ TEST(DbTest, history_length_adjustment_never_under_min)
     remove(dbname);
 }
 
+TEST(DbTest, history_shedding_stops_when_net_disk_usage_is_flat)
+{
+    auto const dbname = create_temp_file(4);
+    StateMachineAlwaysEmpty machine{};
+    OnDiskDbConfig config{
+        .compaction = true,
+        .sq_thread_cpu{std::nullopt},
+        .dbname_paths = {dbname}};
+    Db db{machine, config};
+    Node::SharedPtr root{};
+
+    constexpr unsigned nkeys = 1000;
+
+    // Every version rewrites the same keys, so disk usage only grows with
+    // the history
+    std::deque<monad::byte_string> bytes_alloc;
+    std::deque<Update> updates_alloc;
+    auto const &value =
+        bytes_alloc.emplace_back(monad::byte_string(2 * 1024, 0xf));
+    for (size_t i = 0; i < nkeys; ++i) {
+        updates_alloc.push_back(Update{
+            .key = bytes_alloc.emplace_back(keccak_int_to_string(i)),
+            .value = value,
+            .incarnation = false,
+            .next = UpdateList{}});
+    }
+    auto batch_upsert_once = [&](uint64_t const version) {
+        UpdateList ls;
+        for (auto &u : updates_alloc) {
+            ls.push_front(u);
+        }
+        root = db.upsert(std::move(root), std::move(ls), version);
+    };
+
+    uint64_t block_id = 0;
+    while (db.get_history_erase_rate() == 0) {
+        ASSERT_LT(block_id, 16384) << "history was never shed";
+        batch_upsert_once(block_id);
+        ++block_id;
+    }
+    // Shedding stops the history growing, which flattens disk usage
+    for (unsigned i = 0; i < 512; ++i) {
+        batch_upsert_once(block_id);
+        ++block_id;
+    }
+    auto const history_length = db.get_history_length();
+    for (unsigned i = 0; i < 128; ++i) {
+        batch_upsert_once(block_id);
+        ++block_id;
+        EXPECT_EQ(db.get_history_erase_rate(), 0);
+    }
+    EXPECT_EQ(db.get_history_length(), history_length);
+    EXPECT_GT(history_length, MIN_HISTORY_LENGTH);
+
+    remove(dbname);
+}
+
 TEST_F(OnDiskDbWithFileFixture, read_only_db_traverse_as_version_expire)
 {
     struct TraverseMachinePruneHistory final : public TraverseMachine
@@ -2070,6 +2129,70 @@ TEST_F(OnDiskDbWithFileFixture, copy_trie_to_different_version_modify_state)
     }
 }
 
+TEST_F(OnDiskDbWithFileFixture, copy_trie_without_path_write_then_reopen)
+{
+    std::deque<monad::byte_string> kv_alloc;
+    for (size_t i = 0; i < 4; ++i) {
+        kv_alloc.emplace_back(keccak_int_to_string(i));
+    }
+    auto const src_prefix = 0x0012_bytes;
+    auto const prefix0 = 0x0034_bytes;
+    auto const prefix1 = 0x0035_bytes;
+    uint64_t const block_id = 0;
+    root = upsert_updates_flat_list(
+        std::move(root),
+        db,
+        src_prefix,
+        block_id,
+        make_update(kv_alloc[0], kv_alloc[0]),
+        make_update(kv_alloc[1], kv_alloc[1]));
+
+    root = db.copy_trie(
+        db.load_root_for_version(block_id),
+        src_prefix,
+        db.load_root_for_version(block_id + 1),
+        prefix0,
+        block_id + 1);
+    // Splits the node at prefix0, leaving the new path to prefix1 unwritten
+    // until the upsert under prefix1 recreates it
+    root = db.copy_trie(
+        db.load_root_for_version(block_id),
+        src_prefix,
+        std::move(root),
+        prefix1,
+        block_id + 1,
+        false,
+        true);
+    root = upsert_updates_flat_list(
+        std::move(root),
+        db,
+        prefix1,
+        block_id + 1,
+        make_update(kv_alloc[2], kv_alloc[2]));
+    root.reset();
+
+    db.~Db();
+    config.append = true;
+    new (&db) Db(machine, config);
+
+    auto const reopened_root = db.load_root_for_version(block_id + 1);
+    ASSERT_TRUE(reopened_root);
+    for (auto const &prefix : {prefix0, prefix1}) {
+        for (size_t i = 0; i < 2; ++i) {
+            auto const res =
+                db_get(db, reopened_root, prefix + kv_alloc[i], block_id + 1);
+            ASSERT_TRUE(res.has_value());
+            EXPECT_EQ(res.value(), kv_alloc[i]);
+        }
+    }
+    auto const res =
+        db_get(db, reopened_root, prefix1 + kv_alloc[2], block_id + 1);
+    ASSERT_TRUE(res.has_value());
+    EXPECT_EQ(res.value(), kv_alloc[2]);
+    EXPECT_FALSE(
+        db_get(db, reopened_root, prefix0 + kv_alloc[2], block_id + 1));
+}
+
 TEST(DbTest, move_trie_version_forward_history_ring_wrap_around)
 {
     auto const dbname = create_temp_file(2);
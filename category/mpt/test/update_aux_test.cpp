@@ -16,7 +16,9 @@
 #include "gtest/gtest.h"
 
 #include <chrono>
+#include <cstring>
 #include <thread>
+#include <vector>
 
 #include <category/async/config.hpp>
 #include <category/async/detail/scope_polyfill.hpp>
@@ -200,6 +202,145 @@ TEST(update_aux_test, root_offsets_fast_slow)
     }
 }
 
+TEST(update_aux_test, heal_dirty_copy_from_journal)
+{
+    using monad::mpt::detail::db_metadata;
+
+    monad::async::storage_pool pool(monad::async::use_anonymous_inode_tag{});
+    monad::io::Ring ring1;
+    monad::io::Ring ring2;
+    monad::io::Buffers testbuf =
+        monad::io::make_buffers_for_segregated_read_write(
+            ring1,
+            ring2,
+            2,
+            4,
+            monad::async::AsyncIO::MONAD_IO_BUFFERS_READ_SIZE,
+            monad::async::AsyncIO::MONAD_IO_BUFFERS_WRITE_SIZE);
+    monad::async::AsyncIO testio(pool, testbuf);
+    auto const map_size =
+        sizeof(db_metadata) +
+        testio.chunk_count() * sizeof(db_metadata::chunk_info_t);
+    std::vector<std::byte> before(map_size);
+    uint32_t removed_chunk;
+    {
+        monad::mpt::UpdateAux aux_writer{};
+        aux_writer.set_io(testio, AUX_TEST_HISTORY_LENGTH);
+        aux_writer.append_root_offset(
+            aux_writer.node_writer_fast->sender().offset());
+
+        db_metadata *copies[2];
+        unsigned n = 0;
+        aux_writer.modify_metadata([&](db_metadata *m) { copies[n++] = m; });
+        memcpy(before.data(), (void *)copies[1], map_size);
+
+        // Simulate a sudden exit while the first copy was being written: the
+        // chunk is gone from its free list and its capacity is taken off
+        // under one dirty hold, the second copy never heard of it
+        removed_chunk = aux_writer.db_metadata()->free_list.end;
+        aux_writer.remove(removed_chunk);
+        EXPECT_NE(copies[0]->free_list.end, removed_chunk);
+        memcpy((void *)copies[1], before.data(), map_size);
+        copies[0]->is_dirty().store(1, std::memory_order_release);
+        EXPECT_FALSE(copies[0]->journal.overflowed());
+        EXPECT_GT(copies[0]->journal.count, 0);
+    }
+    {
+        monad::mpt::UpdateAux aux_writer{};
+        aux_writer.set_io(testio, AUX_TEST_HISTORY_LENGTH);
+
+        db_metadata *copies[2];
+        unsigned n = 0;
+        aux_writer.modify_metadata([&](db_metadata *m) { copies[n++] = m; });
+        for (db_metadata *m : copies) {
+            EXPECT_FALSE(m->is_dirty().load(std::memory_order_acquire));
+            EXPECT_EQ(m->free_list.end, removed_chunk);
+        }
+        EXPECT_EQ(
+            copies[0]->capacity_in_free_list, copies[1]->capacity_in_free_list);
+        EXPECT_EQ(
+            0,
+            memcmp(
+                copies[0]->chunk_info,
+                copies[1]->chunk_info,
+                testio.chunk_count() * sizeof(db_metadata::chunk_info_t)));
+        EXPECT_EQ(aux_writer.root_offsets(0).max_version(), 0);
+        EXPECT_EQ(aux_writer.root_offsets(1).max_version(), 0);
+    }
+}
+
+TEST(update_aux_test, heal_copy_interrupted_after_header)
+{
+    using monad::mpt::detail::db_metadata;
+
+    monad::async::storage_pool pool(monad::async::use_anonymous_inode_tag{});
+    monad::io::Ring ring1;
+    monad::io::Ring ring2;
+    monad::io::Buffers testbuf =
+        monad::io::make_buffers_for_segregated_read_write(
+            ring1,
+            ring2,
+            2,
+            4,
+            monad::async::AsyncIO::MONAD_IO_BUFFERS_READ_SIZE,
+            monad::async::AsyncIO::MONAD_IO_BUFFERS_WRITE_SIZE);
+    monad::async::AsyncIO testio(pool, testbuf);
+    auto const map_size =
+        sizeof(db_metadata) +
+        testio.chunk_count() * sizeof(db_metadata::chunk_info_t);
+    std::vector<std::byte> before(map_size);
+    uint32_t free_list_end;
+    {
+        monad::mpt::UpdateAux aux_writer{};
+        aux_writer.set_io(testio, AUX_TEST_HISTORY_LENGTH);
+        aux_writer.append_root_offset(
+            aux_writer.node_writer_fast->sender().offset());
+
+        db_metadata *copies[2];
+        unsigned n = 0;
+        aux_writer.modify_metadata([&](db_metadata *m) { copies[n++] = m; });
+        memcpy(before.data(), (void *)copies[0], map_size);
+        aux_writer.remove(aux_writer.db_metadata()->free_list.end);
+        free_list_end = aux_writer.db_metadata()->free_list.end;
+
+        // Simulate a sudden exit while a full copy healed the first copy,
+        // right after its header and journal were written over chunk infos
+        // which still predate the removal
+        memcpy((void *)copies[0], before.data(), map_size);
+        {
+            auto const g = copies[0]->hold_dirty();
+            db_copy_header(copies[0], copies[1]);
+        }
+        copies[0]->is_dirty().store(1, std::memory_order_release);
+        EXPECT_TRUE(copies[0]->journal.overflowed());
+        EXPECT_NE(
+            0,
+            memcmp(
+                copies[0]->chunk_info,
+                copies[1]->chunk_info,
+                testio.chunk_count() * sizeof(db_metadata::chunk_info_t)));
+    }
+    {
+        monad::mpt::UpdateAux aux_writer{};
+        aux_writer.set_io(testio, AUX_TEST_HISTORY_LENGTH);
+
+        db_metadata *copies[2];
+        unsigned n = 0;
+        aux_writer.modify_metadata([&](db_metadata *m) { copies[n++] = m; });
+        for (db_metadata *m : copies) {
+            EXPECT_FALSE(m->is_dirty().load(std::memory_order_acquire));
+            EXPECT_FALSE(m->journal.overflowed());
+            EXPECT_EQ(m->free_list.end, free_list_end);
+        }
+        EXPECT_EQ(
+            0,
+            memcmp(
+                copies[0]->chunk_info,
+                copies[1]->chunk_info,
+                testio.chunk_count() * sizeof(db_metadata::chunk_info_t)));
+    }
+}
+
 TEST(update_aux_test, configurable_root_offset_chunks)
 {
     std::filesystem::path const filename{
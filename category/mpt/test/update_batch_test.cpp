@@ -0,0 +1,183 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include "test_fixtures_base.hpp"
+#include "test_fixtures_gtest.hpp"
+
+#include <category/core/byte_string.hpp>
+#include <category/core/keccak.h>
+#include <category/mpt/node.hpp>
+#include <category/mpt/trie.hpp>
+#include <category/mpt/update.hpp>
+#include <category/mpt/update_batch.hpp>
+
+#include <category/core/test_util/gtest_signal_stacktrace_printer.hpp> // NOLINT
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+using namespace ::monad::test;
+
+namespace
+{
+    monad::byte_string hashed_key(uint64_t const n)
+    {
+        monad::byte_string key(32, 0);
+        keccak256((unsigned char const *)&n, 8, key.data());
+        return key;
+    }
+
+    struct Account
+    {
+        monad::byte_string key;
+        monad::byte_string value;
+        std::vector<std::pair<monad::byte_string, monad::byte_string>> slots;
+    };
+
+    // Many accounts, so the account batch takes the bucketed parallel sort,
+    // and a few accounts with storage, one of them large
+    std::vector<Account> make_accounts(uint64_t const seed)
+    {
+        std::vector<Account> accounts;
+        for (uint64_t i = 0; i < 5000; ++i) {
+            Account &account = accounts.emplace_back(Account{
+                .key = hashed_key(i),
+                .value = hashed_key(seed + i),
+                .slots = {}});
+            size_t const num_slots = i == 7 ? 5000 : (i % 500 == 0 ? 100 : 0);
+            for (uint64_t j = 0; j < num_slots; ++j) {
+                account.slots.emplace_back(
+                    hashed_key((i << 32) | j), hashed_key(seed + j));
+            }
+        }
+        return accounts;
+    }
+
+    struct UpdateBatchTest : public InMemoryMerkleTrieGTest
+    {
+        Node::SharedPtr upsert_list(
+            Node::SharedPtr old, std::vector<Account> const &accounts)
+        {
+            std::deque<Update> alloc;
+            UpdateList account_updates;
+            for (Account const &account : accounts) {
+                UpdateList slot_updates;
+                for (auto const &[key, value] : account.slots) {
+                    slot_updates.push_front(
+                        alloc.emplace_back(make_update(key, value)));
+                }
+                account_updates.push_front(alloc.emplace_back(make_update(
+                    account.key,
+                    account.value,
+                    false,
+                    std::move(slot_updates))));
+            }
+            return upsert(
+                this->aux,
+                0,
+                *this->sm,
+                std::move(old),
+                std::move(account_updates));
+        }
+
+        Node::SharedPtr upsert_batch(
+            Node::SharedPtr old, std::vector<Account> const &accounts)
+        {
+            std::deque<UpdateBatch> slot_batches;
+            UpdateBatch account_batch;
+            account_batch.reserve(accounts.size());
+            for (Account const &account : accounts) {
+                UpdateBatch &slot_batch = slot_batches.emplace_back();
+                for (auto const &[key, value] : account.slots) {
+                    slot_batch.push_back(make_update(key, value));
+                }
+                account_batch.push_back(make_update(
+                    account.key, account.value, false, slot_batch.finalize()));
+            }
+            return upsert(
+                this->aux,
+                0,
+                *this->sm,
+                std::move(old),
+                account_batch.finalize());
+        }
+
+        monad::byte_string hash_of(Node::SharedPtr root)
+        {
+            this->root = std::move(root);
+            return this->root_hash();
+        }
+    };
+}
+
+TEST_F(UpdateBatchTest, same_root_as_update_list)
+{
+    auto const accounts = make_accounts(0);
+    auto const list_root = upsert_list({}, accounts);
+    auto const batch_root = upsert_batch({}, accounts);
+    EXPECT_EQ(hash_of(batch_root), hash_of(list_root));
+
+    // update every other account and some of the storage of the large one
+    std::vector<Account> modified;
+    for (size_t i = 1; i < accounts.size(); i += 2) {
+        Account &account = modified.emplace_back(Account{
+            .key = accounts[i].key,
+            .value = hashed_key(1'000'000 + i),
+            .slots = {}});
+        if (i == 7) {
+            for (uint64_t j = 0; j < 3000; ++j) {
+                account.slots.emplace_back(
+                    hashed_key((uint64_t{7} << 32) | j), hashed_key(j + 1));
+            }
+        }
+    }
+    auto const list_root2 = upsert_list(list_root, modified);
+    auto const batch_root2 = upsert_batch(batch_root, modified);
+    EXPECT_EQ(hash_of(batch_root2), hash_of(list_root2));
+    EXPECT_NE(hash_of(batch_root2), hash_of(batch_root));
+}
+
+TEST_F(UpdateBatchTest, variable_length_keys)
+{
+    this->sm = std::make_unique<StateMachineAlwaysVarLen>();
+    auto const value = 0xbeef_bytes;
+    std::vector<monad::byte_string> const keys{
+        0x00_bytes,
+        0x01_bytes,
+        0x0102_bytes,
+        0x10_bytes,
+        0x1011_bytes,
+        0x101112_bytes,
+        0x80_bytes,
+        0x8081_bytes};
+
+    std::deque<Update> alloc;
+    UpdateList list;
+    UpdateBatch batch;
+    for (auto const &key : keys) {
+        list.push_front(alloc.emplace_back(make_update(key, value)));
+        batch.push_back(make_update(key, value));
+    }
+    auto const list_root =
+        upsert(this->aux, 0, *this->sm, {}, std::move(list));
+    auto const batch_root =
+        upsert(this->aux, 0, *this->sm, {}, batch.finalize());
+    EXPECT_EQ(hash_of(batch_root), hash_of(list_root));
+}
@@ -96,6 +96,8 @@ void expire_(
 void try_fillin_parent_with_rewritten_node(
     UpdateAuxImpl &, CompactTNode::unique_ptr_type);
 
+void flush_compact_cluster(UpdateAuxImpl &, CompactCluster &);
+
 void try_fillin_parent_after_expiration(
     UpdateAuxImpl &, StateMachine &, ExpireTNode::unique_ptr_type);
 
@@ -114,6 +116,27 @@ struct async_write_node_result
 void flush_buffered_writes(UpdateAuxImpl &);
 chunk_offset_t write_new_root_node(UpdateAuxImpl &, Node &, uint64_t);
 
+// A child left unwritten by a deferred write, see `Update::defer_write`
+bool has_unwritten_child(Node const &node)
+{
+    for (unsigned i = 0; i < node.number_of_children(); ++i) {
+        if (node.fnext(i) == INVALID_OFFSET) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool any_child_deferred(std::span<ChildData const> const children)
+{
+    for (ChildData const &child : children) {
+        if (child.is_valid() && child.defer_write) {
+            return true;
+        }
+    }
+    return false;
+}
+
 Node::SharedPtr upsert(
     UpdateAuxImpl &aux, uint64_t const version, StateMachine &sm,
     Node::SharedPtr old, UpdateList &&updates, bool const write_root)
@@ -502,6 +525,11 @@ Node::SharedPtr create_node_from_children_if_any(
     if (aux.is_on_disk()) {
         for (auto &child : children) {
             if (child.is_valid() && child.offset == INVALID_OFFSET) {
+                if (child.defer_write) {
+                    // kept in memory until the next upsert recreates it
+                    MONAD_DEBUG_ASSERT(child.ptr);
+                    continue;
+                }
                 // write updated node or node to be compacted to disk
                 // won't duplicate write of unchanged old child
                 MONAD_DEBUG_ASSERT(child.branch < 16);
@@ -592,7 +620,11 @@ void create_node_compute_data_possibly_async(
     MONAD_DEBUG_ASSERT(entry.branch < 16);
     if (node) {
         parent.version = std::max(parent.version, node->version);
-        entry.finalize(std::move(node), sm.get_compute(), sm.cache());
+        entry.finalize(
+            std::move(node),
+            sm.get_compute(),
+            sm.cache(),
+            entry.defer_write || any_child_deferred(tnode->children));
         if (sm.auto_expire()) {
             MONAD_ASSERT(
                 entry.subtrie_min_version >=
@@ -616,6 +648,7 @@ void update_value_and_subtrie_(
         --parent.npending;
         return;
     }
+    entry.defer_write = update.defer_write;
     // No need to check next is empty or not, following branches will handle it
     Requests requests;
     requests.split_into_sublists(std::move(update.next), 0);
@@ -666,6 +699,7 @@ void create_new_trie_(
     if (updates.size() == 1) {
         Update &update = updates.front();
         MONAD_DEBUG_ASSERT(update.value.has_value());
+        entry.defer_write = update.defer_write;
         auto const path = update.key.substr(prefix_index);
         for (auto i = 0u; i < path.nibble_size(); ++i) {
             sm.down(path.get(i));
@@ -758,7 +792,11 @@ void create_new_trie_from_requests_(
         aux, sm, mask, mask, children, path, opt_leaf_data, version);
     MONAD_ASSERT(node);
     parent_version = std::max(parent_version, node->version);
-    entry.finalize(std::move(node), sm.get_compute(), sm.cache());
+    entry.finalize(
+        std::move(node),
+        sm.get_compute(),
+        sm.cache(),
+        entry.defer_write || any_child_deferred(children));
     if (sm.auto_expire()) {
         MONAD_ASSERT(
             entry.subtrie_min_version >= aux.curr_upsert_auto_expire_version);
@@ -1308,11 +1346,20 @@ void compact_(
         virtual_node_offset,
         node.get_disk_size());
 
+    // A node with both a value and children owns a nested trie, e.g. an
+    // account and its storage, whose compacted nodes are written together
+    if (!tnode->cluster && node.number_of_children() > 0 &&
+        node.has_value() && !node.value().empty()) {
+        tnode->cluster = new CompactCluster;
+        tnode->owns_cluster = true;
+    }
+
     for (unsigned j = 0; j < node.number_of_children(); ++j) {
         if (node.min_offset_fast(j) < aux.compact_offset_fast ||
             node.min_offset_slow(j) < aux.compact_offset_slow) {
             auto child_tnode =
                 CompactTNode::make(tnode.get(), j, node.move_next(j));
+            child_tnode->cluster = tnode->cluster;
             compact_(
                 aux,
                 sm,
@@ -1329,27 +1376,27 @@ void compact_(
     try_fillin_parent_with_rewritten_node(aux, std::move(tnode));
 }
 
-void try_fillin_parent_with_rewritten_node(
-    UpdateAuxImpl &aux, CompactTNode::unique_ptr_type tnode)
+// Write a node rewritten by compaction once everything below it is written,
+// returns its new offset and the min offsets of its subtrie
+std::tuple<
+    chunk_offset_t, compact_virtual_chunk_offset_t,
+    compact_virtual_chunk_offset_t>
+write_rewritten_node(UpdateAuxImpl &aux, Node &node, bool rewrite_to_fast)
 {
-    if (tnode->npending) { // there are unfinished async below node
-        tnode.release();
-        return;
-    }
     auto [min_offset_fast, min_offset_slow] =
-        calc_min_offsets(*tnode->node, INVALID_VIRTUAL_OFFSET);
+        calc_min_offsets(node, INVALID_VIRTUAL_OFFSET);
     // If subtrie contains nodes from fast list, write itself to fast list too
     if (min_offset_fast != INVALID_COMPACT_VIRTUAL_OFFSET) {
-        tnode->rewrite_to_fast = true; // override that
+        rewrite_to_fast = true; // override that
     }
     auto const new_offset =
-        async_write_node_set_spare(aux, *tnode->node, tnode->rewrite_to_fast);
+        async_write_node_set_spare(aux, node, rewrite_to_fast);
     auto const new_node_virtual_offset = aux.physical_to_virtual(new_offset);
     MONAD_DEBUG_ASSERT(new_node_virtual_offset != INVALID_VIRTUAL_OFFSET);
     compact_virtual_chunk_offset_t const truncated_new_virtual_offset{
         new_node_virtual_offset};
     // update min offsets in subtrie
-    if (tnode->rewrite_to_fast) {
+    if (rewrite_to_fast) {
         min_offset_fast =
             std::min(min_offset_fast, truncated_new_virtual_offset);
     }
@@ -1359,6 +1406,66 @@ void try_fillin_parent_with_rewritten_node(
     }
     MONAD_DEBUG_ASSERT(min_offset_fast >= aux.compact_offset_fast);
     MONAD_DEBUG_ASSERT(min_offset_slow >= aux.compact_offset_slow);
+    return {new_offset, min_offset_fast, min_offset_slow};
+}
+
+void flush_compact_cluster(UpdateAuxImpl &aux, CompactCluster &cluster)
+{
+    // Writes may poll for completions that add more nodes to the cluster
+    auto pending = std::move(cluster.pending);
+    cluster.pending.clear();
+    // Nodes that were cached, i.e. read recently, go last so they sit right
+    // before the root of the nested trie. The parent of a cached node is
+    // cached too, so every node is still written after its children.
+    std::stable_partition(
+        pending.begin(),
+        pending.end(),
+        [](CompactCluster::PendingWrite const &write) {
+            return !write.cache_node;
+        });
+    for (auto &write : pending) {
+        auto const [new_offset, min_offset_fast, min_offset_slow] =
+            write_rewritten_node(aux, *write.node, write.rewrite_to_fast);
+        write.parent->set_fnext(write.index, new_offset);
+        write.parent->set_min_offset_fast(write.index, min_offset_fast);
+        write.parent->set_min_offset_slow(write.index, min_offset_slow);
+        if (write.cache_node) {
+            write.parent->set_next(write.index, std::move(write.node));
+        }
+    }
+    aux.collect_compact_cluster_stats(static_cast<unsigned>(pending.size()));
+}
+
+void try_fillin_parent_with_rewritten_node(
+    UpdateAuxImpl &aux, CompactTNode::unique_ptr_type tnode)
+{
+    if (tnode->npending) { // there are unfinished async below node
+        tnode.release();
+        return;
+    }
+    if (tnode->cluster && !tnode->owns_cluster) {
+        // hold the node back until the nested trie it is part of is done
+        auto &cluster = *tnode->cluster;
+        if (cluster.pending.size() == CompactCluster::MAX_PENDING) {
+            flush_compact_cluster(aux, cluster);
+        }
+        MONAD_DEBUG_ASSERT(tnode->parent->type == tnode_type::compact);
+        cluster.pending.emplace_back(CompactCluster::PendingWrite{
+            .node = std::move(tnode->node),
+            .parent = tnode->parent->node.get(),
+            .index = tnode->index,
+            .rewrite_to_fast = tnode->rewrite_to_fast,
+            .cache_node = tnode->cache_node});
+        --tnode->parent->npending;
+        return;
+    }
+    if (tnode->owns_cluster) {
+        flush_compact_cluster(aux, *tnode->cluster);
+        delete tnode->cluster;
+        tnode->cluster = nullptr;
+    }
+    auto const [new_offset, min_offset_fast, min_offset_slow] =
+        write_rewritten_node(aux, *tnode->node, tnode->rewrite_to_fast);
     auto *parent = tnode->parent;
     auto const index = tnode->index;
     if (parent->type == tnode_type::update) {
@@ -1643,6 +1750,9 @@ retry:
 chunk_offset_t
 async_write_node_set_spare(UpdateAuxImpl &aux, Node &node, bool write_to_fast)
 {
+    // A deferred write must be recreated by a later upsert of the version
+    // before any node above it is written
+    MONAD_ASSERT(!has_unwritten_child(node));
     write_to_fast &= aux.can_write_to_fast();
     if (aux.alternate_slow_fast_writer()) {
         // alternate between slow and fast writer
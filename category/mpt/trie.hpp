@@ -194,6 +194,10 @@ class UpdateAuxImpl
 
     void reset_node_writers();
 
+    // heal a copy of the metadata left dirty by a sudden exit from the other
+    // copy, replaying only what its journal says it wrote
+    void replay_metadata_journal(unsigned dirty);
+
     void advance_compact_offsets();
 
     void free_compacted_chunks();
@@ -241,6 +245,19 @@ class UpdateAuxImpl
     compact_virtual_chunk_offset_t compact_offset_range_slow_{
         MIN_COMPACT_VIRTUAL_OFFSET};
 
+    /******** History length control ********/
+    // moving average of the net growth of chunks in use per block, used to
+    // predict when disk usage will leave the target band
+    double disk_growth_chunks_per_block_{0};
+    // chunks in use after the last block, null until first measured
+    std::optional<double> last_block_used_chunks_;
+    // versions erased by the last history length adjustment, on top of the
+    // one that rolls off with every new version
+    uint64_t history_erase_rate_{0};
+    // running totals over the upserts with compaction
+    std::atomic<uint64_t> total_bytes_written_{0};
+    std::atomic<uint64_t> total_bytes_compacted_{0};
+
     std::optional<pid_t> current_upsert_tid_; // used to detect what thread is
                                               // currently upserting
     bool alternate_slow_fast_writer_{false};
@@ -568,6 +585,29 @@ public:
         bool can_write_to_fast = true, bool write_root = true);
 
     void adjust_history_length_based_on_disk_usage();
+
+    uint64_t history_erase_rate() const noexcept
+    {
+        return history_erase_rate_;
+    }
+
+    // Bytes written to disk by upserts since startup, at the granularity of
+    // compact offsets, and of those the bytes copied by compaction
+    uint64_t total_bytes_written() const noexcept
+    {
+        return total_bytes_written_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t total_bytes_compacted() const noexcept
+    {
+        return total_bytes_compacted_.load(std::memory_order_relaxed);
+    }
+
+    double disk_growth_chunks_per_block() const noexcept
+    {
+        return disk_growth_chunks_per_block_;
+    }
+
     void move_trie_version_forward(uint64_t src, uint64_t dest);
 
     // collect and print trie update stats
@@ -579,6 +619,7 @@ public:
     void collect_compacted_nodes_stats(
         bool const copy_node_for_fast, bool const rewrite_to_fast,
         virtual_chunk_offset_t node_offset, uint32_t node_disk_size);
+    void collect_compact_cluster_stats(unsigned nodes_written);
 
     void print_update_stats(uint64_t version);
 
@@ -869,7 +910,7 @@ public:
 };
 
 static_assert(
-    sizeof(UpdateAuxImpl) == 160 + sizeof(detail::TrieUpdateCollectedStats));
+    sizeof(UpdateAuxImpl) == 208 + sizeof(detail::TrieUpdateCollectedStats));
 static_assert(alignof(UpdateAuxImpl) == 8);
 
 template <lockable_or_void LockType = void>
@@ -1064,10 +1105,11 @@ Node::SharedPtr upsert(
 // Note that `src_root` may be of a different version than `dest_root`.
 // Any pre-existing trie at `dest_prefix` will be overwritten.
 // The in-memory effect is similar to a move operation.
+// With `defer_dest_path_write`, see `Db::copy_trie`.
 Node::SharedPtr copy_trie_to_dest(
     UpdateAuxImpl &, Node::SharedPtr src_root, NibblesView src_prefix,
     Node::SharedPtr dest_root, NibblesView dest_prefix, uint64_t dest_version,
-    bool write_root = true);
+    bool write_root = true, bool defer_dest_path_write = false);
 
 // load all nodes as far as caching policy would allow
 size_t load_all(UpdateAuxImpl &, StateMachine &, NodeCursor const &);
@@ -36,6 +36,14 @@ struct Update
     NibblesView key{};
     std::optional<byte_string_view> value{std::nullopt};
     bool incarnation{false};
+    // Set by UpdateBatch: this update and those linked after it are
+    // contiguous in memory and sorted by key
+    bool in_batch{false};
+    // Leave the node at this key, and the nodes this upsert creates above
+    // it, in memory unwritten. Only valid if the upsert does not write the
+    // root and the next upsert of the same version updates this key again,
+    // which recreates and writes them.
+    bool defer_write{false};
     UpdateList next;
     int64_t version{0};
 
@@ -41,6 +41,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <format>
+#include <optional>
 #include <random>
 #include <ranges>
 #include <span>
@@ -136,10 +137,20 @@ UpdateAuxImpl::chunk_list_and_age(uint32_t const idx) const noexcept
 void UpdateAuxImpl::append(chunk_list const list, uint32_t const idx) noexcept
 {
     MONAD_ASSERT(is_on_disk());
+    uint64_t capacity = 0;
+    if (list == chunk_list::free) {
+        auto &chunk = io->storage_pool().chunk(storage_pool::seq, idx);
+        capacity = chunk.capacity();
+        MONAD_DEBUG_ASSERT(chunk.size() == 0);
+    }
+    // One dirty hold spans both updates of a copy, so its journal still
+    // covers the list update if the process exits during the capacity one
     auto do_ = [&](detail::db_metadata *m) {
+        auto const g = m->hold_dirty();
         switch (list) {
         case chunk_list::free:
             m->append_(m->free_list, m->at_(idx));
+            m->free_capacity_add_(capacity);
             break;
         case chunk_list::fast:
             m->append_(m->fast_list, m->at_(idx));
@@ -151,13 +162,6 @@ void UpdateAuxImpl::append(chunk_list const list, uint32_t const idx) noexcept
     };
     do_(db_metadata_[0].main);
     do_(db_metadata_[1].main);
-    if (list == chunk_list::free) {
-        auto &chunk = io->storage_pool().chunk(storage_pool::seq, idx);
-        auto capacity = chunk.capacity();
-        MONAD_DEBUG_ASSERT(chunk.size() == 0);
-        db_metadata_[0].main->free_capacity_add_(capacity);
-        db_metadata_[1].main->free_capacity_add_(capacity);
-    }
 }
 
 void UpdateAuxImpl::remove(uint32_t const idx) noexcept
@@ -166,16 +170,21 @@ void UpdateAuxImpl::remove(uint32_t const idx) noexcept
     bool const is_free_list =
         (!db_metadata_[0].main->at_(idx)->in_fast_list &&
          !db_metadata_[0].main->at_(idx)->in_slow_list);
-    auto do_ = [&](detail::db_metadata *m) { m->remove_(m->at_(idx)); };
-    do_(db_metadata_[0].main);
-    do_(db_metadata_[1].main);
+    uint64_t capacity = 0;
     if (is_free_list) {
         auto &chunk = io->storage_pool().chunk(storage_pool::seq, idx);
-        auto capacity = chunk.capacity();
+        capacity = chunk.capacity();
         MONAD_DEBUG_ASSERT(chunk.size() == 0);
-        db_metadata_[0].main->free_capacity_sub_(capacity);
-        db_metadata_[1].main->free_capacity_sub_(capacity);
     }
+    auto do_ = [&](detail::db_metadata *m) {
+        auto const g = m->hold_dirty();
+        m->remove_(m->at_(idx));
+        if (is_free_list) {
+            m->free_capacity_sub_(capacity);
+        }
+    };
+    do_(db_metadata_[0].main);
+    do_(db_metadata_[1].main);
 }
 
 void UpdateAuxImpl::advance_db_offsets_to(
@@ -200,7 +209,9 @@ void UpdateAuxImpl::append_root_offset(
     MONAD_ASSERT(is_on_disk());
     auto do_ = [&](detail::db_metadata *m) {
         auto g = m->hold_dirty();
-        root_offsets(m == db_metadata_[1].main).push(root_offset);
+        auto ro = root_offsets(m == db_metadata_[1].main);
+        m->journal_root_offset_(ro.max_version() + 1);
+        ro.push(root_offset);
     };
     do_(db_metadata_[0].main);
     do_(db_metadata_[1].main);
@@ -213,9 +224,11 @@ void UpdateAuxImpl::update_root_offset(
     auto do_ = [&](detail::db_metadata *m) {
         auto g = m->hold_dirty();
         auto ro = root_offsets(m == db_metadata_[1].main);
+        m->journal_root_offset_(i);
         ro.assign(i, root_offset);
         if (root_offset == INVALID_OFFSET && i == db_history_max_version() &&
             i == db_history_min_valid_version()) {
+            m->journal_overflow_();
             ro.reset_all(0);
             MONAD_ASSERT(ro.max_version() == INVALID_BLOCK_NUM);
         }
@@ -237,10 +250,12 @@ void UpdateAuxImpl::fast_forward_next_version(
 
         if (curr_version == INVALID_BLOCK_NUM ||
             new_version - curr_version >= ro.capacity()) {
+            m->journal_overflow_();
             ro.reset_all(new_version);
         }
         else {
             while (curr_version + 1 < new_version) {
+                m->journal_root_offset_(curr_version + 1);
                 ro.push(INVALID_OFFSET);
                 curr_version = ro.max_version();
             }
@@ -484,6 +499,7 @@ void UpdateAuxImpl::clear_ondisk_db()
     MONAD_ASSERT(is_on_disk());
     auto do_ = [&](detail::db_metadata *m) {
         auto g = m->hold_dirty();
+        m->journal_overflow_();
         root_offsets(m == db_metadata_[1].main).reset_all(0);
     };
     do_(db_metadata_[0].main);
@@ -511,7 +527,11 @@ void UpdateAuxImpl::rewind_to_version(uint64_t const version)
     }
     auto do_ = [&](detail::db_metadata *m) {
         auto g = m->hold_dirty();
-        root_offsets(m == db_metadata_[1].main).rewind_to_version(version);
+        auto ro = root_offsets(m == db_metadata_[1].main);
+        for (uint64_t i = version + 1; i <= ro.max_version(); i++) {
+            m->journal_root_offset_(i);
+        }
+        ro.rewind_to_version(version);
     };
     do_(db_metadata_[0].main);
     do_(db_metadata_[1].main);
@@ -546,6 +566,56 @@ void UpdateAuxImpl::rewind_to_version(uint64_t const version)
     rewind_to_match_offsets();
 }
 
+void UpdateAuxImpl::replay_metadata_journal(unsigned const dirty)
+{
+    auto *const dest = db_metadata_[dirty].main;
+    auto const *const src = db_metadata_[!dirty].main;
+    MONAD_ASSERT(!src->is_dirty().load(std::memory_order_acquire));
+    auto const &journal = dest->journal;
+    MONAD_ASSERT(!journal.overflowed());
+
+    // Scalars are few enough to always heal. The journal itself is left in
+    // place until the copy is marked clean, so healing is repeatable if
+    // interrupted.
+    dest->capacity_in_free_list = src->capacity_in_free_list;
+    dest->root_offsets.version_lower_bound_ =
+        src->root_offsets.version_lower_bound_;
+    dest->root_offsets.next_version_ = src->root_offsets.next_version_;
+    auto copy_range = [&](void const *begin, void const *end) {
+        auto const offset = (std::byte const *)begin - (std::byte const *)src;
+        memcpy(
+            (std::byte *)dest + offset,
+            begin,
+            size_t((std::byte const *)end - (std::byte const *)begin));
+    };
+    copy_range(&src->db_offsets, &src->journal);
+    copy_range(&src->future_variables_unused, &src->chunk_info[0]);
+
+    auto const dest_ro = db_metadata_[dirty].root_offsets;
+    auto const src_ro = db_metadata_[!dirty].root_offsets;
+    MONAD_ASSERT(dest_ro.size() == src_ro.size());
+    for (uint32_t n = 0; n < journal.count; n++) {
+        auto const record = journal.records[n];
+        auto const index = detail::db_metadata::journal_t::index_of(record);
+        switch (detail::db_metadata::journal_t::kind_of(record)) {
+        case detail::db_metadata::journal_t::kind::chunk_info:
+            MONAD_ASSERT(index < src->chunk_info_count);
+            dest->chunk_info[index] = src->chunk_info[index];
+            break;
+        case detail::db_metadata::journal_t::kind::root_offset:
+            dest_ro[index & (dest_ro.size() - 1)] =
+                src_ro[index & (src_ro.size() - 1)];
+            break;
+        default:
+            MONAD_ABORT_PRINTF(
+                "Detected corruption. Unknown DB metadata journal record "
+                "%lx.",
+                record);
+        }
+    }
+    dest->is_dirty().store(0, std::memory_order_release);
+}
+
 UpdateAuxImpl::~UpdateAuxImpl()
 {
     if (io != nullptr) {
@@ -684,6 +754,7 @@ void UpdateAuxImpl::set_io(
             detail::db_metadata::MAGIC + magic_prefix_len);
     }
     // Replace any dirty copy with the non-dirty copy
+    std::optional<unsigned> dirty_copy_to_replay;
     if (0 == memcmp(
                  db_metadata_[0].main->magic,
                  detail::db_metadata::MAGIC,
@@ -693,14 +764,27 @@ void UpdateAuxImpl::set_io(
                  detail::db_metadata::MAGIC,
                  detail::db_metadata::MAGIC_STRING_LEN)) {
         if (can_write_to_map) {
-            // Replace the dirty copy with the non-dirty copy
-            if (db_metadata_[0].main->is_dirty().load(
-                    std::memory_order_acquire)) {
-                db_copy(db_metadata_[0].main, db_metadata_[1].main, map_size);
-            }
-            else if (db_metadata_[1].main->is_dirty().load(
-                         std::memory_order_acquire)) {
-                db_copy(db_metadata_[1].main, db_metadata_[0].main, map_size);
+            // Heal the dirty copy from the non-dirty copy. If its journal is
+            // complete, only what it records is replayed once the root
+            // offsets are mapped, otherwise the whole copy is replaced.
+            for (unsigned const which : {0u, 1u}) {
+                auto *const m = db_metadata_[which].main;
+                if (!m->is_dirty().load(std::memory_order_acquire)) {
+                    continue;
+                }
+                if (m->journal.overflowed()) {
+                    Stopwatch<std::chrono::microseconds> const timer;
+                    db_copy(m, db_metadata_[!which].main, map_size);
+                    LOG_INFO_CFORMAT(
+                        "Healed dirty DB metadata copy %u by full copy. Time "
+                        "elapsed: %ld us",
+                        which,
+                        timer.elapsed().count());
+                }
+                else {
+                    dirty_copy_to_replay = which;
+                }
+                break;
             }
         }
         else {
@@ -992,6 +1076,18 @@ void UpdateAuxImpl::set_io(
     }
     else { // resume from an existing db and underlying storage devices
         map_root_offsets();
+        if (dirty_copy_to_replay.has_value()) {
+            Stopwatch<std::chrono::microseconds> const timer;
+            auto const records =
+                db_metadata_[*dirty_copy_to_replay].main->journal.count;
+            replay_metadata_journal(*dirty_copy_to_replay);
+            LOG_INFO_CFORMAT(
+                "Healed dirty DB metadata copy %u by replaying %u journal "
+                "records. Time elapsed: %ld us",
+                *dirty_copy_to_replay,
+                records,
+                timer.elapsed().count());
+        }
         if (!io->is_read_only()) {
             // Reset/init node writer's offsets, destroy contents after
             // fast_offset.id chunck
@@ -1169,13 +1265,15 @@ Node::SharedPtr UpdateAuxImpl::do_update(
         physical_to_virtual(node_writer_slow->sender().offset());
     LOG_INFO_CFORMAT(
         "Finish upserting version %lu. Min valid version %lu. Time elapsed: "
-        "%ld us. Disk usage: %.4f. Chunks: %u fast, %u slow, %u free. Writer "
-        "offsets: fast={%u,%u}, slow={%u,%u}. Compaction head offset fast=%u, "
-        "slow=%u",
+        "%ld us. Disk usage: %.4f. History length %lu, erase rate %lu. "
+        "Chunks: %u fast, %u slow, %u free. Writer offsets: fast={%u,%u}, "
+        "slow={%u,%u}. Compaction head offset fast=%u, slow=%u",
         version,
         db_history_min_valid_version(),
         upsert_duration.count(),
         disk_usage(),
+        version_history_length(),
+        history_erase_rate_,
         num_chunks(chunk_list::fast),
         num_chunks(chunk_list::slow),
         num_chunks(chunk_list::free),
@@ -1259,12 +1357,24 @@ double UpdateAuxImpl::calculate_disk_usage_if_erased_up_to_and_including(
     return (num_fast_chunks + num_slow_chunks) / (double)io->chunk_count();
 }
 
+/* Keeps disk usage within [lower_bound, upper_bound] by adjusting history
+length. Usage is projected `prediction_horizon` blocks ahead from the recent
+net growth of the chunks in use, and once the projection crosses the upper
+bound the oldest versions are shed a few per block, more the further it
+overshoots. Shedding shrinks the net growth it is projected from, so it stops
+once usage holds steady. Freed chunks are then released over many blocks, and
+the shorter history speeds up fast list compaction in step. Only if usage
+actually exceeds the upper bound is history cut back to below it in one go.
+*/
 void UpdateAuxImpl::adjust_history_length_based_on_disk_usage()
 {
     constexpr double upper_bound = 0.8;
     constexpr double lower_bound = 0.6;
+    constexpr uint64_t prediction_horizon = 64;
+    constexpr uint64_t max_erase_per_block = 8;
 
     Stopwatch<std::chrono::microseconds> timer;
+    history_erase_rate_ = 0;
 
     // Shorten history length when disk usage is high
     auto const max_version = db_history_max_version();
@@ -1274,6 +1384,10 @@ void UpdateAuxImpl::adjust_history_length_based_on_disk_usage()
     auto const history_length_before =
         max_version - db_history_min_valid_version() + 1;
     auto const current_disk_usage = disk_usage();
+    auto const predicted_disk_usage =
+        current_disk_usage + disk_growth_chunks_per_block_ *
+                                 double(prediction_horizon) /
+                                 (double)io->chunk_count();
     if (current_disk_usage > upper_bound &&
         history_length_before > MIN_HISTORY_LENGTH) {
         uint64_t const lo = db_history_min_valid_version();
@@ -1301,6 +1415,7 @@ void UpdateAuxImpl::adjust_history_length_based_on_disk_usage()
         erase_versions_up_to_and_including(best_version_to_erase);
         update_history_length_metadata(
             std::max(max_version - best_version_to_erase, MIN_HISTORY_LENGTH));
+        history_erase_rate_ = best_version_to_erase - lo + 1;
         MONAD_ASSERT(
             disk_usage() <= upper_bound ||
             version_history_length() == MIN_HISTORY_LENGTH);
@@ -1312,6 +1427,32 @@ void UpdateAuxImpl::adjust_history_length_based_on_disk_usage()
             disk_usage(),
             timer.elapsed().count());
     }
+    // Shed history gradually when disk usage is projected to become high
+    else if (
+        predicted_disk_usage > upper_bound &&
+        history_length_before > MIN_HISTORY_LENGTH) {
+        double const overshoot = std::min(
+            1.0,
+            (predicted_disk_usage - upper_bound) / (upper_bound - lower_bound));
+        uint64_t const rate = std::min(
+            history_length_before - MIN_HISTORY_LENGTH,
+            1 + (uint64_t)(overshoot * double(max_erase_per_block - 1)));
+        uint64_t const version_to_erase =
+            db_history_min_valid_version() + rate - 1;
+        erase_versions_up_to_and_including(version_to_erase);
+        update_history_length_metadata(
+            std::max(max_version - version_to_erase, MIN_HISTORY_LENGTH));
+        history_erase_rate_ = rate;
+        LOG_INFO_CFORMAT(
+            "Shed %lu versions, db history length down from %lu to %lu. "
+            "Current disk usage: %.4f, predicted: %.4f, Time elapsed: %ld us",
+            rate,
+            history_length_before,
+            version_history_length(),
+            disk_usage(),
+            predicted_disk_usage,
+            timer.elapsed().count());
+    }
     // Raise history length limit when disk usage falls low
     else if (auto const offsets = root_offsets();
              current_disk_usage < lower_bound &&
@@ -1370,6 +1511,34 @@ void UpdateAuxImpl::update_disk_growth_data()
         curr_slow_writer_offset - last_block_end_offset_slow_;
     last_block_end_offset_fast_ = curr_fast_writer_offset;
     last_block_end_offset_slow_ = curr_slow_writer_offset;
+    total_bytes_written_.fetch_add(
+        (uint64_t(last_block_disk_growth_fast_) +
+         uint64_t(last_block_disk_growth_slow_))
+            << 16,
+        std::memory_order_relaxed);
+    total_bytes_compacted_.fetch_add(
+        stats.total_compacted_bytes(), std::memory_order_relaxed);
+
+    // Net growth of the chunks in use, not counting the unwritten remainder
+    // of the chunks being written to. Chunks freed by compaction and by
+    // erased history offset the ones written, so that usage holding steady
+    // reads as no growth.
+    auto const unwritten = [this](auto const &writer) {
+        auto const offset = writer->sender().offset();
+        return 1.0 - double(offset.offset) /
+                         double(io->chunk_capacity(offset.id));
+    };
+    double const used_chunks =
+        double(io->chunk_count() - num_chunks(chunk_list::free)) -
+        unwritten(node_writer_fast) - unwritten(node_writer_slow);
+    if (last_block_used_chunks_.has_value()) {
+        // Exponential moving average over roughly the last 32 blocks
+        constexpr double alpha = 1.0 / 32;
+        double const growth_chunks = used_chunks - *last_block_used_chunks_;
+        disk_growth_chunks_per_block_ +=
+            alpha * (growth_chunks - disk_growth_chunks_per_block_);
+    }
+    last_block_used_chunks_ = used_chunks;
 }
 
 void UpdateAuxImpl::advance_compact_offsets()
@@ -1705,6 +1874,12 @@ void UpdateAuxImpl::print_update_stats(uint64_t const version)
                     : 0,
                 (double)stats.bytes_read_after_compact_offset[1] / 1024);
         }
+        std::format_to(
+            std::back_inserter(buf),
+            "[Clusters]\n"
+            "   nested tries written contiguously {}, nodes {}\n",
+            stats.compact_clusters,
+            stats.compact_cluster_nodes);
     }
     LOG_INFO("{}", buf);
 #else
@@ -1724,6 +1899,18 @@ void UpdateAuxImpl::collect_number_nodes_created_stats()
 #endif
 }
 
+void UpdateAuxImpl::collect_compact_cluster_stats(unsigned const nodes_written)
+{
+#if MONAD_MPT_COLLECT_STATS
+    if (nodes_written) {
+        ++stats.compact_clusters;
+        stats.compact_cluster_nodes += nodes_written;
+    }
+#else
+    (void)nodes_written;
+#endif
+}
+
 void UpdateAuxImpl::collect_compaction_read_stats(
     chunk_offset_t const physical_node_offset, unsigned const bytes_to_read)
 {
@@ -1803,8 +1990,11 @@ void UpdateAuxImpl::collect_compacted_nodes_stats(
             compact_virtual_chunk_offset_t{node_offset} < compact_offset_slow);
         stats.compacted_bytes_in_slow += node_disk_size;
     }
-    (void)copy_node_for_fast;
-    (void)rewrite_to_fast;
+    // fast to slow, slow to slow, and slow to fast for slow
+    if (!rewrite_to_fast ||
+        (!copy_node_for_fast && !node_offset.in_fast_list())) {
+        stats.compacted_bytes += node_disk_size;
+    }
 #endif
 }
 
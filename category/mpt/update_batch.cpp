@@ -0,0 +1,126 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/mpt/update_batch.hpp>
+
+#include <category/core/assert.h>
+#include <category/mpt/config.hpp>
+#include <category/mpt/update.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+MONAD_MPT_NAMESPACE_BEGIN
+
+namespace
+{
+    // Below this size a single threaded comparison sort is faster than
+    // bucketing
+    constexpr size_t PARALLEL_SORT_THRESHOLD = 4096;
+
+    // Buckets on the leading byte of the key. A key of a single nibble sorts
+    // ahead of every longer key with the same leading nibble, so each
+    // leading nibble gets an extra bucket in front of its 16 byte buckets.
+    constexpr unsigned NUM_BUCKETS = 16 * 17;
+
+    unsigned bucket_of(NibblesView const key)
+    {
+        // Rejected by finalize() anyway, but it has to be caught before the
+        // leading nibble is read
+        MONAD_ASSERT(
+            key.nibble_size() != 0, "Invalid update batch: empty key");
+        unsigned const hi = key.get(0);
+        return hi * 17 + (key.nibble_size() > 1 ? 1u + key.get(1) : 0u);
+    }
+
+    bool key_less(Update const &a, Update const &b)
+    {
+        return a.key < b.key;
+    }
+
+    // MSD radix sort on the leading byte of the keys, then the buckets are
+    // sorted independently in parallel. Keys in the trie are mostly hashes,
+    // so the buckets are evenly sized.
+    void sort_by_key(std::vector<Update> &updates)
+    {
+        if (updates.size() < PARALLEL_SORT_THRESHOLD) {
+            std::sort(updates.begin(), updates.end(), key_less);
+            return;
+        }
+        MONAD_ASSERT(updates.size() <= std::numeric_limits<uint32_t>::max());
+
+        std::array<uint32_t, NUM_BUCKETS + 1> offsets{};
+        for (Update const &update : updates) {
+            ++offsets[bucket_of(update.key) + 1];
+        }
+        for (unsigned i = 0; i < NUM_BUCKETS; ++i) {
+            offsets[i + 1] += offsets[i];
+        }
+        std::vector<uint32_t> order(updates.size());
+        auto next = offsets;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(updates.size()); ++i) {
+            order[next[bucket_of(updates[i].key)]++] = i;
+        }
+
+        tbb::parallel_for(
+            tbb::blocked_range<unsigned>{0, NUM_BUCKETS},
+            [&](tbb::blocked_range<unsigned> const &range) {
+                for (unsigned b = range.begin(); b != range.end(); ++b) {
+                    std::sort(
+                        order.begin() + offsets[b],
+                        order.begin() + offsets[b + 1],
+                        [&](uint32_t const i, uint32_t const j) {
+                            return key_less(updates[i], updates[j]);
+                        });
+                }
+            });
+
+        std::vector<Update> sorted;
+        sorted.reserve(updates.size());
+        for (uint32_t const i : order) {
+            sorted.emplace_back(std::move(updates[i]));
+        }
+        updates = std::move(sorted);
+    }
+}
+
+UpdateList UpdateBatch::finalize()
+{
+    MONAD_ASSERT(!finalized_);
+    finalized_ = true;
+
+    sort_by_key(updates_);
+
+    UpdateList list;
+    for (auto it = updates_.rbegin(); it != updates_.rend(); ++it) {
+        MONAD_ASSERT(it->key.nibble_size() != 0);
+        MONAD_ASSERT(
+            it == updates_.rbegin() || it->key != std::prev(it)->key,
+            "Invalid update batch: duplicate key");
+        it->in_batch = true;
+        list.push_front(*it);
+    }
+    return list;
+}
+
+MONAD_MPT_NAMESPACE_END
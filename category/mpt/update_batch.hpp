@@ -0,0 +1,74 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <category/mpt/config.hpp>
+#include <category/mpt/update.hpp>
+
+#include <cstddef>
+#include <vector>
+
+MONAD_MPT_NAMESPACE_BEGIN
+
+// Updates to one level of the trie, e.g. the accounts of a block or the
+// storage slots of one account, stored in a single contiguous array.
+//
+// `finalize()` sorts the array by key once and links it in key order. Every
+// sublist the upsert derives from that list is then a subrange of the array,
+// so `Requests` partitions it at each nibble by binary search and constant
+// time splices, instead of relinking every update at every level of the trie.
+//
+// Keys must be unique within a batch. The batch owns the update nodes: it
+// must outlive the upsert, cannot grow once finalized, and the finalized list
+// must be passed to the upsert as is (it may be the `next` list of another
+// update) rather than merged into another list.
+class UpdateBatch
+{
+    std::vector<Update> updates_;
+    bool finalized_{false};
+
+public:
+    UpdateBatch() = default;
+    UpdateBatch(UpdateBatch &&) = default;
+    UpdateBatch(UpdateBatch const &) = delete;
+    UpdateBatch &operator=(UpdateBatch const &) = delete;
+    UpdateBatch &operator=(UpdateBatch &&) = delete;
+
+    void reserve(size_t const n)
+    {
+        updates_.reserve(n);
+    }
+
+    Update &push_back(Update &&update)
+    {
+        MONAD_ASSERT(!finalized_);
+        return updates_.emplace_back(std::move(update));
+    }
+
+    size_t size() const noexcept
+    {
+        return updates_.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return updates_.empty();
+    }
+
+    UpdateList finalize();
+};
+
+MONAD_MPT_NAMESPACE_END
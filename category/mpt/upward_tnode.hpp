@@ -22,6 +22,7 @@
 #include <category/mpt/node.hpp>
 #include <category/mpt/util.hpp>
 
+#include <cstddef>
 #include <optional>
 #include <vector>
 
@@ -169,6 +170,28 @@ inline tnode_unique_ptr make_tnode(
 static_assert(sizeof(UpdateTNode) == 104);
 static_assert(alignof(UpdateTNode) == 8);
 
+// Nodes below a nested trie, e.g. the storage of an account, that compaction
+// has rewritten but not written yet. They are written back to back once the
+// nested trie is done, so the nested trie lands on disk in one extent instead
+// of interleaved with other subtries in the order their reads complete.
+struct CompactCluster
+{
+    struct PendingWrite
+    {
+        Node::SharedPtr node;
+        Node *parent;
+        uint8_t index;
+        bool rewrite_to_fast;
+        bool cache_node;
+    };
+
+    // Bounds the memory held back by a large nested trie, which is then
+    // written in runs of this many nodes
+    static constexpr size_t MAX_PENDING = 1024;
+
+    std::vector<PendingWrite> pending;
+};
+
 struct CompactTNode : public UpwardTreeNodeBase<CompactTNode>
 {
     using Base = UpwardTreeNodeBase<CompactTNode>;
@@ -183,7 +206,11 @@ struct CompactTNode : public UpwardTreeNodeBase<CompactTNode>
     value is either the node is currently cached in memory or its node is child
     of an update tnode. */
     bool const cache_node{false};
+    // Set on the node that owns `cluster`, which all the compacted nodes
+    // below it share
+    bool owns_cluster{false};
     Node::SharedPtr node{nullptr};
+    CompactCluster *cluster{nullptr};
 
     template <any_tnode Parent>
     CompactTNode(
@@ -232,7 +259,7 @@ struct CompactTNode : public UpwardTreeNodeBase<CompactTNode>
     }
 };
 
-static_assert(sizeof(CompactTNode) == 32);
+static_assert(sizeof(CompactTNode) == 40);
 static_assert(alignof(CompactTNode) == 8);
 
 struct ExpireTNode : public UpdateExpireCommonStorage<ExpireTNode>
@@ -18,15 +18,18 @@
 #include <category/core/assert.h>
 #include <category/core/byte_string.hpp>
 #include <category/core/bytes.hpp>
+#include <category/core/bytes_hash_compare.hpp>
 #include <category/core/fiber/fiber_group.hpp>
 #include <category/core/fiber/fiber_thread_pool.hpp>
 #include <category/core/fiber/priority_pool.hpp>
 #include <category/core/int.hpp>
 #include <category/core/keccak.hpp>
 #include <category/core/likely.h>
+#include <category/core/lru/lru_cache.hpp>
 #include <category/core/lru/static_lru_cache.hpp>
 #include <category/core/monad_exception.hpp>
 #include <category/core/result.hpp>
+#include <category/core/synchronization/spin_lock.hpp>
 #include <category/execution/ethereum/block_hash_buffer.hpp>
 #include <category/execution/ethereum/chain/chain_config.h>
 #include <category/execution/ethereum/chain/ethereum_mainnet.hpp>
@@ -49,6 +52,7 @@
 #include <category/execution/ethereum/trace/rlp/call_frame_rlp.hpp>
 #include <category/execution/ethereum/trace/state_tracer.hpp>
 #include <category/execution/ethereum/trace/tracer_config.h>
+#include <category/execution/ethereum/transaction_gas.hpp>
 #include <category/execution/ethereum/tx_context.hpp>
 #include <category/execution/ethereum/types/incarnation.hpp>
 #include <category/execution/ethereum/validate_transaction.hpp>
@@ -65,9 +69,12 @@
 #include <category/vm/vm.hpp>
 
 #include <boost/fiber/future/promise.hpp>
+#include <boost/fiber/operations.hpp>
 #include <boost/outcome/try.hpp>
 #include <boost/scope_exit.hpp>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -76,6 +83,7 @@
 #include <filesystem>
 #include <format>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <span>
 #include <string>
@@ -119,22 +127,41 @@ namespace
     // which lazily loads the block header from the DB and computes BLOCKHASH.
     // historical can always query from the finalized prefix.
     //
-    // A thread-safe LRU is not needed. Each submitted call to the executor pool
-    // creates its own LazyBlockHash instance.
+    // An instance is shared by every call executing at the same block, so it
+    // is thread-safe: each of the 256 entries is filled at most once, and a
+    // reader finding an entry being filled by another fiber yields until it
+    // is ready.
     class LazyBlockHash : public BlockHashBuffer
     {
         using BlockHashBuffer::N;
 
+        enum class Entry : uint8_t
+        {
+            empty,
+            filling,
+            ready
+        };
+
         mpt::RODb const &db_;
         uint64_t const n_;
-        using Cache = static_lru_cache<uint64_t, bytes32_t>;
-        mutable Cache blockhash_cache_;
+        mutable std::array<bytes32_t, N> hashes_{};
+        mutable std::array<std::atomic<Entry>, N> entries_{};
+
+        bytes32_t load(uint64_t const n) const
+        {
+            auto const cursor_res = db_.find(
+                mpt::concat(
+                    FINALIZED_NIBBLE, mpt::NibblesView{block_header_nibbles}),
+                n);
+            MONAD_ASSERT_THROW(
+                !cursor_res.has_error(), "blockhash: error querying DB");
+            return to_bytes(keccak256(cursor_res.value().node->value()));
+        }
 
     public:
         LazyBlockHash(mpt::RODb const &db, uint64_t const n)
             : db_{db}
             , n_{n}
-            , blockhash_cache_{N}
         {
         }
 
@@ -148,20 +175,122 @@ namespace
         bytes32_t const &get(uint64_t const n) const override
         {
             MONAD_ASSERT_PRINTF(n < n_ && n + N >= n_, "n_=%lu, n=%lu", n_, n);
-            if (Cache::ConstAccessor acc; blockhash_cache_.find(acc, n)) {
+            auto &entry = entries_[n % N];
+            auto state = entry.load(std::memory_order_acquire);
+            while (state != Entry::ready) {
+                if (state == Entry::filling) {
+                    boost::this_fiber::yield();
+                    state = entry.load(std::memory_order_acquire);
+                }
+                else if (entry.compare_exchange_weak(
+                             state,
+                             Entry::filling,
+                             std::memory_order_acquire)) {
+                    try {
+                        hashes_[n % N] = load(n);
+                    }
+                    catch (...) {
+                        entry.store(Entry::empty, std::memory_order_release);
+                        throw;
+                    }
+                    entry.store(Entry::ready, std::memory_order_release);
+                    break;
+                }
+            }
+            return hashes_[n % N];
+        }
+    };
+
+    // Per-block resources shared by every eth_call executing at the same
+    // (block number, block id): the resolved block prefix cursor and the
+    // blockhash window. Calls hold a reference to the context while they
+    // execute; the executor keeps the most recently used ones alive.
+    struct EthCallBlockContext
+    {
+        uint64_t block_number;
+        bytes32_t block_id;
+        mpt::NodeCursor prefix_cursor;
+        LazyBlockHash block_hash_buffer;
+
+        EthCallBlockContext(
+            mpt::RODb &db, uint64_t const block_number,
+            bytes32_t const &block_id)
+            : block_number{block_number}
+            , block_id{block_id}
+            , prefix_cursor{[&] {
+                TrieRODb tdb{db};
+                tdb.set_block_and_prefix(block_number, block_id);
+                return tdb.prefix_cursor();
+            }()}
+            , block_hash_buffer{db, block_number}
+        {
+        }
+    };
+
+    class EthCallBlockContexts
+    {
+        static constexpr size_t MAX_CONTEXTS = 64;
+
+        struct Key
+        {
+            uint64_t block_number;
+            bytes32_t block_id;
+
+            bool operator==(Key const &) const = default;
+        };
+
+        static_assert(sizeof(Key) == sizeof(uint64_t) + sizeof(bytes32_t));
+
+        struct KeyHash
+        {
+            using is_avalanching = void;
+
+            uint64_t operator()(Key const &key) const noexcept
+            {
+                return ankerl::unordered_dense::detail::wyhash::hash(
+                    &key, sizeof(Key));
+            }
+        };
+
+        using Cache = static_lru_cache<
+            Key, std::shared_ptr<EthCallBlockContext const>, KeyHash>;
+
+        mpt::RODb &db_;
+        SpinLock lock_;
+        Cache contexts_{MAX_CONTEXTS};
+
+        std::shared_ptr<EthCallBlockContext const> find(Key const &key)
+        {
+            std::lock_guard const guard{lock_};
+            if (Cache::ConstAccessor acc; contexts_.find(acc, key)) {
                 return acc->second->val;
             }
+            return nullptr;
+        }
 
-            auto const cursor_res = db_.find(
-                mpt::concat(
-                    FINALIZED_NIBBLE, mpt::NibblesView{block_header_nibbles}),
-                n);
-            MONAD_ASSERT_THROW(
-                !cursor_res.has_error(), "blockhash: error querying DB");
-            bytes32_t const blockhash =
-                to_bytes(keccak256(cursor_res.value().node->value()));
-            auto const res = blockhash_cache_.insert(n, blockhash);
-            return res.first->second->val;
+    public:
+        explicit EthCallBlockContexts(mpt::RODb &db)
+            : db_{db}
+        {
+        }
+
+        std::shared_ptr<EthCallBlockContext const>
+        get(uint64_t const block_number, bytes32_t const &block_id)
+        {
+            Key const key{.block_number = block_number, .block_id = block_id};
+            if (auto context = find(key)) {
+                return context;
+            }
+            // Resolve the prefix outside the lock. If another call raced us
+            // to it, use theirs so that the blockhash window is shared.
+            auto context = std::make_shared<EthCallBlockContext const>(
+                db_, block_number, block_id);
+            std::lock_guard const guard{lock_};
+            if (Cache::ConstAccessor acc; contexts_.find(acc, key)) {
+                return acc->second->val;
+            }
+            contexts_.insert(key, context);
+            return context;
         }
     };
 
@@ -235,104 +364,168 @@ namespace
         }
     }
 
-    template <Traits traits>
-    Result<evmc::Result> eth_call_impl(
-        Chain const &chain, Transaction const &txn, BlockHeader const &header,
-        uint64_t const block_number, bytes32_t const &block_id,
-        Address const &sender,
-        std::vector<std::optional<Address>> const &authorities, TrieRODb &tdb,
-        vm::VM &vm, BlockHashBuffer const &buffer,
-        monad_state_override const &state_overrides,
-        CallTracerBase &call_tracer, trace::StateTracer &state_tracer)
+    void apply_state_overrides(
+        BlockState &block_state, Incarnation const incarnation,
+        monad_state_override const &state_overrides)
     {
-        Transaction enriched_txn{txn};
+        State state{block_state, incarnation};
 
-        // static_validate_transaction checks sender's signature and chain_id.
-        // However, eth_call doesn't have signature (it can be simulated from
-        // any account). Solving this issue by setting chain_id and signature to
-        // complied values
-        enriched_txn.sc.chain_id = chain.get_chain_id();
-        enriched_txn.sc.r = 1;
-        enriched_txn.sc.s = 1;
+        for (auto const &[address, state_delta] :
+             state_overrides.override_sets) {
+            // This would avoid seg-fault on storage override for
+            // non-existing accounts
+            if (MONAD_UNLIKELY(!state.account_exists(address))) {
+                state.create_contract(address);
+            }
 
-        BOOST_OUTCOME_TRY(static_validate_transaction<traits>(
-            enriched_txn,
-            header.base_fee_per_gas,
-            header.excess_blob_gas,
-            chain.get_chain_id()));
+            if (state_delta.balance.has_value()) {
+                uint256_t const balance = state_delta.balance.value();
+                uint256_t const pessimistic_balance =
+                    state.get_balance(address);
+                if (balance > pessimistic_balance) {
+                    state.add_to_balance(
+                        address, balance - pessimistic_balance);
+                }
+                else {
+                    state.subtract_from_balance(
+                        address, pessimistic_balance - balance);
+                }
+            }
 
-        tdb.set_block_and_prefix(block_number, block_id);
-        BlockState block_state{tdb, vm};
-        // avoid conflict with block reward txn
-        Incarnation const incarnation{block_number, Incarnation::LAST_TX - 1u};
-        {
-            State state{block_state, incarnation};
+            if (state_delta.nonce.has_value()) {
+                state.set_nonce(address, state_delta.nonce.value());
+            }
 
-            for (auto const &[address, state_delta] :
-                 state_overrides.override_sets) {
-                // This would avoid seg-fault on storage override for
-                // non-existing accounts
-                if (MONAD_UNLIKELY(!state.account_exists(address))) {
-                    state.create_contract(address);
-                }
+            if (state_delta.code.has_value()) {
+                state.set_code(address, state_delta.code.value());
+            }
 
-                if (state_delta.balance.has_value()) {
-                    uint256_t const balance = state_delta.balance.value();
-                    uint256_t const pessimistic_balance =
-                        state.get_balance(address);
-                    if (balance > pessimistic_balance) {
-                        state.add_to_balance(
-                            address, balance - pessimistic_balance);
-                    }
-                    else {
-                        state.subtract_from_balance(
-                            address, pessimistic_balance - balance);
+            auto const update_state =
+                [&address = address, &state = state](
+                    ankerl::unordered_dense::
+                        segmented_map<bytes32_t, bytes32_t> const &diff) {
+                    for (auto const &[key, value] : diff) {
+                        state.set_storage(address, key, value);
                     }
-                }
+                };
 
-                if (state_delta.nonce.has_value()) {
-                    state.set_nonce(address, state_delta.nonce.value());
-                }
+            // Remove single storage
+            if (!state_delta.state_diff.empty()) {
+                // we need to access the account first before accessing its
+                // storage
+                (void)state.get_nonce(address);
+                update_state(state_delta.state_diff);
+            }
 
-                if (state_delta.code.has_value()) {
-                    state.set_code(address, state_delta.code.value());
-                }
+            // Remove all override
+            if (!state_delta.state.empty()) {
+                state.set_to_state_incarnation(address);
+                update_state(state_delta.state);
+            }
+        }
+        MONAD_ASSERT(block_state.can_merge(state));
+        block_state.merge(state);
+    }
 
-                auto const update_state =
-                    [&address = address, &state = state](
-                        ankerl::unordered_dense::
-                            segmented_map<bytes32_t, bytes32_t> const &diff) {
-                        for (auto const &[key, value] : diff) {
-                            state.set_storage(address, key, value);
-                        }
-                    };
-
-                // Remove single storage
-                if (!state_delta.state_diff.empty()) {
-                    // we need to access the account first before accessing its
-                    // storage
-                    (void)state.get_nonce(address);
-                    update_state(state_delta.state_diff);
-                }
+    // The state an eth_call executes against: the shared block context, and
+    // a block state with the overrides applied. Everything read from the trie
+    // is kept in the block state, so executions that share one instance (gas
+    // estimation iterations, or the high gas retry of a call that ran out of
+    // gas in the low gas pool) only read each account and slot from the
+    // database once.
+    class EthCallReadCache
+    {
+        EthCallBlockContexts &contexts_;
+        vm::VM &vm_;
+        uint64_t const block_number_;
+        bytes32_t const block_id_;
+        monad_state_override const &state_overrides_;
+        std::shared_ptr<EthCallBlockContext const> context_;
+        TrieRODb tdb_;
+        std::optional<BlockState> block_state_;
+        std::chrono::nanoseconds setup_time_{0};
+
+        EthCallBlockContext const &context()
+        {
+            if (!context_) {
+                context_ = contexts_.get(block_number_, block_id_);
+            }
+            return *context_;
+        }
 
-                // Remove all override
-                if (!state_delta.state.empty()) {
-                    state.set_to_state_incarnation(address);
-                    update_state(state_delta.state);
-                }
+    public:
+        EthCallReadCache(
+            EthCallBlockContexts &contexts, mpt::RODb &db, vm::VM &vm,
+            uint64_t const block_number, bytes32_t const &block_id,
+            monad_state_override const &state_overrides)
+            : contexts_{contexts}
+            , vm_{vm}
+            , block_number_{block_number}
+            , block_id_{block_id}
+            , state_overrides_{state_overrides}
+            , tdb_{db}
+        {
+        }
+
+        EthCallReadCache(EthCallReadCache const &) = delete;
+        EthCallReadCache &operator=(EthCallReadCache const &) = delete;
+
+        // avoid conflict with block reward txn
+        Incarnation incarnation() const
+        {
+            return Incarnation{block_number_, Incarnation::LAST_TX - 1u};
+        }
+
+        BlockHashBuffer const &block_hash_buffer()
+        {
+            return context().block_hash_buffer;
+        }
+
+        // The database is only touched on first use, so that calls which
+        // fail static validation do no I/O.
+        BlockState &block_state()
+        {
+            if (!block_state_.has_value()) {
+                auto const begin = std::chrono::steady_clock::now();
+                tdb_.set_block_and_prefix_cursor(
+                    block_number_, context().prefix_cursor);
+                block_state_.emplace(tdb_, vm_);
+                apply_state_overrides(
+                    *block_state_, incarnation(), state_overrides_);
+                setup_time_ += std::chrono::steady_clock::now() - begin;
             }
-            MONAD_ASSERT(block_state.can_merge(state));
-            block_state.merge(state);
+            return *block_state_;
         }
-        State state{block_state, incarnation};
 
-        // validate_transaction expects nonce to match.
-        // However, eth_call doesn't take a nonce parameter.
-        // Solving the issue by manually setting nonce to match with the
-        // expected nonce
-        enriched_txn.nonce = state.get_nonce(sender);
+        // Whether the block state has been prepared, i.e. whether an earlier
+        // execution has already read through this instance
+        bool prepared() const
+        {
+            return block_state_.has_value();
+        }
+
+        // Time spent acquiring the block context and preparing the block
+        // state since the last call
+        std::chrono::nanoseconds take_setup_time()
+        {
+            return std::exchange(setup_time_, std::chrono::nanoseconds{0});
+        }
+    };
 
-        // Safe to pass empty code to validation here because the above override
+    // Executes `enriched_txn` against `block_state` without merging the
+    // result back. The reads performed are cached in `block_state`, so
+    // repeated executions at the same block (e.g. when estimating gas) only
+    // go to the database for state they have not touched before.
+    template <Traits traits>
+    Result<evmc::Result> execute_eth_call(
+        Chain const &chain, Transaction const &enriched_txn,
+        BlockHeader const &header, Address const &sender,
+        std::vector<std::optional<Address>> const &authorities,
+        BlockState &block_state, Incarnation const incarnation,
+        BlockHashBuffer const &buffer, CallTracerBase &call_tracer,
+        trace::StateTracer &state_tracer)
+    {
+        // Safe to pass empty code to validation here because the override
         // will always mark this transaction as coming from an EOA.
         {
             State state{block_state, incarnation};
@@ -345,6 +538,8 @@ namespace
                 validate_transaction<traits>(enriched_txn, sender, state));
         }
 
+        State state{block_state, incarnation};
+
         auto const senders = std::vector{sender};
         auto const authorities_vec =
             std::vector<std::vector<std::optional<Address>>>{{authorities}};
@@ -392,31 +587,199 @@ namespace
         return execution_result;
     }
 
+    Transaction
+    make_enriched_transaction(Chain const &chain, Transaction const &txn)
+    {
+        Transaction enriched_txn{txn};
+
+        // static_validate_transaction checks sender's signature and chain_id.
+        // However, eth_call doesn't have signature (it can be simulated from
+        // any account). Solving this issue by setting chain_id and signature to
+        // complied values
+        enriched_txn.sc.chain_id = chain.get_chain_id();
+        enriched_txn.sc.r = 1;
+        enriched_txn.sc.s = 1;
+        return enriched_txn;
+    }
+
+    template <Traits traits>
+    Result<evmc::Result> eth_call_impl(
+        Chain const &chain, Transaction const &txn, BlockHeader const &header,
+        Address const &sender,
+        std::vector<std::optional<Address>> const &authorities,
+        EthCallReadCache &read_cache, CallTracerBase &call_tracer,
+        trace::StateTracer &state_tracer)
+    {
+        Transaction enriched_txn = make_enriched_transaction(chain, txn);
+
+        BOOST_OUTCOME_TRY(static_validate_transaction<traits>(
+            enriched_txn,
+            header.base_fee_per_gas,
+            header.excess_blob_gas,
+            chain.get_chain_id()));
+
+        BlockState &block_state = read_cache.block_state();
+        Incarnation const incarnation = read_cache.incarnation();
+
+        // validate_transaction expects nonce to match.
+        // However, eth_call doesn't take a nonce parameter.
+        // Solving the issue by manually setting nonce to match with the
+        // expected nonce
+        enriched_txn.nonce = State{block_state, incarnation}.get_nonce(sender);
+
+        return execute_eth_call<traits>(
+            chain,
+            enriched_txn,
+            header,
+            sender,
+            authorities,
+            block_state,
+            incarnation,
+            read_cache.block_hash_buffer(),
+            call_tracer,
+            state_tracer);
+    }
+
+    struct EstimateGasResult
+    {
+        // Result of the execution at the gas limit cap. Its status is returned
+        // to the caller when the transaction cannot succeed at all.
+        evmc::Result result;
+        uint64_t gas_estimate;
+        uint32_t iterations;
+    };
+
+    // Binary search for the lowest gas limit at which the transaction
+    // succeeds, using the same accuracy/termination rules as geth. All
+    // executions share one BlockState, so state is read from the database at
+    // most once per estimate.
+    template <Traits traits>
+    Result<EstimateGasResult> eth_estimate_gas_impl(
+        Chain const &chain, Transaction const &txn, BlockHeader const &header,
+        Address const &sender,
+        std::vector<std::optional<Address>> const &authorities,
+        EthCallReadCache &read_cache)
+    {
+        // Stop searching once the interval is within 1.5% of the upper bound
+        constexpr uint64_t error_ratio_permille = 15;
+        // Gas stipend given to value-transferring sub-calls
+        constexpr uint64_t call_stipend = 2300;
+
+        Transaction enriched_txn = make_enriched_transaction(chain, txn);
+        uint64_t const cap = txn.gas_limit;
+
+        BOOST_OUTCOME_TRY(static_validate_transaction<traits>(
+            enriched_txn,
+            header.base_fee_per_gas,
+            header.excess_blob_gas,
+            chain.get_chain_id()));
+
+        BlockState &block_state = read_cache.block_state();
+        Incarnation const incarnation = read_cache.incarnation();
+        enriched_txn.nonce = State{block_state, incarnation}.get_nonce(sender);
+
+        NoopCallTracer call_tracer;
+        trace::StateTracer state_tracer{std::monostate{}};
+        uint32_t iterations = 0;
+        auto const run = [&](uint64_t const gas_limit) -> Result<evmc::Result> {
+            ++iterations;
+            enriched_txn.gas_limit = gas_limit;
+            BOOST_OUTCOME_TRY(static_validate_transaction<traits>(
+                enriched_txn,
+                header.base_fee_per_gas,
+                header.excess_blob_gas,
+                chain.get_chain_id()));
+            return execute_eth_call<traits>(
+                chain,
+                enriched_txn,
+                header,
+                sender,
+                authorities,
+                block_state,
+                incarnation,
+                read_cache.block_hash_buffer(),
+                call_tracer,
+                state_tracer);
+        };
+        auto const succeeds = [&](uint64_t const gas_limit) {
+            auto const res = run(gas_limit);
+            return res.has_value() && res.value().status_code == EVMC_SUCCESS;
+        };
+
+        BOOST_OUTCOME_TRY(auto cap_result, run(cap));
+        if (cap_result.status_code != EVMC_SUCCESS) {
+            return EstimateGasResult{
+                .result = std::move(cap_result),
+                .gas_estimate = cap,
+                .iterations = iterations};
+        }
+
+        // Nothing below the gas actually consumed (net of refunds) can
+        // succeed, and most transactions succeed with a little headroom over
+        // what they consumed, so try that before bisecting.
+        uint64_t const consumed =
+            cap - static_cast<uint64_t>(cap_result.gas_left);
+        uint64_t const used_after_refund =
+            cap - static_cast<uint64_t>(cap_result.gas_refund);
+        uint64_t const intrinsic = intrinsic_gas<traits>(enriched_txn);
+        uint64_t lo =
+            std::max(std::min(consumed, used_after_refund), intrinsic) - 1;
+        uint64_t hi = cap;
+
+        uint64_t const optimistic = (consumed + call_stipend) * 64 / 63;
+        if (optimistic > lo && optimistic < hi) {
+            if (succeeds(optimistic)) {
+                hi = optimistic;
+            }
+            else {
+                lo = optimistic;
+            }
+        }
+
+        while (lo + 1 < hi) {
+            if (hi - lo < hi / 1000 * error_ratio_permille) {
+                break;
+            }
+            uint64_t mid = lo + (hi - lo) / 2;
+            // The estimate is usually close to the lower bound; bias the
+            // first probes towards it
+            if (mid / 2 > lo) {
+                mid = lo * 2;
+            }
+            if (succeeds(mid)) {
+                hi = mid;
+            }
+            else {
+                lo = mid;
+            }
+        }
+
+        return EstimateGasResult{
+            .result = std::move(cap_result),
+            .gas_estimate = hi,
+            .iterations = iterations};
+    }
+
     std::pair<
         std::vector<Address>, std::vector<std::vector<std::optional<Address>>>>
     recover_senders_and_authorities(
-        std::vector<Transaction> const &transactions)
+        std::vector<Transaction> const &transactions,
+        fiber::FiberGroup &fiber_group)
     {
+        // Batched across the block on the fibers of the group, the same way
+        // the block executor recovers them
+        auto const recovered_senders =
+            recover_senders(transactions, fiber_group);
         std::vector<Address> senders;
         senders.reserve(transactions.size());
-        for (auto const &txn : transactions) {
-            auto const sender = recover_sender(txn);
+        for (auto const &sender : recovered_senders) {
             MONAD_ASSERT_THROW(sender.has_value(), RECOVER_SENDER_ERR_MSG);
             senders.emplace_back(sender.value());
         }
 
-        std::vector<std::vector<std::optional<Address>>> authorities;
-        authorities.reserve(transactions.size());
-        for (auto const &txn : transactions) {
-            std::vector<std::optional<Address>> txn_authorities;
-            txn_authorities.reserve(txn.authorization_list.size());
-            for (auto const &auth : txn.authorization_list) {
-                txn_authorities.emplace_back(recover_authority(auth));
-            }
-            authorities.emplace_back(std::move(txn_authorities));
-        }
-
-        return {std::move(senders), authorities};
+        return {
+            std::move(senders),
+            recover_authorities(transactions, fiber_group)};
     }
 
     template <Traits traits>
@@ -744,6 +1107,12 @@ namespace
                 .queue_limit = limit,
                 .queue_full_count =
                     queue_full_count.load(std::memory_order_relaxed),
+                .setup_time_ns = setup_time_ns.load(std::memory_order_relaxed),
+                .setup_count = setup_count.load(std::memory_order_relaxed),
+                .resumed_count =
+                    resumed_count.load(std::memory_order_relaxed),
+                .predicted_count =
+                    predicted_count.load(std::memory_order_relaxed),
             };
         }
 
@@ -758,6 +1127,14 @@ namespace
             return true;
         }
 
+        void record_setup(std::chrono::nanoseconds const elapsed)
+        {
+            setup_time_ns.fetch_add(
+                static_cast<uint64_t>(elapsed.count()),
+                std::memory_order_relaxed);
+            setup_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
         Type type;
 
         // Maximum number of requests in the queue.
@@ -775,6 +1152,18 @@ namespace
         // Number of queue full conditions.
         std::atomic<uint64_t> queue_full_count{0};
 
+        // Total time spent preparing requests for execution, and the number
+        // of requests prepared.
+        std::atomic<uint64_t> setup_time_ns{0};
+        std::atomic<uint64_t> setup_count{0};
+
+        // Number of requests resumed from the state read by an earlier
+        // attempt.
+        std::atomic<uint64_t> resumed_count{0};
+
+        // Number of requests routed here by the high gas predictor.
+        std::atomic<uint64_t> predicted_count{0};
+
         // Underlying fiber pool.
         fiber::PriorityPool pool;
     };
@@ -803,6 +1192,10 @@ namespace
                 .queue_limit = limit,
                 .queue_full_count =
                     queue_full_count.load(std::memory_order_relaxed),
+                .setup_time_ns = 0,
+                .setup_count = 0,
+                .resumed_count = 0,
+                .predicted_count = 0,
             };
         }
 
@@ -835,6 +1228,59 @@ namespace
         // Underlying fiber group (references shared thread pool).
         std::unique_ptr<fiber::FiberGroup> group;
     };
+
+    // Remembers, per call site (callee and function selector), the gas used
+    // the last time a call without a specified gas limit ran in the high gas
+    // pool. Calls to sites that are known to need more than the low gas limit
+    // go straight to the high gas pool instead of failing in the low gas pool
+    // first.
+    class HighGasPredictor
+    {
+        static constexpr size_t SELECTOR_SIZE = 4;
+        static constexpr size_t MAX_CALL_SITES = 1 << 16;
+
+        struct CallSite
+        {
+            uint8_t bytes[sizeof(Address) + SELECTOR_SIZE]{};
+        };
+
+        using Cache = LruCache<CallSite, uint64_t, BytesHashCompare<CallSite>>;
+
+        Cache gas_used_{MAX_CALL_SITES};
+
+        static std::optional<CallSite> call_site(Transaction const &txn)
+        {
+            if (!txn.to.has_value()) {
+                return std::nullopt;
+            }
+            CallSite site;
+            std::memcpy(site.bytes, txn.to->bytes, sizeof(Address));
+            std::memcpy(
+                &site.bytes[sizeof(Address)],
+                txn.data.data(),
+                std::min(txn.data.size(), SELECTOR_SIZE));
+            return site;
+        }
+
+    public:
+        bool needs_high_gas(Transaction const &txn)
+        {
+            auto const site = call_site(txn);
+            if (!site.has_value()) {
+                return false;
+            }
+            Cache::ConstAccessor acc{};
+            return gas_used_.find(acc, *site) &&
+                   acc->second.value_ > MONAD_ETH_CALL_LOW_GAS_LIMIT;
+        }
+
+        void record(Transaction const &txn, uint64_t const gas_used)
+        {
+            if (auto const site = call_site(txn); site.has_value()) {
+                gas_used_.insert(*site, gas_used);
+            }
+        }
+    };
 }
 
 struct monad_executor
@@ -855,6 +1301,16 @@ struct monad_executor
 
     mpt::RODb db_;
 
+    // Chains are stateless, so one instance of each is shared by all requests
+    EthereumMainnet const ethereum_mainnet_{};
+    MonadDevnet const monad_devnet_{};
+    MonadTestnet const monad_testnet_{};
+    MonadMainnet const monad_mainnet_{};
+
+    EthCallBlockContexts block_contexts_{db_};
+
+    HighGasPredictor high_gas_predictor_;
+
     // The VM for executing eth calls needs to unconditionally use the
     // interpreter rather than the compiler. If it uses the compiler, then
     // out-of-gas errors can be misreported as generic failures.
@@ -902,6 +1358,29 @@ struct monad_executor
     monad_executor(monad_executor const &) = delete;
     monad_executor &operator=(monad_executor const &) = delete;
 
+    MonadChain const &get_monad_chain(monad_chain_config const chain_config)
+    {
+        switch (chain_config) {
+        case CHAIN_CONFIG_MONAD_DEVNET:
+            return monad_devnet_;
+        case CHAIN_CONFIG_MONAD_TESTNET:
+            return monad_testnet_;
+        case CHAIN_CONFIG_MONAD_MAINNET:
+            return monad_mainnet_;
+        case CHAIN_CONFIG_ETHEREUM_MAINNET:
+            break;
+        }
+        MONAD_ASSERT(false);
+    }
+
+    Chain const &get_chain(monad_chain_config const chain_config)
+    {
+        if (chain_config == CHAIN_CONFIG_ETHEREUM_MAINNET) {
+            return ethereum_mainnet_;
+        }
+        return get_monad_chain(chain_config);
+    }
+
     void execute_eth_call(
         monad_chain_config const chain_config, Transaction const &txn,
         BlockHeader const &block_header, Address const &sender,
@@ -912,10 +1391,15 @@ struct monad_executor
     {
         monad_executor_result *const result = new monad_executor_result();
 
-        Pool *pool =
-            gas_specified && txn.gas_limit > MONAD_ETH_CALL_LOW_GAS_LIMIT
-                ? &high_gas_pool_
-                : &low_gas_pool_;
+        bool const above_low_gas = txn.gas_limit > MONAD_ETH_CALL_LOW_GAS_LIMIT;
+        bool const predicted = above_low_gas && !gas_specified &&
+                               high_gas_predictor_.needs_high_gas(txn);
+        Pool *pool = (above_low_gas && gas_specified) || predicted
+                         ? &high_gas_pool_
+                         : &low_gas_pool_;
+        if (predicted) {
+            pool->predicted_count.fetch_add(1, std::memory_order_relaxed);
+        }
 
         submit_eth_call_to_pool(
             chain_config,
@@ -932,7 +1416,8 @@ struct monad_executor
             std::chrono::steady_clock::now(),
             call_seq_no_.fetch_add(1, std::memory_order_relaxed),
             result,
-            *pool);
+            *pool,
+            nullptr);
     }
 
     void submit_eth_call_to_pool(
@@ -944,7 +1429,7 @@ struct monad_executor
         monad_tracer_config const tracer_config, bool const gas_specified,
         std::chrono::steady_clock::time_point const call_begin,
         uint64_t const eth_call_seq_no, monad_executor_result *const result,
-        Pool &active_pool)
+        Pool &active_pool, std::unique_ptr<EthCallReadCache> read_cache)
     {
         if (!active_pool.try_enqueue()) {
             result->status_code = EVMC_REJECTED;
@@ -972,7 +1457,8 @@ struct monad_executor
              state_overrides = overrides,
              tracer_config = tracer_config,
              gas_specified = gas_specified,
-             active_pool = &active_pool] {
+             active_pool = &active_pool,
+             read_cache = std::move(read_cache)] mutable {
                 active_pool->queued_count.fetch_sub(
                     1, std::memory_order_relaxed);
                 active_pool->executing_count.fetch_add(
@@ -1013,23 +1499,23 @@ struct monad_executor
                         transaction.gas_limit = MONAD_ETH_CALL_LOW_GAS_LIMIT;
                     }
 
-                    auto const chain =
-                        [chain_config] -> std::unique_ptr<Chain> {
-                        switch (chain_config) {
-                        case CHAIN_CONFIG_ETHEREUM_MAINNET:
-                            return std::make_unique<EthereumMainnet>();
-                        case CHAIN_CONFIG_MONAD_DEVNET:
-                            return std::make_unique<MonadDevnet>();
-                        case CHAIN_CONFIG_MONAD_TESTNET:
-                            return std::make_unique<MonadTestnet>();
-                        case CHAIN_CONFIG_MONAD_MAINNET:
-                            return std::make_unique<MonadMainnet>();
-                        }
-                        MONAD_ASSERT(false);
-                    }();
+                    Chain const &chain = get_chain(chain_config);
 
-                    LazyBlockHash block_hash_buffer{db, block_number};
-                    TrieRODb tdb{db};
+                    // A retry resumes from the state read by the low gas
+                    // attempt
+                    if (read_cache && read_cache->prepared()) {
+                        active_pool->resumed_count.fetch_add(
+                            1, std::memory_order_relaxed);
+                    }
+                    if (!read_cache) {
+                        read_cache = std::make_unique<EthCallReadCache>(
+                            block_contexts_,
+                            db,
+                            vm_,
+                            block_number,
+                            block_id,
+                            *state_overrides);
+                    }
                     std::vector<CallFrame> call_frames;
                     nlohmann::json state_trace;
                     std::unique_ptr<CallTracerBase> call_tracer =
@@ -1061,48 +1547,38 @@ struct monad_executor
 
                     auto const res = [&]() -> Result<evmc::Result> {
                         if (chain_config == CHAIN_CONFIG_ETHEREUM_MAINNET) {
-                            evmc_revision const rev = chain->get_revision(
+                            evmc_revision const rev = chain.get_revision(
                                 block_header.number, block_header.timestamp);
                             SWITCH_EVM_TRAITS(
                                 eth_call_impl,
-                                *chain,
+                                chain,
                                 transaction,
                                 block_header,
-                                block_number,
-                                block_id,
                                 sender,
                                 authorities,
-                                tdb,
-                                vm_,
-                                block_hash_buffer,
-                                *state_overrides,
+                                *read_cache,
                                 *call_tracer,
                                 state_tracer);
                             MONAD_ASSERT(false);
                         }
                         else {
                             auto const rev =
-                                dynamic_cast<MonadChain *>(chain.get())
-                                    ->get_monad_revision(
-                                        block_header.timestamp);
+                                get_monad_chain(chain_config)
+                                    .get_monad_revision(block_header.timestamp);
                             SWITCH_MONAD_TRAITS(
                                 eth_call_impl,
-                                *chain,
+                                chain,
                                 transaction,
                                 block_header,
-                                block_number,
-                                block_id,
                                 sender,
                                 authorities,
-                                tdb,
-                                vm_,
-                                block_hash_buffer,
-                                *state_overrides,
+                                *read_cache,
                                 *call_tracer,
                                 state_tracer);
                             MONAD_ASSERT(false);
                         }
                     }();
+                    active_pool->record_setup(read_cache->take_setup_time());
 
                     if (override_with_low_gas_retry_if_oog &&
                         ((res.has_value() &&
@@ -1124,9 +1600,17 @@ struct monad_executor
                             tracer_config,
                             call_begin,
                             eth_call_seq_no,
-                            result);
+                            result,
+                            std::move(read_cache));
                         return;
                     }
+                    if (active_pool->type == Pool::Type::high &&
+                        !gas_specified && res.has_value()) {
+                        high_gas_predictor_.record(
+                            transaction,
+                            transaction.gas_limit -
+                                static_cast<uint64_t>(res.value().gas_left));
+                    }
                     if (MONAD_UNLIKELY(res.has_error())) {
                         result->status_code = EVMC_REJECTED;
                         result->message = strdup(res.error().message().c_str());
@@ -1217,7 +1701,8 @@ struct monad_executor
         void (*complete)(monad_executor_result *, void *user), void *const user,
         monad_tracer_config const tracer_config,
         std::chrono::steady_clock::time_point const call_begin,
-        auto const eth_call_seq_no, monad_executor_result *const result)
+        auto const eth_call_seq_no, monad_executor_result *const result,
+        std::unique_ptr<EthCallReadCache> read_cache)
     {
         // retry in high gas limit pool
         MONAD_ASSERT(orig_txn.gas_limit > MONAD_ETH_CALL_LOW_GAS_LIMIT);
@@ -1237,7 +1722,160 @@ struct monad_executor
             call_begin,
             eth_call_seq_no,
             result,
-            high_gas_pool_);
+            high_gas_pool_,
+            std::move(read_cache));
+    }
+
+    void submit_eth_estimate_gas_to_pool(
+        monad_chain_config const chain_config, Transaction const &txn,
+        BlockHeader const &block_header, Address const &sender,
+        uint64_t const block_number, bytes32_t const &block_id,
+        monad_state_override const *const overrides,
+        void (*complete)(monad_executor_result *, void *user), void *const user)
+    {
+        monad_executor_result *const result = new monad_executor_result();
+
+        // The search starts with an execution at the cap, so it needs a pool
+        // that can run the transaction at its full gas limit.
+        Pool &active_pool = txn.gas_limit > MONAD_ETH_CALL_LOW_GAS_LIMIT
+                                ? high_gas_pool_
+                                : low_gas_pool_;
+
+        if (!active_pool.try_enqueue()) {
+            result->status_code = EVMC_REJECTED;
+            result->message = strdup(EXCEED_QUEUE_SIZE_ERR_MSG);
+            MONAD_ASSERT(result->message);
+            complete(result, user);
+            return;
+        }
+
+        active_pool.pool.submit(
+            call_seq_no_.fetch_add(1, std::memory_order_relaxed),
+            [this,
+             call_begin = std::chrono::steady_clock::now(),
+             chain_config = chain_config,
+             txn = txn,
+             block_header = block_header,
+             block_number = block_number,
+             block_id = block_id,
+             &db = db_,
+             sender = sender,
+             result = result,
+             complete = complete,
+             user = user,
+             state_overrides = overrides,
+             active_pool = &active_pool] {
+                active_pool->queued_count.fetch_sub(
+                    1, std::memory_order_relaxed);
+                active_pool->executing_count.fetch_add(
+                    1, std::memory_order_relaxed);
+                BOOST_SCOPE_EXIT_ALL(&active_pool)
+                {
+                    active_pool->executing_count.fetch_sub(
+                        1, std::memory_order_relaxed);
+                };
+                try {
+                    if (std::chrono::steady_clock::now() - call_begin >
+                        active_pool->timeout) {
+                        result->status_code = EVMC_REJECTED;
+                        result->message = strdup(TIMEOUT_ERR_MSG);
+                        MONAD_ASSERT(result->message);
+                        complete(result, user);
+                        return;
+                    }
+
+                    std::vector<std::optional<Address>> authorities(
+                        txn.authorization_list.size());
+                    for (auto j = 0u; j < txn.authorization_list.size(); ++j) {
+                        authorities[j] =
+                            recover_authority(txn.authorization_list[j]);
+                    }
+
+                    Chain const &chain = get_chain(chain_config);
+                    EthCallReadCache read_cache{
+                        block_contexts_,
+                        db,
+                        vm_,
+                        block_number,
+                        block_id,
+                        *state_overrides};
+
+                    auto const res = [&]() -> Result<EstimateGasResult> {
+                        if (chain_config == CHAIN_CONFIG_ETHEREUM_MAINNET) {
+                            evmc_revision const rev = chain.get_revision(
+                                block_header.number, block_header.timestamp);
+                            SWITCH_EVM_TRAITS(
+                                eth_estimate_gas_impl,
+                                chain,
+                                txn,
+                                block_header,
+                                sender,
+                                authorities,
+                                read_cache);
+                            MONAD_ASSERT(false);
+                        }
+                        else {
+                            auto const rev =
+                                get_monad_chain(chain_config)
+                                    .get_monad_revision(block_header.timestamp);
+                            SWITCH_MONAD_TRAITS(
+                                eth_estimate_gas_impl,
+                                chain,
+                                txn,
+                                block_header,
+                                sender,
+                                authorities,
+                                read_cache);
+                            MONAD_ASSERT(false);
+                        }
+                    }();
+                    active_pool->record_setup(read_cache.take_setup_time());
+
+                    if (MONAD_UNLIKELY(res.has_error())) {
+                        result->status_code = EVMC_REJECTED;
+                        result->message = strdup(res.error().message().c_str());
+                        MONAD_ASSERT(result->message);
+                        complete(result, user);
+                        return;
+                    }
+
+                    // On success gas_used is the estimate; otherwise it is
+                    // the gas used by the failing execution at the cap, and
+                    // the output carries its revert data.
+                    auto const &estimate = res.assume_value();
+                    evmc::Result const &evmc_result = estimate.result;
+                    result->status_code = evmc_result.status_code;
+                    result->gas_used =
+                        evmc_result.status_code == EVMC_SUCCESS
+                            ? static_cast<int64_t>(estimate.gas_estimate)
+                            : static_cast<int64_t>(txn.gas_limit) -
+                                  evmc_result.gas_left;
+                    result->gas_refund = evmc_result.gas_refund;
+                    result->estimate_gas_iterations = estimate.iterations;
+                    if (evmc_result.output_size > 0) {
+                        result->output_data =
+                            new uint8_t[evmc_result.output_size];
+                        result->output_data_len = evmc_result.output_size;
+                        memcpy(
+                            (uint8_t *)result->output_data,
+                            evmc_result.output_data,
+                            evmc_result.output_size);
+                    }
+                    complete(result, user);
+                }
+                catch (MonadException const &e) {
+                    result->status_code = EVMC_INTERNAL_ERROR;
+                    result->message = strdup(e.message());
+                    MONAD_ASSERT(result->message);
+                    complete(result, user);
+                }
+                catch (...) {
+                    result->status_code = EVMC_INTERNAL_ERROR;
+                    result->message = strdup(UNEXPECTED_EXCEPTION_ERR_MSG);
+                    MONAD_ASSERT(result->message);
+                    complete(result, user);
+                }
+            });
     }
 
     void submit_eth_trace_block_or_transaction_to_pool(
@@ -1300,20 +1938,7 @@ struct monad_executor
                 fiber_group->executing_count.fetch_add(
                     1, std::memory_order_relaxed);
                 try {
-                    auto const chain =
-                        [chain_config] -> std::unique_ptr<Chain> {
-                        switch (chain_config) {
-                        case CHAIN_CONFIG_ETHEREUM_MAINNET:
-                            return std::make_unique<EthereumMainnet>();
-                        case CHAIN_CONFIG_MONAD_DEVNET:
-                            return std::make_unique<MonadDevnet>();
-                        case CHAIN_CONFIG_MONAD_TESTNET:
-                            return std::make_unique<MonadTestnet>();
-                        case CHAIN_CONFIG_MONAD_MAINNET:
-                            return std::make_unique<MonadMainnet>();
-                        }
-                        MONAD_ASSERT(false);
-                    }();
+                    Chain const &chain = get_chain(chain_config);
 
                     // Load transactions, senders, and authorities for
                     // `block_number`.
@@ -1332,7 +1957,8 @@ struct monad_executor
                     }
 
                     auto const &[senders, authorities] =
-                        recover_senders_and_authorities(transactions);
+                        recover_senders_and_authorities(
+                            transactions, *tx_exec_group->group);
 
                     auto const senders_and_authorities =
                         combine_senders_and_authorities(senders, authorities);
@@ -1354,7 +1980,8 @@ struct monad_executor
                             PARENT_TRANSACTIONS_CONTEXT_ERR_MSG);
                         auto const &[parent_senders, parent_authorities] =
                             recover_senders_and_authorities(
-                                parent_transactions.assume_value());
+                                parent_transactions.assume_value(),
+                                *tx_exec_group->group);
                         parent_senders_and_authorities = std::make_unique<
                             ankerl::unordered_dense::segmented_set<Address>>(
                             combine_senders_and_authorities(
@@ -1370,7 +1997,8 @@ struct monad_executor
                         auto const
                             &[grandparent_senders, grandparent_authorities] =
                                 recover_senders_and_authorities(
-                                    grandparent_transactions.assume_value());
+                                    grandparent_transactions.assume_value(),
+                                    *tx_exec_group->group);
                         grandparent_senders_and_authorities = std::make_unique<
                             ankerl::unordered_dense::segmented_set<Address>>(
                             combine_senders_and_authorities(
@@ -1394,41 +2022,41 @@ struct monad_executor
                     TrieRODb tdb{db};
                     tdb.set_block_and_prefix(block_number - 1, parent_id);
                     BlockState block_state{tdb, vm_};
-                    LazyBlockHash block_hash_buffer{db, block_number};
+                    auto const block_hash_buffer =
+                        std::make_unique<LazyBlockHash>(db, block_number);
 
                     auto const res = [&]() -> Result<nlohmann::json> {
                         if (chain_config == CHAIN_CONFIG_ETHEREUM_MAINNET) {
-                            evmc_revision const rev = chain->get_revision(
+                            evmc_revision const rev = chain.get_revision(
                                 block_header.number, block_header.timestamp);
                             SWITCH_EVM_TRAITS(
                                 eth_trace_block_or_transaction_impl,
-                                *chain,
+                                chain,
                                 chain_context,
                                 block_header,
                                 transactions,
                                 trace_transaction,
                                 transaction_index,
                                 block_state,
-                                block_hash_buffer,
+                                *block_hash_buffer,
                                 *tx_exec_group->group,
                                 tracer_config);
                             MONAD_ASSERT(false);
                         }
                         else {
                             auto const rev =
-                                dynamic_cast<MonadChain *>(chain.get())
-                                    ->get_monad_revision(
-                                        block_header.timestamp);
+                                get_monad_chain(chain_config)
+                                    .get_monad_revision(block_header.timestamp);
                             SWITCH_MONAD_TRAITS(
                                 eth_trace_block_or_transaction_impl,
-                                *chain,
+                                chain,
                                 chain_context,
                                 block_header,
                                 transactions,
                                 trace_transaction,
                                 transaction_index,
                                 block_state,
-                                block_hash_buffer,
+                                *block_hash_buffer,
                                 *tx_exec_group->group,
                                 tracer_config);
                             MONAD_ASSERT(false);
@@ -1560,6 +2188,57 @@ void monad_executor_eth_call_submit(
         gas_specified);
 }
 
+void monad_executor_eth_estimate_gas_submit(
+    monad_executor *const executor, monad_chain_config const chain_config,
+    uint8_t const *const rlp_txn, size_t const rlp_txn_len,
+    uint8_t const *const rlp_header, size_t const rlp_header_len,
+    uint8_t const *const rlp_sender, size_t const rlp_sender_len,
+    uint64_t const block_number, uint8_t const *const rlp_block_id,
+    size_t const rlp_block_id_len, monad_state_override const *const overrides,
+    void (*complete)(monad_executor_result *result, void *user),
+    void *const user)
+{
+    MONAD_ASSERT(executor);
+
+    byte_string_view rlp_tx_view({rlp_txn, rlp_txn_len});
+    byte_string_view rlp_header_view({rlp_header, rlp_header_len});
+    byte_string_view rlp_sender_view({rlp_sender, rlp_sender_len});
+    byte_string_view block_id_view({rlp_block_id, rlp_block_id_len});
+
+    auto const tx_result = rlp::decode_transaction(rlp_tx_view);
+    MONAD_ASSERT(!tx_result.has_error());
+    MONAD_ASSERT(rlp_tx_view.empty());
+    auto const &tx = tx_result.value();
+
+    auto const block_header_result = rlp::decode_block_header(rlp_header_view);
+    MONAD_ASSERT(!block_header_result.has_error());
+    MONAD_ASSERT(rlp_header_view.empty());
+    auto const &block_header = block_header_result.value();
+
+    auto const sender_result = rlp::decode_address(rlp_sender_view);
+    MONAD_ASSERT(!sender_result.has_error());
+    MONAD_ASSERT(rlp_sender_view.empty());
+    auto const sender = sender_result.value();
+
+    auto const block_id_result = rlp::decode_bytes32(block_id_view);
+    MONAD_ASSERT(!block_id_result.has_error());
+    MONAD_ASSERT(block_id_view.empty());
+    auto const block_id = block_id_result.value();
+
+    MONAD_ASSERT(overrides);
+
+    executor->submit_eth_estimate_gas_to_pool(
+        chain_config,
+        tx,
+        block_header,
+        sender,
+        block_number,
+        block_id,
+        overrides,
+        complete,
+        user);
+}
+
 struct monad_executor_state monad_executor_get_state(monad_executor *const e)
 {
     MONAD_ASSERT(e);
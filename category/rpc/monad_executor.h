@@ -74,6 +74,9 @@ typedef struct monad_executor_result
     // for trace (call, prestate, statediff)
     uint8_t *encoded_trace;
     size_t encoded_trace_len;
+
+    // for estimate gas, the number of executions used by the search
+    uint32_t estimate_gas_iterations;
 } monad_executor_result;
 
 void monad_executor_result_release(monad_executor_result *);
@@ -110,6 +113,18 @@ struct monad_executor_pool_state
 
     // Number of queue full conditions.
     uint64_t queue_full_count;
+
+    // Total time spent preparing requests for execution (block context and
+    // state setup), and the number of requests it covers.
+    uint64_t setup_time_ns;
+    uint64_t setup_count;
+
+    // Number of requests that resumed from the state read by their attempt
+    // in the low gas pool.
+    uint64_t resumed_count;
+
+    // Number of requests sent to this pool by the high gas predictor.
+    uint64_t predicted_count;
 };
 
 struct monad_executor_state
@@ -136,6 +151,18 @@ void monad_executor_eth_call_submit(
     void (*complete)(monad_executor_result *, void *user), void *user,
     enum monad_tracer_config, bool gas_specified);
 
+// Estimates the lowest gas limit, up to the transaction's gas limit, at which
+// the transaction succeeds. The search runs inside the executor and reuses
+// the state read by earlier iterations. On success, gas_used in the result is
+// the estimate; otherwise the result is that of the execution at the cap.
+void monad_executor_eth_estimate_gas_submit(
+    struct monad_executor *, enum monad_chain_config, uint8_t const *rlp_txn,
+    size_t rlp_txn_len, uint8_t const *rlp_header, size_t rlp_header_len,
+    uint8_t const *rlp_sender, size_t rlp_sender_len, uint64_t block_number,
+    uint8_t const *rlp_block_id, size_t rlp_block_id_len,
+    struct monad_state_override const *,
+    void (*complete)(monad_executor_result *, void *user), void *user);
+
 struct monad_executor_state monad_executor_get_state(struct monad_executor *);
 
 void monad_executor_run_transactions(
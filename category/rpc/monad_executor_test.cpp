@@ -908,6 +908,121 @@ TEST_F(EthCallFixture, loop_out_of_gas)
     monad_executor_destroy(executor);
 }
 
+TEST_F(EthCallFixture, estimate_gas_simple_transfer)
+{
+    for (uint64_t i = 0; i < 256; ++i) {
+        commit_sequential(tdb, {}, {}, BlockHeader{.number = i});
+    }
+
+    static constexpr auto from{
+        0xf8636377b7a998b51a3cf2bd711b870b3ab0ad56_address};
+    static constexpr auto to{
+        0x5353535353535353535353535353535353535353_address};
+
+    Transaction const tx{
+        .gas_limit = 1'000'000u, .to = to, .type = TransactionType::eip1559};
+    BlockHeader const header{.number = 256};
+
+    commit_sequential(tdb, {}, {}, header);
+
+    auto const rlp_tx = to_vec(rlp::encode_transaction(tx));
+    auto const rlp_header = to_vec(rlp::encode_block_header(header));
+    auto const rlp_sender =
+        to_vec(rlp::encode_address(std::make_optional(from)));
+    auto const rlp_block_id = to_vec(rlp_finalized_id);
+
+    auto *executor = create_executor(dbname.string());
+    auto *state_override = monad_state_override_create();
+
+    struct callback_context ctx;
+    boost::fibers::future<void> f = ctx.promise.get_future();
+    monad_executor_eth_estimate_gas_submit(
+        executor,
+        CHAIN_CONFIG_MONAD_DEVNET,
+        rlp_tx.data(),
+        rlp_tx.size(),
+        rlp_header.data(),
+        rlp_header.size(),
+        rlp_sender.data(),
+        rlp_sender.size(),
+        header.number,
+        rlp_block_id.data(),
+        rlp_block_id.size(),
+        state_override,
+        complete_callback,
+        (void *)&ctx);
+    f.get();
+
+    EXPECT_EQ(ctx.result->status_code, EVMC_SUCCESS);
+    EXPECT_EQ(ctx.result->encoded_trace_len, 0);
+    EXPECT_GE(ctx.result->gas_used, 21000);
+    // within the 1.5% search tolerance of the exact value
+    EXPECT_LE(ctx.result->gas_used, 21000 + 21000 * 15 / 1000 + 1);
+    EXPECT_GT(ctx.result->estimate_gas_iterations, 1);
+
+    monad_state_override_destroy(state_override);
+    monad_executor_destroy(executor);
+}
+
+TEST_F(EthCallFixture, estimate_gas_out_of_gas_at_cap)
+{
+    auto const code = 0x5B5F56_bytes;
+    auto const code_hash = to_bytes(keccak256(code));
+    auto const icode = monad::vm::make_shared_intercode(code);
+
+    auto const ca = 0xaaaf5374fce5edbc8e2a8697c15331677e6ebf0b_address;
+
+    commit_sequential(
+        tdb,
+        StateDeltas{
+            {ca,
+             StateDelta{
+                 .account =
+                     {std::nullopt,
+                      Account{.balance = 0x1b58, .code_hash = code_hash}}}}},
+        Code{{code_hash, icode}},
+        BlockHeader{.number = 0});
+
+    Transaction const tx{.gas_limit = 100000u, .to = ca, .data = {}};
+
+    BlockHeader const header{.number = 0};
+
+    auto const rlp_tx = to_vec(rlp::encode_transaction(tx));
+    auto const rlp_header = to_vec(rlp::encode_block_header(header));
+    auto const rlp_sender = to_vec(rlp::encode_address(std::make_optional(ca)));
+    auto const rlp_block_id = to_vec(rlp_finalized_id);
+
+    auto *executor = create_executor(dbname.string());
+    auto *state_override = monad_state_override_create();
+
+    struct callback_context ctx;
+    boost::fibers::future<void> f = ctx.promise.get_future();
+    monad_executor_eth_estimate_gas_submit(
+        executor,
+        CHAIN_CONFIG_MONAD_DEVNET,
+        rlp_tx.data(),
+        rlp_tx.size(),
+        rlp_header.data(),
+        rlp_header.size(),
+        rlp_sender.data(),
+        rlp_sender.size(),
+        header.number,
+        rlp_block_id.data(),
+        rlp_block_id.size(),
+        state_override,
+        complete_callback,
+        (void *)&ctx);
+    f.get();
+
+    // the search gives up after the execution at the cap fails
+    EXPECT_EQ(ctx.result->status_code, EVMC_OUT_OF_GAS);
+    EXPECT_EQ(ctx.result->gas_used, 100000u);
+    EXPECT_EQ(ctx.result->estimate_gas_iterations, 1);
+
+    monad_state_override_destroy(state_override);
+    monad_executor_destroy(executor);
+}
+
 TEST_F(EthCallFixture, expensive_read_out_of_gas)
 {
     auto const code =
@@ -1029,6 +1144,78 @@ TEST_F(EthCallFixture, expensive_read_out_of_gas)
     monad_executor_destroy(executor);
 }
 
+TEST_F(EthCallFixture, low_gas_retry_out_of_gas)
+{
+    auto const code = 0x5B5F56_bytes;
+    auto const code_hash = to_bytes(keccak256(code));
+    auto const icode = monad::vm::make_shared_intercode(code);
+
+    auto const ca = 0xaaaf5374fce5edbc8e2a8697c15331677e6ebf0b_address;
+
+    commit_sequential(
+        tdb,
+        StateDeltas{
+            {ca,
+             StateDelta{
+                 .account =
+                     {std::nullopt,
+                      Account{.balance = 0x1b58, .code_hash = code_hash}}}}},
+        Code{{code_hash, icode}},
+        BlockHeader{.number = 0});
+
+    Transaction const tx{.gas_limit = 30'000'000u, .to = ca, .data = {}};
+
+    BlockHeader const header{.number = 0};
+
+    auto const rlp_tx = to_vec(rlp::encode_transaction(tx));
+    auto const rlp_header = to_vec(rlp::encode_block_header(header));
+    auto const rlp_sender = to_vec(rlp::encode_address(std::make_optional(ca)));
+    auto const rlp_block_id = to_vec(rlp_finalized_id);
+
+    auto *executor = create_executor(dbname.string());
+    auto *state_override = monad_state_override_create();
+
+    // The first call runs out of gas in the low gas pool and is retried in
+    // the high gas pool, resuming from the state read by the low gas attempt.
+    // The second call to the same site is sent straight to the high gas pool
+    // by the predictor. Both must report the full gas limit.
+    for (uint64_t i = 0; i < 2; ++i) {
+        struct callback_context ctx;
+        boost::fibers::future<void> f = ctx.promise.get_future();
+        monad_executor_eth_call_submit(
+            executor,
+            CHAIN_CONFIG_MONAD_DEVNET,
+            rlp_tx.data(),
+            rlp_tx.size(),
+            rlp_header.data(),
+            rlp_header.size(),
+            rlp_sender.data(),
+            rlp_sender.size(),
+            header.number,
+            rlp_block_id.data(),
+            rlp_block_id.size(),
+            state_override,
+            complete_callback,
+            (void *)&ctx,
+            NOOP_TRACER,
+            false);
+        f.get();
+
+        EXPECT_EQ(ctx.result->status_code, EVMC_OUT_OF_GAS);
+        EXPECT_EQ(ctx.result->output_data_len, 0);
+        EXPECT_EQ(ctx.result->gas_used, 30'000'000u);
+
+        auto const state = monad_executor_get_state(executor);
+        EXPECT_EQ(state.low_gas_pool_state.setup_count, 1);
+        EXPECT_EQ(state.high_gas_pool_state.setup_count, i + 1);
+        EXPECT_EQ(state.high_gas_pool_state.resumed_count, 1);
+        EXPECT_EQ(state.high_gas_pool_state.predicted_count, i);
+    }
+
+    monad_state_override_destroy(state_override);
+    monad_executor_destroy(executor);
+}
+
 TEST_F(EthCallFixture, from_contract_account)
 {
     using namespace intx;
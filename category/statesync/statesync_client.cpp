@@ -104,6 +104,9 @@ void monad_statesync_client_handle_target(
     MONAD_ASSERT(std::ranges::all_of(
         ctx->protocol, [](auto const &ptr) { return ptr != nullptr; }))
 
+    // the latest version is read from the db below
+    ctx->wait_for_commit();
+
     byte_string_view raw{data, size};
     auto const res = rlp::decode_block_header(raw);
     MONAD_ASSERT(res.has_value());
@@ -152,6 +155,7 @@ void monad_statesync_client_handle_done(
 
     if (MONAD_UNLIKELY(monad_statesync_client_has_reached_target(ctx))) {
         ctx->commit();
+        ctx->wait_for_commit();
     }
 }
 
@@ -160,6 +164,7 @@ bool monad_statesync_client_finalize(monad_statesync_client_context *const ctx)
     auto const &tgrt = ctx->tgrt;
     MONAD_ASSERT(tgrt.number != INVALID_BLOCK_NUM);
     MONAD_ASSERT(ctx->deltas.empty());
+    ctx->wait_for_commit();
     if (!ctx->buffered.empty()) {
         // sent storage with no account
         return false;
@@ -13,21 +13,186 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <category/core/assert.h>
+#include <category/core/keccak.hpp>
 #include <category/execution/ethereum/core/block.hpp>
 #include <category/execution/ethereum/core/rlp/block_rlp.hpp>
+#include <category/execution/ethereum/db/key_bloom_filter.hpp>
 #include <category/execution/ethereum/db/util.hpp>
+#include <category/mpt/db.hpp>
+#include <category/mpt/node.hpp>
 #include <category/mpt/ondisk_db_config.hpp>
 #include <category/mpt/update.hpp>
 #include <category/statesync/statesync_client.h>
 #include <category/statesync/statesync_client_context.hpp>
 #include <category/statesync/statesync_protocol.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <bit>
+#include <cstddef>
 #include <deque>
+#include <optional>
 #include <sys/sysinfo.h>
+#include <utility>
+#include <variant>
+#include <vector>
 
 using namespace monad;
 using namespace monad::mpt;
 
+namespace
+{
+    // Only allocated when syncing into an empty db
+    constexpr size_t KEY_FILTER_BYTES = 256ul << 20;
+
+    using Batch = monad_statesync_client_context::Batch;
+    using StorageDeltas = monad_statesync_client_context::StorageDeltas;
+
+    struct EncodedAccount
+    {
+        hash256 key;
+        std::optional<byte_string> value;
+        std::vector<std::pair<hash256, std::optional<byte_string>>> storage;
+    };
+
+    // Keys are hashed and values encoded in parallel, then linked into the
+    // update lists, which must not move once built
+    Node::SharedPtr write_batch(
+        Db &db, Node::SharedPtr root, Batch const &batch,
+        uint64_t const version, KeyBloomFilter *const key_filter)
+    {
+        std::vector<decltype(batch.deltas)::value_type const *> items;
+        items.reserve(batch.deltas.size());
+        for (auto const &item : batch.deltas) {
+            items.push_back(&item);
+        }
+        std::vector<EncodedAccount> encoded(items.size());
+        std::vector<bytes32_t> code_hashes(batch.code.size());
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>{0, items.size()},
+            [&](tbb::blocked_range<size_t> const &range) {
+                for (size_t i = range.begin(); i < range.end(); ++i) {
+                    auto const &[addr, delta] = *items[i];
+                    auto &account = encoded[i];
+                    account.key = keccak256(addr.bytes);
+                    if (!delta.has_value()) {
+                        continue;
+                    }
+                    auto const &[acct, storage] = delta.value();
+                    account.value = encode_account_db(addr, acct);
+                    account.storage.reserve(storage.size());
+                    for (auto const &[key, val] : storage) {
+                        account.storage.emplace_back(
+                            keccak256(key.bytes),
+                            val == bytes32_t{}
+                                ? std::nullopt
+                                : std::make_optional(
+                                      encode_storage_db(key, val)));
+                    }
+                    if (key_filter) {
+                        key_filter->insert_account(account.key);
+                        for (auto const &[key, val] : account.storage) {
+                            if (val.has_value()) {
+                                key_filter->insert_storage(account.key, key);
+                            }
+                        }
+                    }
+                }
+            });
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>{0, batch.code.size()},
+            [&](tbb::blocked_range<size_t> const &range) {
+                for (size_t i = range.begin(); i < range.end(); ++i) {
+                    code_hashes[i] =
+                        std::bit_cast<bytes32_t>(keccak256(batch.code[i]));
+                }
+            });
+
+        std::deque<mpt::Update> alloc;
+        UpdateList accounts;
+        for (auto const &account : encoded) {
+            UpdateList storage;
+            for (auto const &[key, val] : account.storage) {
+                storage.push_front(alloc.emplace_back(Update{
+                    .key = key,
+                    .value = val.has_value()
+                                 ? std::make_optional<byte_string_view>(
+                                       val.value())
+                                 : std::nullopt,
+                    .incarnation = false,
+                    .next = UpdateList{},
+                    .version = static_cast<int64_t>(version)}));
+            }
+            accounts.push_front(alloc.emplace_back(Update{
+                .key = account.key,
+                .value = account.value.has_value()
+                             ? std::make_optional<byte_string_view>(
+                                   account.value.value())
+                             : std::nullopt,
+                .incarnation = false,
+                .next = std::move(storage),
+                .version = static_cast<int64_t>(version)}));
+        }
+        UpdateList code_updates;
+
+        // code is immutable once inserted, the same code may be sent twice
+        ankerl::unordered_dense::segmented_set<bytes32_t> code_seen;
+        for (size_t i = 0; i < batch.code.size(); ++i) {
+            if (!code_seen.emplace(code_hashes[i]).second) {
+                continue;
+            }
+            code_updates.push_front(alloc.emplace_back(Update{
+                .key = NibblesView{code_hashes[i]},
+                .value = batch.code[i],
+                .incarnation = false,
+                .next = UpdateList{},
+                .version = static_cast<int64_t>(version)}));
+        }
+
+        auto state_update = Update{
+            .key = state_nibbles,
+            .value = byte_string_view{},
+            .incarnation = false,
+            .next = std::move(accounts),
+            .version = static_cast<int64_t>(version)};
+        auto code_update = Update{
+            .key = code_nibbles,
+            .value = byte_string_view{},
+            .incarnation = false,
+            .next = std::move(code_updates),
+            .version = static_cast<int64_t>(version)};
+        auto const rlp = rlp::encode_block_header(batch.tgrt);
+        auto block_header_update = Update{
+            .key = block_header_nibbles,
+            .value = rlp,
+            .incarnation = true,
+            .next = UpdateList{},
+            .version = static_cast<int64_t>(version)};
+        UpdateList updates;
+        updates.push_front(state_update);
+        updates.push_front(code_update);
+        updates.push_front(block_header_update);
+
+        UpdateList finalized_updates;
+        Update finalized{
+            .key = finalized_nibbles,
+            .value = byte_string_view{},
+            .incarnation = false,
+            .next = std::move(updates),
+            .version = static_cast<int64_t>(version)};
+        finalized_updates.push_front(finalized);
+
+        return db.upsert(
+            std::move(root),
+            std::move(finalized_updates),
+            version,
+            false,
+            false);
+    }
+}
+
 monad_statesync_client_context::monad_statesync_client_context(
     std::vector<std::filesystem::path> const dbname_paths,
     std::optional<unsigned> const sq_thread_cpu,
@@ -52,96 +217,83 @@ monad_statesync_client_context::monad_statesync_client_context(
     , tgrt{BlockHeader{.number = mpt::INVALID_BLOCK_NUM}}
     , current{db.get_latest_version() == mpt::INVALID_BLOCK_NUM ? 0 : db.get_latest_version() + 1}
     , n_upserts{0}
+    , key_filter{
+          db.get_latest_version() == mpt::INVALID_BLOCK_NUM
+              ? std::make_unique<KeyBloomFilter>(KEY_FILTER_BYTES, 0)
+              : nullptr}
     , sync{sync}
     , statesync_send_request{statesync_send_request}
 {
     MONAD_ASSERT(db.get_latest_version() == db.get_latest_finalized_version());
 }
 
+monad_statesync_client_context::~monad_statesync_client_context()
+{
+    writer.wait();
+}
+
 void monad_statesync_client_context::commit()
 {
-    std::deque<mpt::Update> alloc;
-    std::deque<byte_string> bytes_alloc;
-    std::deque<hash256> hash_alloc;
-    UpdateList accounts;
-    for (auto const &[addr, delta] : deltas) {
-        UpdateList storage;
-        std::optional<byte_string_view> value;
-        if (delta.has_value()) {
-            auto const &[acct, deltas] = delta.value();
-            value = bytes_alloc.emplace_back(encode_account_db(addr, acct));
-            for (auto const &[key, val] : deltas) {
-                storage.push_front(alloc.emplace_back(Update{
-                    .key = hash_alloc.emplace_back(keccak256(key.bytes)),
-                    .value = val == bytes32_t{}
-                                 ? std::nullopt
-                                 : std::make_optional<byte_string_view>(
-                                       bytes_alloc.emplace_back(
-                                           encode_storage_db(key, val))),
-                    .incarnation = false,
-                    .next = UpdateList{},
-                    .version = static_cast<int64_t>(current)}));
-            }
-        }
-        accounts.push_front(alloc.emplace_back(Update{
-            .key = hash_alloc.emplace_back(keccak256(addr.bytes)),
-            .value = value,
-            .incarnation = false,
-            .next = std::move(storage),
-            .version = static_cast<int64_t>(current)}));
+    wait_for_commit();
+    writing.deltas = std::move(deltas);
+    writing.code = std::move(code);
+    writing.tgrt = tgrt;
+    writing.in_flight = true;
+    deltas.clear();
+    code.clear();
+    writer.run([this, root = tdb.get_root()] {
+        writing.root =
+            write_batch(db, root, writing, current, key_filter.get());
+    });
+}
+
+void monad_statesync_client_context::wait_for_commit()
+{
+    if (!writing.in_flight) {
+        return;
     }
-    UpdateList code_updates;
+    writer.wait();
+    tdb.reset_root(std::move(writing.root), current);
+    writing.deltas.clear();
+    writing.code.clear();
+    writing.in_flight = false;
+}
 
-    for (auto const &[hash, bytes] : code) {
-        code_updates.push_front(alloc.emplace_back(Update{
-            .key = NibblesView{hash},
-            .value = bytes,
-            .incarnation = false,
-            .next = UpdateList{},
-            .version = static_cast<int64_t>(current)}));
+std::optional<Account>
+monad_statesync_client_context::read_account(Address const &addr)
+{
+    auto const it = writing.deltas.find(addr);
+    if (it != writing.deltas.end()) {
+        if (it->second.has_value()) {
+            return it->second.value().first;
+        }
+        return std::nullopt;
+    }
+    if (key_filter && !key_filter->may_contain_account(keccak256(addr.bytes))) {
+        return std::nullopt;
     }
+    wait_for_commit();
+    return tdb.read_account(addr);
+}
 
-    auto state_update = Update{
-        .key = state_nibbles,
-        .value = byte_string_view{},
-        .incarnation = false,
-        .next = std::move(accounts),
-        .version = static_cast<int64_t>(current)};
-    auto code_update = Update{
-        .key = code_nibbles,
-        .value = byte_string_view{},
-        .incarnation = false,
-        .next = std::move(code_updates),
-        .version = static_cast<int64_t>(current)};
-    auto const rlp = rlp::encode_block_header(tgrt);
-    auto block_header_update = Update{
-        .key = block_header_nibbles,
-        .value = rlp,
-        .incarnation = true,
-        .next = UpdateList{},
-        .version = static_cast<int64_t>(current)};
-    UpdateList updates;
-    updates.push_front(state_update);
-    updates.push_front(code_update);
-    updates.push_front(block_header_update);
-
-    UpdateList finalized_updates;
-    Update finalized{
-        .key = finalized_nibbles,
-        .value = byte_string_view{},
-        .incarnation = false,
-        .next = std::move(updates),
-        .version = static_cast<int64_t>(current)};
-    finalized_updates.push_front(finalized);
-
-    tdb.reset_root(
-        db.upsert(
-            tdb.get_root(),
-            std::move(finalized_updates),
-            current,
-            false,
-            false),
-        current);
-    code.clear();
-    deltas.clear();
+bytes32_t monad_statesync_client_context::read_storage(
+    Address const &addr, bytes32_t const &key)
+{
+    auto const it = writing.deltas.find(addr);
+    if (it != writing.deltas.end()) {
+        if (!it->second.has_value()) {
+            return {};
+        }
+        auto const &storage = std::get<StorageDeltas>(it->second.value());
+        auto const sit = storage.find(key);
+        if (sit != storage.end()) {
+            return sit->second;
+        }
+    }
+    if (key_filter && !key_filter->may_contain_storage(
+                          keccak256(addr.bytes), keccak256(key.bytes))) {
+        return {};
+    }
+    wait_for_commit();
+    return tdb.read_storage(addr, Incarnation{0, 0}, key);
 }
@@ -17,15 +17,20 @@
 
 #include <category/core/byte_string.hpp>
 #include <category/core/bytes.hpp>
+#include <category/execution/ethereum/core/account.hpp>
 #include <category/execution/ethereum/core/address.hpp>
 #include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/db/key_bloom_filter.hpp>
 #include <category/execution/ethereum/db/trie_db.hpp>
 #include <category/execution/ethereum/db/util.hpp>
 #include <category/mpt/db.hpp>
+#include <category/mpt/node.hpp>
 #include <category/statesync/statesync_protocol.hpp>
 
 #include <ankerl/unordered_dense.h>
 
+#include <tbb/task_group.h>
+
 #include <array>
 #include <filesystem>
 #include <memory>
@@ -45,6 +50,17 @@ struct monad_statesync_client_context
 
     using StateDelta = std::pair<monad::Account, StorageDeltas>;
 
+    // A batch of upserts being written to the db in the background, while the
+    // upserts of the next batch are received
+    struct Batch
+    {
+        Map<monad::Address, std::optional<StateDelta>> deltas;
+        std::vector<monad::byte_string> code;
+        monad::BlockHeader tgrt;
+        monad::mpt::Node::SharedPtr root;
+        bool in_flight{false};
+    };
+
     monad::OnDiskMachine machine;
     monad::mpt::Db db;
     monad::TrieDb tdb;
@@ -55,9 +71,14 @@ struct monad_statesync_client_context
     uint64_t current;
     Map<monad::Address, StorageDeltas> buffered;
     ankerl::unordered_dense::segmented_set<monad::bytes32_t> seen_code;
-    Map<monad::bytes32_t, monad::byte_string> code;
+    std::vector<monad::byte_string> code; // hashed when written
     Map<monad::Address, std::optional<StateDelta>> deltas;
     uint64_t n_upserts;
+    // Every key written, when syncing into an empty db. Keys it rules out do
+    // not need to be looked up
+    std::unique_ptr<monad::KeyBloomFilter> key_filter;
+    Batch writing;
+    tbb::task_group writer;
     monad_statesync_client *sync;
     void (*statesync_send_request)(
         struct monad_statesync_client *, struct monad_sync_request);
@@ -68,5 +89,17 @@ struct monad_statesync_client_context
         void (*statesync_send_request)(
             struct monad_statesync_client *, struct monad_sync_request));
 
+    ~monad_statesync_client_context();
+
+    // Start writing the upserts received so far, once the previous batch is
+    // written
     void commit();
+
+    // Wait for the batch being written, if any, and move to its root
+    void wait_for_commit();
+
+    // Reads as of the upserts committed so far, which may still be in flight
+    std::optional<monad::Account> read_account(monad::Address const &);
+    monad::bytes32_t
+    read_storage(monad::Address const &, monad::bytes32_t const &key);
 };
@@ -29,13 +29,6 @@ using namespace monad::mpt;
 
 MONAD_ANONYMOUS_NAMESPACE_BEGIN
 
-bytes32_t read_storage(
-    monad_statesync_client_context &ctx, Address const &addr,
-    bytes32_t const &key)
-{
-    return ctx.tdb.read_storage(addr, Incarnation{0, 0}, key);
-}
-
 void account_update(
     monad_statesync_client_context &ctx, Address const &addr,
     std::optional<Account> const &acct)
@@ -53,7 +46,7 @@ void account_update(
     auto const updated = it != ctx.deltas.end();
 
     if (ctx.buffered.contains(addr)) {
-        MONAD_ASSERT(!ctx.tdb.read_account(addr).has_value() && !updated);
+        MONAD_ASSERT(!ctx.read_account(addr).has_value() && !updated);
         if (acct.has_value()) {
             MONAD_ASSERT(
                 ctx.deltas
@@ -73,7 +66,7 @@ void account_update(
                         addr, std::make_pair(acct.value(), StorageDeltas{}))
                     .second);
         }
-        else if (ctx.tdb.read_account(addr).has_value()) {
+        else if (ctx.read_account(addr).has_value()) {
             MONAD_ASSERT(ctx.deltas.emplace(addr, std::nullopt).second);
         }
     }
@@ -85,7 +78,7 @@ void account_update(
     else if (acct.has_value()) {
         std::get<Account>(it->second.value()) = acct.value();
     }
-    else if (ctx.tdb.read_account(addr).has_value()) {
+    else if (ctx.read_account(addr).has_value()) {
         it->second = std::nullopt;
     }
     else {
@@ -103,7 +96,7 @@ void storage_update(
     auto const updated = it != ctx.deltas.end();
 
     if (ctx.buffered.contains(addr)) {
-        MONAD_ASSERT(!ctx.tdb.read_account(addr).has_value() && !updated);
+        MONAD_ASSERT(!ctx.read_account(addr).has_value() && !updated);
         if (val == bytes32_t{}) {
             ctx.buffered[addr].erase(key);
             if (ctx.buffered[addr].empty()) {
@@ -121,7 +114,7 @@ void storage_update(
         }
     }
     else if (
-        val != bytes32_t{} || read_storage(ctx, addr, key) != bytes32_t{}) {
+        val != bytes32_t{} || ctx.read_storage(addr, key) != bytes32_t{}) {
         if (updated) {
             if (it->second.has_value()) {
                 std::get<StorageDeltas>(it->second.value())[key] = val;
@@ -133,7 +126,7 @@ void storage_update(
             }
         }
         else {
-            auto const orig = ctx.tdb.read_account(addr);
+            auto const orig = ctx.read_account(addr);
             if (orig.has_value()) {
                 MONAD_ASSERT(
                     ctx.deltas
@@ -186,8 +179,9 @@ bool StatesyncProtocolV1::handle_upsert(
 {
     byte_string_view raw{val, size};
     if (type == SYNC_TYPE_UPSERT_CODE) {
-        // code is immutable once inserted - no deletions
-        ctx->code.emplace(std::bit_cast<bytes32_t>(keccak256(raw)), raw);
+        // code is immutable once inserted - no deletions. It is hashed when
+        // the batch is written, off the receive path
+        ctx->code.emplace_back(raw);
     }
     else if (type == SYNC_TYPE_UPSERT_ACCOUNT) {
         auto const res = decode_account_db(raw);
@@ -26,6 +26,7 @@
 #include <category/execution/ethereum/db/util.hpp>
 #include <category/mpt/ondisk_db_config.hpp>
 #include <category/statesync/statesync_client.h>
+#include <category/statesync/statesync_client_context.hpp>
 #include <category/statesync/statesync_server.h>
 #include <category/statesync/statesync_server_context.hpp>
 #include <category/statesync/statesync_version.h>
@@ -1341,3 +1342,32 @@ TEST_F(StateSyncFixture, validation_old_target_greater_than_target)
     monad_statesync_server_run_once(server);
     EXPECT_FALSE(client.success);
 }
+
+TEST_F(StateSyncFixture, reads_through_batch_in_flight)
+{
+    using StorageDeltas = monad_statesync_client_context::StorageDeltas;
+    constexpr auto key =
+        0x00000000000000000000000000000000000000000000000000000000cafebabe_bytes32;
+    constexpr auto value =
+        0x0000000000000013370000000000000000000000000000000000000000000003_bytes32;
+
+    init();
+    ASSERT_NE(cctx->key_filter, nullptr);
+    cctx->deltas.emplace(
+        ADDR_A,
+        std::make_pair(Account{.balance = 100}, StorageDeltas{{key, value}}));
+    cctx->commit();
+    EXPECT_TRUE(cctx->deltas.empty());
+
+    // answered by the batch being written, or ruled out by the key filter
+    EXPECT_EQ(cctx->read_account(ADDR_A).value().balance, 100);
+    EXPECT_EQ(cctx->read_storage(ADDR_A, key), value);
+    EXPECT_EQ(cctx->read_storage(ADDR_A, bytes32_t{}), bytes32_t{});
+    EXPECT_FALSE(cctx->read_account(ADDR_B).has_value());
+
+    cctx->wait_for_commit();
+    EXPECT_FALSE(cctx->writing.in_flight);
+    EXPECT_EQ(cctx->tdb.read_account(ADDR_A).value().balance, 100);
+    EXPECT_EQ(cctx->read_account(ADDR_A).value().balance, 100);
+    EXPECT_EQ(cctx->read_storage(ADDR_A, key), value);
+}
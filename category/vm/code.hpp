@@ -71,6 +71,42 @@ namespace monad::vm
             return intercode_gas_used_.load(std::memory_order_acquire);
         }
 
+        /// Account for an execution of the native code. Returns the total
+        /// gas used by native code executions, including this one.
+        std::uint64_t
+        nativecode_executed(std::uint64_t gas_used, std::uint64_t time_ns)
+        {
+            nativecode_time_ns_.fetch_add(time_ns, std::memory_order_relaxed);
+            return gas_used + nativecode_gas_used_.fetch_add(
+                                  gas_used, std::memory_order_acq_rel);
+        }
+
+        /// Mean native code execution time per unit of gas, or zero if
+        /// nothing was executed yet.
+        double nativecode_ns_per_gas() const
+        {
+            auto const gas =
+                nativecode_gas_used_.load(std::memory_order_acquire);
+            if (gas == 0) {
+                return 0;
+            }
+            return static_cast<double>(
+                       nativecode_time_ns_.load(std::memory_order_relaxed)) /
+                   static_cast<double>(gas);
+        }
+
+        /// Whether the native code was submitted for recompilation with
+        /// LLVM, or found to be submitted already.
+        bool llvm_tier_requested() const
+        {
+            return llvm_tier_requested_.load(std::memory_order_acquire);
+        }
+
+        void set_llvm_tier_requested()
+        {
+            llvm_tier_requested_.store(true, std::memory_order_release);
+        }
+
         /// Get corresponding intercode.
         /// Can be assumed to always return a non-null result.
         SharedIntercode const &intercode() const
@@ -86,6 +122,9 @@ namespace monad::vm
 
     private:
         std::atomic<std::uint64_t> intercode_gas_used_;
+        std::atomic<std::uint64_t> nativecode_gas_used_{0};
+        std::atomic<std::uint64_t> nativecode_time_ns_{0};
+        std::atomic<bool> llvm_tier_requested_{false};
         SharedIntercode intercode_;
         SharedNativecode nativecode_;
     };
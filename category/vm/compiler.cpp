@@ -19,14 +19,26 @@
 #include <category/vm/core/assert.h>
 #include <category/vm/evm/explicit_traits.hpp>
 #include <category/vm/evm/traits.hpp>
+#ifdef MONAD_COMPILER_LLVM
+    #include <category/vm/compiler/ir/basic_blocks.hpp>
+    #include <category/vm/llvm/compile_options.hpp>
+    #include <category/vm/llvm/llvm.hpp>
+    #include <category/vm/utils/scope_exit.hpp>
+#endif
 
 #include <evmc/evmc.hpp>
 
+#include <quill/Quill.h>
+
 #include <atomic>
 #include <chrono>
 #include <cstddef>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
+#include <utility>
 #include <variant>
 
 namespace monad::vm
@@ -42,6 +54,9 @@ namespace monad::vm
 
     Compiler::~Compiler()
     {
+#ifdef MONAD_COMPILER_LLVM
+        wait_for_llvm_tier();
+#endif
         stop_compile_thread();
     }
 
@@ -179,4 +194,146 @@ namespace monad::vm
             std::this_thread::sleep_for(std::chrono::milliseconds{1});
         }
     }
+
+#ifdef MONAD_COMPILER_LLVM
+    void Compiler::enable_llvm_tier(LLVMTierConfig const &config)
+    {
+        MONAD_VM_ASSERT(!llvm_tier_enabled());
+        MONAD_VM_ASSERT(config.threads > 0);
+        MONAD_VM_ASSERT(config.opt_level >= 1 && config.opt_level <= 3);
+        llvm_config_ = config;
+        if (!config.object_cache_dir.empty()) {
+            llvm_object_cache_ =
+                std::make_unique<llvm::ObjectCache>(config.object_cache_dir);
+        }
+        llvm_arena_ =
+            std::make_unique<tbb::task_arena>(static_cast<int>(config.threads));
+    }
+
+    template <Traits traits>
+    bool Compiler::async_compile_llvm(
+        evmc::bytes32 const &code_hash, SharedVarcode const &vcode)
+    {
+        MONAD_VM_ASSERT(llvm_tier_enabled());
+        if (llvm_jobs_in_flight_.load(std::memory_order_acquire) >=
+            compile_job_soft_limit_) {
+            return false;
+        }
+        // Every code is submitted at most once, successful or not
+        bool const inserted = llvm_tier_records_.insert(
+            {code_hash,
+             LLVMTierRecord{
+                 .baseline_ns_per_gas = vcode->nativecode_ns_per_gas()}});
+        vcode->set_llvm_tier_requested();
+        if (!inserted) {
+            return false;
+        }
+        llvm_jobs_in_flight_.fetch_add(1, std::memory_order_acq_rel);
+        llvm_arena_->execute([&] {
+            llvm_jobs_.run([this,
+                            code_hash,
+                            icode = vcode->intercode(),
+                            ncode = vcode->nativecode()] {
+                auto const done = utils::scope_exit([this] {
+                    llvm_jobs_in_flight_.fetch_sub(
+                        1, std::memory_order_acq_rel);
+                });
+                // A failed compile leaves the baseline native code in place
+                try {
+                    compile_llvm<traits>(code_hash, icode, ncode);
+                }
+                catch (std::exception const &e) {
+                    LOG_ERROR("ERROR: LLVM tier: failed compile: {}", e.what());
+                }
+                catch (...) {
+                    LOG_ERROR("ERROR: LLVM tier: failed compile");
+                }
+            });
+        });
+        return true;
+    }
+
+    EXPLICIT_TRAITS_MEMBER(Compiler::async_compile_llvm);
+
+    template <Traits traits>
+    void Compiler::compile_llvm(
+        evmc::bytes32 const &code_hash, SharedIntercode const &icode,
+        SharedNativecode const &ncode)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        std::shared_ptr<llvm::LLVMState> state;
+        if (llvm_object_cache_) {
+            state = llvm_object_cache_->load<traits>(code_hash);
+            if (!state) {
+                state = llvm_object_cache_->compile<traits>(
+                    code_hash, icode->code_span(), llvm_config_.opt_level);
+            }
+        }
+        else {
+            state = llvm::compile_basicblocks_llvm<traits>(
+                compiler::basic_blocks::unsafe_make_ir<traits>(
+                    icode->code_span()),
+                "",
+                {.opt_level = llvm_config_.opt_level});
+        }
+        // The asmjit runtime is safe to add code to concurrently with the
+        // compile thread
+        auto optimized = llvm::make_nativecode(
+            asmjit_rt_,
+            traits::id(),
+            std::move(state),
+            *ncode->code_size_estimate());
+        auto const end = std::chrono::steady_clock::now();
+        if (optimized == nullptr) {
+            return;
+        }
+
+        // Only replace the code that was measured hot, not code compiled
+        // since for another revision, or code evicted meanwhile
+        auto const vcode = varcode_cache_.get(code_hash);
+        if (!vcode || (*vcode)->nativecode() != ncode) {
+            return;
+        }
+        varcode_cache_.set(code_hash, icode, optimized);
+        if (auto const replaced = varcode_cache_.get(code_hash)) {
+            LLVMTierRecordMap::accessor acc;
+            if (llvm_tier_records_.find(acc, code_hash)) {
+                acc->second.compile_time_us =
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        end - start)
+                        .count();
+                acc->second.optimized = *replaced;
+            }
+        }
+        std::lock_guard const lock{llvm_stats_mutex_};
+        stats_.event_llvm_compiled_code_cached(start, end);
+    }
+
+    std::optional<LLVMTierRecord>
+    Compiler::llvm_tier_record(evmc::bytes32 const &code_hash) const
+    {
+        LLVMTierRecordMap::const_accessor acc;
+        if (!llvm_tier_records_.find(acc, code_hash)) {
+            return std::nullopt;
+        }
+        return acc->second;
+    }
+
+    void Compiler::wait_for_llvm_tier() noexcept
+    {
+        try {
+            debug_wait_for_llvm_tier();
+        }
+        catch (...) {
+            // A failed compile only leaves the native code in place
+        }
+    }
+
+    void Compiler::debug_wait_for_llvm_tier()
+    {
+        if (llvm_arena_) {
+            llvm_arena_->execute([this] { llvm_jobs_.wait(); });
+        }
+    }
+#endif
 }
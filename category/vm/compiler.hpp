@@ -18,6 +18,9 @@
 #include <category/vm/code.hpp>
 #include <category/vm/compiler/ir/x86.hpp>
 #include <category/vm/evm/traits.hpp>
+#ifdef MONAD_COMPILER_LLVM
+    #include <category/vm/llvm/llvm.hpp>
+#endif
 #include <category/vm/utils/debug.hpp>
 #include <category/vm/utils/log_utils.hpp>
 #include <category/vm/varcode_cache.hpp>
@@ -27,12 +30,21 @@
 
 #include <tbb/concurrent_hash_map.h>
 #include <tbb/concurrent_queue.h>
+#ifdef MONAD_COMPILER_LLVM
+    #include <tbb/task_arena.h>
+    #include <tbb/task_group.h>
+#endif
 
 #include <asmjit/x86.h>
 
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
 
 namespace monad::vm
@@ -102,6 +114,40 @@ namespace monad::vm
             }
         }
 
+#ifdef MONAD_COMPILER_LLVM
+        utils::EuclidMean<int64_t> avg_llvm_compile_time_;
+        std::atomic<uint64_t> num_llvm_compiled_contracts_{0};
+
+        // must be called non-concurrently
+        void
+        event_llvm_compiled_code_cached(auto compile_start, auto compile_end)
+        {
+            if constexpr (utils::collect_monad_compiler_stats) {
+                num_llvm_compiled_contracts_.fetch_add(
+                    1, std::memory_order_release);
+                avg_llvm_compile_time_.update(
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        compile_end - compile_start)
+                        .count());
+            }
+        }
+
+        std::string print_llvm_stats() const
+        {
+            if constexpr (utils::collect_monad_compiler_stats) {
+                return std::format(
+                    ",num_llvm_compiled_contracts={}"
+                    ",avg_llvm_compile_time={}µs",
+                    num_llvm_compiled_contracts_.load(
+                        std::memory_order_acquire),
+                    avg_llvm_compile_time_.get());
+            }
+            else {
+                return "";
+            }
+        }
+#endif
+
         std::string
         print_stats(uint64_t cache_size, uint64_t cache_weight) const
         {
@@ -136,6 +182,48 @@ namespace monad::vm
         }
     };
 
+#ifdef MONAD_COMPILER_LLVM
+    /// Configuration of the optional LLVM tier, which recompiles native code
+    /// that turns out to be hot with the optimizing LLVM backend in the
+    /// background, and swaps it in once done.
+    struct LLVMTierConfig
+    {
+        /// Gas used by native code executions of a contract before it is
+        /// recompiled.
+        uint64_t gas_threshold{100'000'000};
+        /// Number of threads compiling in the background.
+        unsigned threads{1};
+        /// LLVM optimization level, 1 to 3.
+        unsigned opt_level{3};
+        /// Compiled objects are loaded from and persisted to this directory
+        /// across restarts, if not empty.
+        std::filesystem::path object_cache_dir{};
+    };
+
+    struct LLVMTierRecord
+    {
+        int64_t compile_time_us{0};
+        /// Execution time per gas of the native code that was replaced.
+        double baseline_ns_per_gas{0};
+        std::weak_ptr<Varcode const> optimized{};
+
+        /// Execution time per gas of the replaced code over that of the LLVM
+        /// compiled code, if both have been measured.
+        std::optional<double> speedup() const
+        {
+            auto const vcode = optimized.lock();
+            if (!vcode || baseline_ns_per_gas == 0) {
+                return std::nullopt;
+            }
+            auto const ns_per_gas = vcode->nativecode_ns_per_gas();
+            if (ns_per_gas == 0) {
+                return std::nullopt;
+            }
+            return baseline_ns_per_gas / ns_per_gas;
+        }
+    };
+#endif
+
     class Compiler
     {
         using CompileJobMap = tbb::concurrent_hash_map<
@@ -148,6 +236,10 @@ namespace monad::vm
             utils::Hash32Compare>;
         using CompileJobAccessor = CompileJobMap::accessor;
         using CompileJobQueue = tbb::concurrent_queue<evmc::bytes32>;
+#ifdef MONAD_COMPILER_LLVM
+        using LLVMTierRecordMap = tbb::concurrent_hash_map<
+            evmc::bytes32, LLVMTierRecord, utils::Hash32Compare>;
+#endif
 
     public:
         explicit Compiler(
@@ -198,21 +290,76 @@ namespace monad::vm
             return varcode_cache_.set_warm_cache_kb(warm_kb);
         }
 
+        VarcodeCache const &varcode_cache() const
+        {
+            return varcode_cache_;
+        }
+
         std::string print_stats() const
         {
+#ifdef MONAD_COMPILER_LLVM
+            return stats_.print_stats(
+                       varcode_cache_.size(), varcode_cache_.approx_weight()) +
+                   stats_.print_llvm_stats();
+#else
             return stats_.print_stats(
                 varcode_cache_.size(), varcode_cache_.approx_weight());
+#endif
         }
 
         // For testing: wait for compile job queue to become empty.
         void debug_wait_for_empty_queue();
 
+#ifdef MONAD_COMPILER_LLVM
+        /// Start recompiling hot native code with LLVM. Must be called
+        /// before any code is executed.
+        void enable_llvm_tier(LLVMTierConfig const &);
+
+        bool llvm_tier_enabled() const noexcept
+        {
+            return llvm_arena_ != nullptr;
+        }
+
+        uint64_t llvm_gas_threshold() const noexcept
+        {
+            return llvm_config_.gas_threshold;
+        }
+
+        /// Asynchronously recompile the native code of `vcode` with LLVM for
+        /// `revision`, and replace it in the cache once compiled. Returns
+        /// `true` if the compile job was submitted. Returns `false` if the
+        /// code was already submitted once, or there are too many compile
+        /// jobs. Unless turned down for too many jobs, `vcode` is marked as
+        /// requested.
+        template <Traits traits>
+        bool async_compile_llvm(
+            evmc::bytes32 const &code_hash, SharedVarcode const &vcode);
+
+        /// The record of the LLVM recompilation of the code, if submitted.
+        std::optional<LLVMTierRecord>
+        llvm_tier_record(evmc::bytes32 const &code_hash) const;
+
+        /// Wait for the LLVM compile jobs to finish, ignoring their
+        /// failures. Used on shutdown.
+        void wait_for_llvm_tier() noexcept;
+
+        // For testing: wait for the LLVM compile jobs to finish.
+        void debug_wait_for_llvm_tier();
+#endif
+
     private:
         void start_compile_thread();
         void stop_compile_thread();
         void compile_loop();
         void dispense_compile_jobs();
 
+#ifdef MONAD_COMPILER_LLVM
+        template <Traits traits>
+        void compile_llvm(
+            evmc::bytes32 const &code_hash, SharedIntercode const &,
+            SharedNativecode const &);
+#endif
+
         static constexpr asmjit::JitAllocator::CreateParams
             asmjit_create_params_{
                 .options = asmjit::JitAllocatorOptions::kUseDualMapping,
@@ -231,5 +378,15 @@ namespace monad::vm
         bool enable_async_compilation_;
 
         CompilerStats stats_;
+
+#ifdef MONAD_COMPILER_LLVM
+        LLVMTierConfig llvm_config_;
+        std::unique_ptr<llvm::ObjectCache> llvm_object_cache_;
+        LLVMTierRecordMap llvm_tier_records_;
+        std::atomic<size_t> llvm_jobs_in_flight_{0};
+        std::mutex llvm_stats_mutex_;
+        std::unique_ptr<tbb::task_arena> llvm_arena_;
+        tbb::task_group llvm_jobs_;
+#endif
     };
 }
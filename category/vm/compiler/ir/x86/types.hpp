@@ -22,7 +22,9 @@
 #include <asmjit/x86.h>
 
 #include <functional>
+#include <memory>
 #include <optional>
+#include <utility>
 #include <variant>
 
 namespace monad::vm::compiler::native
@@ -64,6 +66,21 @@ namespace monad::vm::compiler::native
                 std::holds_alternative<native_code_size_t>(code_size_estimate));
         }
 
+        /// Entry point into code of the optimizing tier, which is kept
+        /// alive by `optimized` for as long as this object.
+        Nativecode(
+            asmjit::JitRuntime &asmjit_rt, uint64_t chain_id,
+            entrypoint_t entry, native_code_size_t code_size_estimate,
+            std::shared_ptr<void const> optimized)
+            : asmjit_rt_{asmjit_rt}
+            , chain_id_{chain_id}
+            , entrypoint_{entry}
+            , code_size_estimate_{code_size_estimate}
+            , optimized_{std::move(optimized)}
+        {
+            MONAD_VM_DEBUG_ASSERT(entrypoint_ && optimized_);
+        }
+
         Nativecode(Nativecode const &) = delete;
         Nativecode &operator=(Nativecode const &) = delete;
 
@@ -78,6 +95,12 @@ namespace monad::vm::compiler::native
             return chain_id_;
         }
 
+        /// Whether the code is from the optimizing tier.
+        bool is_optimized() const noexcept
+        {
+            return optimized_ != nullptr;
+        }
+
         native_code_size_t code_size_estimate() const
         {
             return std::holds_alternative<native_code_size_t>(
@@ -126,6 +149,7 @@ namespace monad::vm::compiler::native
         uint64_t chain_id_;
         entrypoint_t entrypoint_;
         CodeSizeEstimate code_size_estimate_;
+        std::shared_ptr<void const> optimized_;
     };
 
     class Emitter;
@@ -0,0 +1,33 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace monad::vm::llvm
+{
+    struct CompileOptions
+    {
+        // Level of the optimization pipeline, from 1 to 3
+        unsigned opt_level{3};
+
+        // If set, the object code is written to `object_dir`, named
+        // `object_name` followed by ".o"
+        std::filesystem::path object_dir{};
+        std::string object_name{};
+    };
+}
@@ -14,10 +14,12 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <category/vm/compiler/ir/basic_blocks.hpp>
+#include <category/vm/compiler/ir/x86/types.hpp>
 #include <category/vm/compiler/types.hpp>
 #include <category/vm/core/assert.h>
 #include <category/vm/evm/explicit_traits.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/llvm/compile_options.hpp>
 #include <category/vm/llvm/dependency_blocks.hpp>
 #include <category/vm/llvm/emitter.hpp>
 #include <category/vm/llvm/llvm_state.hpp>
@@ -33,6 +35,8 @@
 
 #include <llvm-c/Target.h>
 
+#include <asmjit/x86.h>
+
 #include <cstdint>
 #include <format>
 #include <fstream>
@@ -134,9 +138,12 @@ namespace monad::vm::llvm
         return ptr;
     };
 
+    EXPLICIT_TRAITS(load_from_disk_impl);
+
     template <Traits traits>
     std::shared_ptr<LLVMState> compile_basicblocks_impl(
-        BasicBlocksIR const &ir, std::string const &dbg_nm = "")
+        BasicBlocksIR const &ir, std::string const &dbg_nm = "",
+        CompileOptions const &options = {})
     {
         auto ptr = make_shared_llvm_state();
         LLVMState &llvm = *ptr;
@@ -163,7 +170,7 @@ namespace monad::vm::llvm
             llvm.dump_module(std::format("{}.ll", dbg_nm));
         }
 
-        llvm.set_contract_addr(dbg_nm);
+        llvm.set_contract_addr(dbg_nm, options);
 
         return ptr;
     }
@@ -171,11 +178,12 @@ namespace monad::vm::llvm
     EXPLICIT_TRAITS(compile_basicblocks_impl);
 
     template <Traits traits>
-    std::shared_ptr<LLVMState>
-    compile_impl(std::span<uint8_t const> code, std::string const &dbg_nm = "")
+    std::shared_ptr<LLVMState> compile_impl(
+        std::span<uint8_t const> code, std::string const &dbg_nm,
+        CompileOptions const &options)
     {
         BasicBlocksIR const ir = unsafe_make_ir<traits>(code);
-        return compile_basicblocks_impl<traits>(ir, dbg_nm);
+        return compile_basicblocks_impl<traits>(ir, dbg_nm, options);
     }
 
     std::shared_ptr<LLVMState>
@@ -236,57 +244,100 @@ namespace monad::vm::llvm
             evm_stack, &ctx, llvm.contract_addr, &ctx.exit_stack_ptr);
     }
 
+    compiler::native::entrypoint_t
+    make_entrypoint(asmjit::JitRuntime &rt, LLVMState const &llvm)
+    {
+        namespace x86 = asmjit::x86;
+
+        asmjit::CodeHolder code;
+        code.init(rt.environment(), rt.cpuFeatures());
+        x86::Assembler as{&code};
+
+        // Native entry points take the context in rdi and the stack in rsi,
+        // the trampoline takes them the other way round, followed by the
+        // contract and where to save the stack pointer for exits.
+        as.mov(x86::rax, x86::rdi);
+        as.mov(x86::rdi, x86::rsi);
+        as.mov(x86::rsi, x86::rax);
+        as.lea(
+            x86::rcx,
+            x86::ptr(
+                x86::rax,
+                static_cast<int32_t>(context_offset_exit_stack_ptr)));
+        as.mov(
+            x86::rdx,
+            asmjit::Imm{reinterpret_cast<uint64_t>(llvm.contract_addr)});
+        as.mov(
+            x86::rax,
+            asmjit::Imm{reinterpret_cast<uint64_t>(&llvm_runtime_trampoline)});
+        as.jmp(x86::rax);
+
+        compiler::native::entrypoint_t entry = nullptr;
+        if (rt.add(&entry, &code) != asmjit::kErrorOk) {
+            return nullptr;
+        }
+        return entry;
+    }
+
     std::shared_ptr<LLVMState> compile(
         evmc_revision rev, std::span<uint8_t const> code,
-        std::string const &dbg_nm)
+        std::string const &dbg_nm, CompileOptions const &options)
     {
         switch (rev) {
         case EVMC_FRONTIER:
-            return compile_impl<EvmTraits<EVMC_FRONTIER>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_FRONTIER>>(
+                code, dbg_nm, options);
 
         case EVMC_HOMESTEAD:
-            return compile_impl<EvmTraits<EVMC_HOMESTEAD>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_HOMESTEAD>>(
+                code, dbg_nm, options);
 
         case EVMC_TANGERINE_WHISTLE:
             return compile_impl<EvmTraits<EVMC_TANGERINE_WHISTLE>>(
-                code, dbg_nm);
+                code, dbg_nm, options);
 
         case EVMC_SPURIOUS_DRAGON:
-            return compile_impl<EvmTraits<EVMC_SPURIOUS_DRAGON>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_SPURIOUS_DRAGON>>(
+                code, dbg_nm, options);
 
         case EVMC_BYZANTIUM:
-            return compile_impl<EvmTraits<EVMC_BYZANTIUM>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_BYZANTIUM>>(
+                code, dbg_nm, options);
 
         case EVMC_CONSTANTINOPLE:
-            return compile_impl<EvmTraits<EVMC_CONSTANTINOPLE>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_CONSTANTINOPLE>>(
+                code, dbg_nm, options);
 
         case EVMC_PETERSBURG:
-            return compile_impl<EvmTraits<EVMC_PETERSBURG>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_PETERSBURG>>(
+                code, dbg_nm, options);
 
         case EVMC_ISTANBUL:
-            return compile_impl<EvmTraits<EVMC_ISTANBUL>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_ISTANBUL>>(
+                code, dbg_nm, options);
 
         case EVMC_BERLIN:
-            return compile_impl<EvmTraits<EVMC_BERLIN>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_BERLIN>>(code, dbg_nm, options);
 
         case EVMC_LONDON:
-            return compile_impl<EvmTraits<EVMC_LONDON>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_LONDON>>(code, dbg_nm, options);
 
         case EVMC_PARIS:
-            return compile_impl<EvmTraits<EVMC_PARIS>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_PARIS>>(code, dbg_nm, options);
 
         case EVMC_SHANGHAI:
-            return compile_impl<EvmTraits<EVMC_SHANGHAI>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_SHANGHAI>>(
+                code, dbg_nm, options);
 
         case EVMC_CANCUN:
-            return compile_impl<EvmTraits<EVMC_CANCUN>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_CANCUN>>(code, dbg_nm, options);
 
         case EVMC_PRAGUE:
-            return compile_impl<EvmTraits<EVMC_PRAGUE>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_PRAGUE>>(code, dbg_nm, options);
 
         default:
             MONAD_VM_ASSERT(rev == EVMC_OSAKA);
-            return compile_impl<EvmTraits<EVMC_OSAKA>>(code, dbg_nm);
+            return compile_impl<EvmTraits<EVMC_OSAKA>>(code, dbg_nm, options);
         }
     }
 }
@@ -17,10 +17,14 @@
 
 #include <category/core/runtime/uint256.hpp>
 #include <category/vm/compiler/ir/basic_blocks.hpp>
+#include <category/vm/compiler/ir/x86/types.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/llvm/compile_options.hpp>
 #include <category/vm/llvm/llvm_state.hpp>
 #include <category/vm/runtime/types.hpp>
 
+#include <asmjit/x86.h>
+
 namespace monad::vm::llvm
 {
     using namespace monad::vm::runtime;
@@ -31,12 +35,21 @@ namespace monad::vm::llvm
     std::shared_ptr<LLVMState>
     load_from_disk(evmc_revision rev, std::string_view fn);
 
+    template <Traits traits>
+    std::shared_ptr<LLVMState> load_from_disk_impl(std::string_view fn);
+
     std::shared_ptr<LLVMState> compile(
         evmc_revision rev, std::span<uint8_t const> code,
-        std::string const &dbg_nm);
+        std::string const &dbg_nm, CompileOptions const & = {});
+
+    // Entry point with the signature of native code, that jumps into `llvm`
+    // through the runtime trampoline
+    compiler::native::entrypoint_t
+    make_entrypoint(asmjit::JitRuntime &, LLVMState const &llvm);
 
     template <Traits traits>
     std::shared_ptr<LLVMState> compile_basicblocks_impl(
-        BasicBlocksIR const &ir, std::string const &dbg_nm = "");
+        BasicBlocksIR const &ir, std::string const &dbg_nm = "",
+        CompileOptions const & = {});
 
 }
@@ -14,9 +14,12 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <category/core/runtime/uint256.hpp>
+#include <category/vm/code.hpp>
 #include <category/vm/compiler/ir/basic_blocks.hpp>
+#include <category/vm/compiler/ir/x86/types.hpp>
 #include <category/vm/evm/explicit_traits.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/llvm/compile_options.hpp>
 #include <category/vm/llvm/execute.hpp>
 #include <category/vm/llvm/llvm.hpp>
 #include <category/vm/runtime/transmute.hpp>
@@ -26,6 +29,8 @@
 #include <evmc/evmc.h>
 #include <evmc/evmc.hpp>
 
+#include <asmjit/x86.h>
+
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
@@ -34,11 +39,59 @@
 #include <memory>
 #include <span>
 #include <string>
-#include <unordered_map>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 namespace monad::vm::llvm
 {
+    namespace
+    {
+        std::string object_name(
+            bool const is_monad, uint64_t const id,
+            evmc::bytes32 const &code_hash)
+        {
+            return std::format(
+                "{}.{}.{}.jit",
+                is_monad ? "monad" : "evm",
+                id,
+                utils::hex_string(code_hash));
+        }
+
+        template <Traits traits>
+        std::string object_name(evmc::bytes32 const &code_hash)
+        {
+            return object_name(
+                is_monad_trait_v<traits>, traits::id(), code_hash);
+        }
+
+        std::filesystem::path
+        object_path(std::filesystem::path const &dir, std::string const &name)
+        {
+            return dir / (name + ".o");
+        }
+
+        // The object is written aside by the compile and only renamed into
+        // place once complete
+        template <class Compile>
+        std::shared_ptr<LLVMState> compile_persisted(
+            std::filesystem::path const &dir, std::string const &name,
+            unsigned const opt_level, Compile const &compile)
+        {
+            auto const tmp_name = name + ".tmp";
+            std::error_code ec;
+            // left over by an interrupted compile
+            std::filesystem::remove(object_path(dir, tmp_name), ec);
+            auto ptr = compile(CompileOptions{
+                .opt_level = opt_level,
+                .object_dir = dir,
+                .object_name = tmp_name});
+            std::filesystem::rename(
+                object_path(dir, tmp_name), object_path(dir, name), ec);
+            return ptr;
+        }
+    }
+
     std::vector<std::string> extensions(std::filesystem::path fn)
     {
         std::vector<std::string> exts;
@@ -75,35 +128,108 @@ namespace monad::vm::llvm
         }
     }
 
-    VM::VM(std::size_t max_stack_cache, std::size_t max_memory_cache)
+    ObjectCache::ObjectCache(std::filesystem::path dir)
+        : dir_{std::move(dir)}
+    {
+        std::filesystem::create_directories(dir_);
+    }
+
+    template <Traits traits>
+    std::shared_ptr<LLVMState>
+    ObjectCache::load(evmc::bytes32 const &code_hash) const
+    {
+        auto const path = object_path(dir_, object_name<traits>(code_hash));
+        if (!std::filesystem::exists(path)) {
+            return nullptr;
+        }
+        return load_from_disk_impl<traits>(path.string());
+    }
+
+    EXPLICIT_TRAITS_MEMBER(ObjectCache::load);
+
+    template <Traits traits>
+    std::shared_ptr<LLVMState> ObjectCache::compile(
+        evmc::bytes32 const &code_hash, std::span<uint8_t const> code,
+        unsigned const opt_level) const
+    {
+        return compile_persisted(
+            dir_,
+            object_name<traits>(code_hash),
+            opt_level,
+            [&](CompileOptions const &options) {
+                auto const ir = compiler::basic_blocks::unsafe_make_ir<traits>(
+                    code);
+                return compile_basicblocks_impl<traits>(ir, "", options);
+            });
+    }
+
+    EXPLICIT_TRAITS_MEMBER(ObjectCache::compile);
+
+    VM::VM(
+        std::size_t max_stack_cache, std::size_t max_memory_cache,
+        std::filesystem::path const &object_cache_dir)
         : stack_allocator_{max_stack_cache}
         , memory_allocator_{max_memory_cache}
-        , cached_llvm_code_(
-              EVMC_MAX_REVISION + 1,
-              std::unordered_map<evmc::bytes32, std::shared_ptr<LLVMState>>())
+        , cached_llvm_code_(EVMC_MAX_REVISION + 1)
+        , object_cache_{
+              object_cache_dir.empty()
+                  ? nullptr
+                  : std::make_unique<ObjectCache>(object_cache_dir)}
     {
         load_llvm_file_cache();
     }
 
+    VM::~VM() = default;
+
     std::shared_ptr<LLVMState> VM::cache_llvm(
         evmc_revision rev, evmc::bytes32 const &code_hash, uint8_t const *code,
         size_t code_size)
     {
-        auto const item = cached_llvm_code_[rev].find(code_hash);
-        if (item != cached_llvm_code_[rev].end()) {
+        auto &cached = cached_llvm_code_[rev];
+        {
+            CodeMap::const_accessor item;
+            if (cached.find(item, code_hash)) {
+                return item->second;
+            }
+        }
+
+        // Holding the accessor makes concurrent lookups of the same code
+        // wait for this compile, rather than compiling it again
+        CodeMap::accessor item;
+        if (!cached.insert(item, code_hash)) {
             return item->second;
         }
 
         auto const *isq = std::getenv("MONAD_VM_LLVM_DEBUG");
-        auto code_hash_str = monad::vm::utils::hex_string(code_hash);
-        std::string const hash_str =
-            std::format(".{}.{}", (int)rev, code_hash_str);
-        std::string const dbg_nm = isq ? "t" + hash_str : "";
-        auto ptr = monad::vm::llvm::compile(rev, {code, code_size}, dbg_nm);
-
-        cached_llvm_code_[rev].insert({code_hash, ptr});
-
-        return ptr;
+        if (isq) {
+            auto code_hash_str = monad::vm::utils::hex_string(code_hash);
+            std::string const hash_str =
+                std::format(".{}.{}", (int)rev, code_hash_str);
+            item->second = monad::vm::llvm::compile(
+                rev, {code, code_size}, "t" + hash_str);
+        }
+        else if (object_cache_) {
+            auto const name = object_name(false, rev, code_hash);
+            auto const path = object_path(object_cache_->dir(), name);
+            item->second = std::filesystem::exists(path)
+                               ? load_from_disk(rev, path.string())
+                               : compile_persisted(
+                                     object_cache_->dir(),
+                                     name,
+                                     3,
+                                     [&](CompileOptions const &options) {
+                                         return monad::vm::llvm::compile(
+                                             rev,
+                                             {code, code_size},
+                                             "",
+                                             options);
+                                     });
+        }
+        else {
+            item->second =
+                monad::vm::llvm::compile(rev, {code, code_size}, "");
+        }
+        return item->second;
     }
 
     evmc::Result VM::execute_llvm(
@@ -135,11 +261,25 @@ namespace monad::vm::llvm
     template <Traits traits>
     std::shared_ptr<LLVMState> compile_basicblocks_llvm(
         compiler::basic_blocks::BasicBlocksIR const &ir,
-        std::string const &dbg_nm)
+        std::string const &dbg_nm, CompileOptions const &options)
     {
-        return monad::vm::llvm::compile_basicblocks_impl<traits>(ir, dbg_nm);
+        return monad::vm::llvm::compile_basicblocks_impl<traits>(
+            ir, dbg_nm, options);
     }
 
     EXPLICIT_TRAITS(compile_basicblocks_llvm);
 
+    SharedNativecode make_nativecode(
+        asmjit::JitRuntime &asmjit_rt, uint64_t const chain_id,
+        std::shared_ptr<LLVMState> llvm,
+        compiler::native::native_code_size_t const code_size_estimate)
+    {
+        auto const entry = make_entrypoint(asmjit_rt, *llvm);
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        return std::make_shared<Nativecode>(
+            asmjit_rt, chain_id, entry, code_size_estimate, std::move(llvm));
+    }
+
 }
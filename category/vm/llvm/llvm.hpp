@@ -15,39 +15,86 @@
 
 #pragma once
 
+#include <category/vm/code.hpp>
 #include <category/vm/compiler/ir/basic_blocks.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/llvm/compile_options.hpp>
 #include <category/vm/runtime/allocator.hpp>
+#include <category/vm/utils/evmc_utils.hpp>
+
+#include <evmc/evmc.hpp>
+
+#include <tbb/concurrent_hash_map.h>
+
+#include <asmjit/x86.h>
 
 #include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace monad::vm::llvm
 {
     struct LLVMState; // forward declaration so we don't have to pull in all the
                       // LLVM includes
 
+    // Directory of contracts compiled with LLVM, one object file per code
+    // hash and revision. Objects are written under a temporary name and renamed
+    // once complete, so an interrupted compile never leaves an object that
+    // fails to load.
+    class ObjectCache
+    {
+        std::filesystem::path dir_;
+
+    public:
+        explicit ObjectCache(std::filesystem::path dir);
+
+        std::filesystem::path const &dir() const noexcept
+        {
+            return dir_;
+        }
+
+        // Load the object compiled for `traits`, or return null
+        template <Traits traits>
+        std::shared_ptr<LLVMState> load(evmc::bytes32 const &code_hash) const;
+
+        // Compile for `traits` and persist the object
+        template <Traits traits>
+        std::shared_ptr<LLVMState> compile(
+            evmc::bytes32 const &code_hash, std::span<uint8_t const> code,
+            unsigned opt_level) const;
+    };
+
     class VM
     {
+        using CodeMap = tbb::concurrent_hash_map<
+            evmc::bytes32, std::shared_ptr<LLVMState>, utils::Hash32Compare>;
+
         runtime::EvmStackAllocator stack_allocator_;
         runtime::EvmMemoryAllocator memory_allocator_;
-        std::vector<
-            std::unordered_map<evmc::bytes32, std::shared_ptr<LLVMState>>>
-            cached_llvm_code_;
+        std::vector<CodeMap> cached_llvm_code_;
+        std::unique_ptr<ObjectCache> object_cache_;
 
     public:
+        // Objects are loaded from and persisted to `object_cache_dir`, if it
+        // is not empty
         explicit VM(
             std::size_t max_stack_cache_byte_size =
                 runtime::EvmStackAllocator::DEFAULT_MAX_CACHE_BYTE_SIZE,
             std::size_t max_memory_cache_byte_size =
-                runtime::EvmMemoryAllocator::DEFAULT_MAX_CACHE_BYTE_SIZE);
+                runtime::EvmMemoryAllocator::DEFAULT_MAX_CACHE_BYTE_SIZE,
+            std::filesystem::path const &object_cache_dir = {});
+
+        ~VM();
 
         evmc::Result execute_llvm(
             evmc_revision rev, evmc::bytes32 const &code_hash,
             evmc_host_interface const *host, evmc_host_context *context,
             evmc_message const *msg, uint8_t const *code, size_t code_size);
 
+        // Thread safe. Concurrent calls for the same code compile it once
         std::shared_ptr<LLVMState> cache_llvm(
             evmc_revision rev, evmc::bytes32 const &code_hash,
             uint8_t const *code, size_t code_size);
@@ -59,10 +106,18 @@ namespace monad::vm::llvm
     template <Traits traits>
     std::shared_ptr<LLVMState> compile_basicblocks_llvm(
         compiler::basic_blocks::BasicBlocksIR const &ir,
-        std::string const &dbg_nm);
+        std::string const &dbg_nm, CompileOptions const & = {});
 
     void execute_compiled_llvm(
         std::shared_ptr<LLVMState> llvm, runtime::Context *ctx,
         uint8_t *evm_stack);
 
+    // Wrap LLVM compiled code as native code, with an entry point allocated
+    // from `asmjit_rt` that can be called in place of the one emitted by
+    // `vm::Compiler` for the same code
+    SharedNativecode make_nativecode(
+        asmjit::JitRuntime &asmjit_rt, uint64_t chain_id,
+        std::shared_ptr<LLVMState> llvm,
+        compiler::native::native_code_size_t code_size_estimate);
+
 }
@@ -17,6 +17,7 @@
 
 #include <category/core/runtime/uint256.hpp>
 #include <category/vm/core/assert.h>
+#include <category/vm/llvm/compile_options.hpp>
 
 #include <llvm/ADT/APInt.h>
 #include <llvm/ADT/ArrayRef.h>
@@ -101,7 +102,8 @@ namespace monad::vm::llvm
                 expected_contract_addr->getValue());
         };
 
-        void set_contract_addr(std::string const &dbg_nm = "")
+        void set_contract_addr(
+            std::string const &dbg_nm = "", CompileOptions const &options = {})
         {
             debug_on = dbg_nm != "";
 
@@ -118,8 +120,12 @@ namespace monad::vm::llvm
             PB.registerLoopAnalyses(LAM);
             PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
 
-            ModulePassManager MPM =
-                PB.buildPerModuleDefaultPipeline(OptimizationLevel::O3);
+            MONAD_VM_ASSERT(
+                options.opt_level >= 1 && options.opt_level <= 3);
+            ModulePassManager MPM = PB.buildPerModuleDefaultPipeline(
+                options.opt_level == 1   ? OptimizationLevel::O1
+                : options.opt_level == 2 ? OptimizationLevel::O2
+                                         : OptimizationLevel::O3);
 
             bool const do_optimize = true;
 
@@ -140,6 +146,11 @@ namespace monad::vm::llvm
                     otl.setTransform(dumpobjs);
                 }
             }
+            else if (!options.object_name.empty()) {
+                ObjectTransformLayer &otl = lljit->getObjTransformLayer();
+                otl.setTransform(DumpObjects(
+                    options.object_dir.string(), options.object_name));
+            }
 
             JITDylib &jd = lljit->getMainJITDylib();
 
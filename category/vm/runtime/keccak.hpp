@@ -15,13 +15,14 @@
 
 #pragma once
 
+#include <category/core/keccak.h>
 #include <category/core/runtime/uint256.hpp>
 #include <category/vm/core/assert.h>
 #include <category/vm/runtime/types.hpp>
 
 #include <evmc/evmc.hpp>
 
-#include <ethash/keccak.hpp>
+#include <cstdint>
 
 namespace monad::vm::runtime
 {
@@ -41,7 +42,10 @@ namespace monad::vm::runtime
             ctx->deduct_gas(word_size * bin<6>);
         }
 
-        auto const hash = ethash::keccak256(ctx->memory.data + *offset, *size);
-        *result_ptr = uint256_t::load_be(hash.bytes);
+        // Hashed in place from memory by the vectorized permutation of the
+        // node, rather than the portable ethash one
+        uint8_t hash[KECCAK256_SIZE];
+        ::keccak256(ctx->memory.data + *offset, *size, hash);
+        *result_ptr = uint256_t::load_be(hash);
     }
 }
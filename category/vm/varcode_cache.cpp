@@ -43,8 +43,10 @@ namespace monad::vm
     {
         WeightCache::ConstAccessor acc;
         if (!weight_cache_.find(acc, code_hash)) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
             return std::nullopt;
         }
+        hits_.fetch_add(1, std::memory_order_relaxed);
         return acc->second.value_;
     }
 
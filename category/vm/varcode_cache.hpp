@@ -19,6 +19,9 @@
 #include <category/vm/utils/evmc_utils.hpp>
 #include <category/vm/utils/lru_weight_cache.hpp>
 
+#include <atomic>
+#include <cstdint>
+
 namespace monad::vm
 {
     class VarcodeCache
@@ -75,8 +78,22 @@ namespace monad::vm
             return weight_cache_.size();
         }
 
+        /// Number of lookups that found varcode, since construction.
+        uint64_t hits() const noexcept
+        {
+            return hits_.load(std::memory_order_relaxed);
+        }
+
+        /// Number of lookups that did not find varcode, since construction.
+        uint64_t misses() const noexcept
+        {
+            return misses_.load(std::memory_order_relaxed);
+        }
+
     private:
         WeightCache weight_cache_;
         std::uint32_t warm_cache_kb_;
+        std::atomic<uint64_t> hits_{0};
+        std::atomic<uint64_t> misses_{0};
     };
 }
@@ -27,6 +27,7 @@
 #include <evmc/evmc.h>
 #include <evmc/evmc.hpp>
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -159,6 +160,12 @@ namespace monad::vm
             }
             // Bytecode has been successfully compiled for the right
             // revision.
+#ifdef MONAD_COMPILER_LLVM
+            if (compiler_.llvm_tier_enabled()) {
+                return execute_native_llvm_tier_impl<traits>(
+                    rt_ctx, code_hash, vcode);
+            }
+#endif
             return execute_native_entrypoint_impl(rt_ctx, entry);
         }
         if (!compiler_.is_varcode_cache_warm()) {
@@ -187,6 +194,39 @@ namespace monad::vm
 
     EXPLICIT_TRAITS_MEMBER(VM::execute_impl);
 
+#ifdef MONAD_COMPILER_LLVM
+    template <Traits traits>
+    evmc::Result VM::execute_native_llvm_tier_impl(
+        runtime::Context &rt_ctx, evmc::bytes32 const &code_hash,
+        SharedVarcode const &vcode)
+    {
+        auto const msg_gas = rt_ctx.gas_remaining;
+        auto const start = std::chrono::steady_clock::now();
+        auto result = execute_native_entrypoint_impl(
+            rt_ctx, vcode->nativecode()->entrypoint());
+        auto const end = std::chrono::steady_clock::now();
+        MONAD_VM_DEBUG_ASSERT(result.gas_left >= 0);
+        MONAD_VM_DEBUG_ASSERT(msg_gas >= result.gas_left);
+        uint64_t const gas_used =
+            static_cast<uint64_t>(msg_gas - result.gas_left);
+        uint64_t const time_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+                .count());
+        // Optimized code is timed as well, to measure the speedup
+        auto const total = vcode->nativecode_executed(gas_used, time_ns);
+        auto const threshold = compiler_.llvm_gas_threshold();
+        // The request is repeated until it is accepted, as the compiler
+        // turns it down while it has too many jobs
+        if (!vcode->nativecode()->is_optimized() && total >= threshold &&
+            !vcode->llvm_tier_requested()) {
+            compiler_.async_compile_llvm<traits>(code_hash, vcode);
+        }
+        return result;
+    }
+
+    EXPLICIT_TRAITS_MEMBER(VM::execute_native_llvm_tier_impl);
+#endif
+
     template <Traits traits>
     evmc::Result VM::execute_bytecode_impl(
         runtime::Context &rt_ctx, std::span<uint8_t const> code)
@@ -226,6 +226,15 @@ namespace monad::vm
         evmc::Result execute_native_entrypoint_impl(
             runtime::Context &, compiler::native::entrypoint_t);
 
+#ifdef MONAD_COMPILER_LLVM
+        // Execute native code, measuring it and recompiling it with LLVM once
+        // hot
+        template <Traits traits>
+        evmc::Result execute_native_llvm_tier_impl(
+            runtime::Context &rt_ctx, evmc::bytes32 const &code_hash,
+            SharedVarcode const &vcode);
+#endif
+
         VmStats stats_;
     };
 }
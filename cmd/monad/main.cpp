@@ -34,8 +34,11 @@
 #include <category/execution/ethereum/core/rlp/block_rlp.hpp>
 #include <category/execution/ethereum/db/block_db.hpp>
 #include <category/execution/ethereum/db/db_cache.hpp>
+#include <category/execution/ethereum/db/key_bloom_filter.hpp>
 #include <category/execution/ethereum/db/trie_db.hpp>
 #include <category/execution/ethereum/event/exec_event_ctypes.h>
+#include <category/execution/ethereum/metrics/execution_metrics.hpp>
+#include <category/execution/ethereum/metrics/metrics_server.hpp>
 #include <category/execution/ethereum/precompiles.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
@@ -58,11 +61,14 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
+#include <fstream>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <signal.h>
 #include <stdexcept>
@@ -136,6 +142,14 @@ try {
     fs::path snapshot;
     fs::path dump_snapshot;
     std::string statesync;
+    fs::path key_filter_path;
+    size_t key_filter_size = size_t{1} << 30;
+    fs::path metrics_socket;
+    fs::path capture_path;
+#ifdef MONAD_COMPILER_LLVM
+    bool llvm_tier = false;
+    vm::LLVMTierConfig llvm_tier_config;
+#endif
     auto log_level = quill::LogLevel::Info;
 
     std::unordered_map<std::string, monad_chain_config> const CHAIN_CONFIG_MAP =
@@ -175,6 +189,26 @@ try {
         "--dump_snapshot",
         dump_snapshot,
         "directory to dump state to at the end of run");
+    cli.add_option(
+        "--key_filter",
+        key_filter_path,
+        "file to persist the bloom filter of state keys across runs. Reads of "
+        "accounts and storage slots the filter rules out skip the on disk "
+        "triedb. Rebuilt from the db when missing or stale");
+    cli.add_option(
+        "--key_filter_size",
+        key_filter_size,
+        "size in bytes of the bloom filter of state keys");
+    cli.add_option(
+        "--metrics_socket",
+        metrics_socket,
+        "unix domain socket to serve execution metrics on, in the Prometheus "
+        "text format");
+    cli.add_option(
+        "--capture",
+        capture_path,
+        "file to append the reads and state changes of every executed block "
+        "to, for replay without the database");
     cli.add_flag("--trace_calls", trace_calls, "enable call tracing");
     auto *const as_eth_blocks_flag = cli.add_flag(
         "--as_eth_blocks", as_eth_blocks, "ingest monad blocks in evm format");
@@ -214,6 +248,25 @@ try {
                 }
                 return std::string{};
             });
+#ifdef MONAD_COMPILER_LLVM
+    cli.add_flag(
+        "--llvm_tier",
+        llvm_tier,
+        "recompile hot contracts with the LLVM backend in the background");
+    cli.add_option(
+        "--llvm_tier_gas_threshold",
+        llvm_tier_config.gas_threshold,
+        "gas used by the native code of a contract before it is recompiled "
+        "with LLVM");
+    cli.add_option(
+        "--llvm_tier_threads",
+        llvm_tier_config.threads,
+        "number of threads recompiling with LLVM");
+    cli.add_option(
+        "--llvm_tier_cache",
+        llvm_tier_config.object_cache_dir,
+        "directory to persist contracts compiled with LLVM across runs");
+#endif
 #ifdef ENABLE_EVENT_TRACING
     fs::path trace_log = fs::absolute("trace");
     cli.add_option("--trace_log", trace_log, "path to output trace file");
@@ -242,6 +295,13 @@ try {
     quill::get_root_logger()->set_log_level(log_level);
     LOG_INFO("running with commit '{}'", GIT_COMMIT_HASH);
 
+    std::unique_ptr<MetricsServer> metrics_server;
+    if (!metrics_socket.empty()) {
+        g_execution_metrics = std::make_unique<ExecutionMetrics>();
+        metrics_server = std::make_unique<MetricsServer>(
+            g_execution_metrics->registry, metrics_socket);
+    }
+
     // Initialize the event system if --exec-event-ring is specified
     if (exec_event_ring_option->count() > 0) {
         if (empty(exec_event_ring_config)) {
@@ -341,6 +401,18 @@ try {
         return triedb.get_block_number();
     }();
 
+    std::unique_ptr<KeyBloomFilter> key_filter;
+    if (!key_filter_path.empty() && !db_in_memory) {
+        key_filter = KeyBloomFilter::load(
+            key_filter_path,
+            db.get_latest_version(),
+            state_roots_digest(db, db.get_latest_version()));
+        if (!key_filter) {
+            key_filter = make_key_bloom_filter(db, key_filter_size);
+        }
+        triedb.set_key_filter(key_filter.get());
+    }
+
     std::unique_ptr<monad::StateSyncServer> sync_server;
     if (!statesync.empty()) {
         sync_server = monad::make_statesync_server(monad::StateSyncServerConfig{
@@ -408,9 +480,22 @@ try {
     // compilation: the compiler does not expose the full fidelity of error exit
     // codes that are required to serve RPC responses that include call traces.
     vm::VM vm{!trace_calls};
+#ifdef MONAD_COMPILER_LLVM
+    if (llvm_tier && !trace_calls) {
+        vm.compiler().enable_llvm_tier(llvm_tier_config);
+    }
+#endif
 
     DbCache db_cache =
         sync_server ? DbCache{*sync_server->ctx} : DbCache{triedb};
+    std::ofstream capture;
+    if (!capture_path.empty()) {
+        capture.open(capture_path, std::ios::binary | std::ios::app);
+        if (!capture) {
+            throw std::runtime_error(
+                "can not open capture file " + capture_path.string());
+        }
+    }
     auto const result = [&] {
         switch (chain_config) {
         case CHAIN_CONFIG_ETHEREUM_MAINNET:
@@ -424,7 +509,8 @@ try {
                 block_num,
                 end_block_num,
                 stop,
-                trace_calls);
+                trace_calls,
+                capture.is_open() ? &capture : nullptr);
         case CHAIN_CONFIG_MONAD_DEVNET:
         case CHAIN_CONFIG_MONAD_TESTNET:
         case CHAIN_CONFIG_MONAD_MAINNET:
@@ -454,7 +540,8 @@ try {
                     block_num,
                     end_block_num,
                     stop,
-                    trace_calls);
+                    trace_calls,
+                    capture.is_open() ? &capture : nullptr);
             }
         }
         MONAD_ABORT_PRINTF("Unsupported chain");
@@ -491,6 +578,13 @@ try {
 
     sync_server.reset();
 
+    if (key_filter) {
+        key_filter->save(
+            key_filter_path,
+            db.get_latest_version(),
+            state_roots_digest(db, db.get_latest_version()));
+    }
+
     if (!dump_snapshot.empty()) {
         LOG_INFO("Dump db of block: {}", block_num);
         mpt::AsyncIOContext io_ctx(mpt::ReadOnlyOnDiskDbConfig{
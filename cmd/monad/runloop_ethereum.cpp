@@ -25,11 +25,13 @@
 #include <category/execution/ethereum/chain/chain.hpp>
 #include <category/execution/ethereum/core/block.hpp>
 #include <category/execution/ethereum/core/rlp/block_rlp.hpp>
+#include <category/execution/ethereum/db/block_capture.hpp>
 #include <category/execution/ethereum/db/block_db.hpp>
 #include <category/execution/ethereum/db/db.hpp>
 #include <category/execution/ethereum/execute_block.hpp>
 #include <category/execution/ethereum/execute_transaction.hpp>
 #include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/metrics/execution_metrics.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
 #include <category/execution/ethereum/validate_block.hpp>
@@ -43,6 +45,7 @@
 #include <algorithm>
 #include <chrono>
 #include <memory>
+#include <ostream>
 #include <vector>
 
 MONAD_ANONYMOUS_NAMESPACE_BEGIN
@@ -83,7 +86,8 @@ Result<void> process_ethereum_block(
     Chain const &chain, Db &db, vm::VM &vm,
     BlockHashBufferFinalized &block_hash_buffer,
     fiber::PriorityPool &priority_pool, Block &block, bytes32_t const &block_id,
-    bytes32_t const &parent_block_id, bool const enable_tracing)
+    bytes32_t const &parent_block_id, bool const enable_tracing,
+    std::ostream *const capture)
 {
     [[maybe_unused]] auto const block_start = std::chrono::system_clock::now();
     auto const block_begin = std::chrono::steady_clock::now();
@@ -132,7 +136,9 @@ Result<void> process_ethereum_block(
     // changes but does not commit them
     db.set_block_and_prefix(block.header.number - 1, parent_block_id);
     BlockMetrics block_metrics;
-    BlockState block_state(db, vm);
+    CaptureDb capture_db{db};
+    CaptureBlockHashBuffer capture_block_hash_buffer{block_hash_buffer};
+    BlockState block_state(capture ? static_cast<Db &>(capture_db) : db, vm);
     BOOST_OUTCOME_TRY(
         auto const receipts,
         execute_block<traits>(
@@ -141,7 +147,9 @@ Result<void> process_ethereum_block(
             senders,
             recovered_authorities,
             block_state,
-            block_hash_buffer,
+            capture ? static_cast<BlockHashBuffer const &>(
+                          capture_block_hash_buffer)
+                    : block_hash_buffer,
             priority_pool.fiber_group(),
             block_metrics,
             call_tracers,
@@ -171,6 +179,14 @@ Result<void> process_ethereum_block(
     // Post-commit validation of header, with Merkle root fields filled in
     auto const output_header = db.read_eth_header();
     BOOST_OUTCOME_TRY(validate_output_header(block.header, output_header));
+    if (capture) {
+        BlockCapture block_capture = capture_db.take();
+        block_capture.block_hashes = capture_block_hash_buffer.take();
+        auto const encoded = encode_block_capture(block_capture);
+        capture->write(
+            reinterpret_cast<char const *>(encoded.data()),
+            static_cast<std::streamsize>(encoded.size()));
+    }
 
     // Commit prologue: database finalization, computation of the Ethereum
     // block hash to append to the circular hash buffer
@@ -181,9 +197,19 @@ Result<void> process_ethereum_block(
     block_hash_buffer.set(block.header.number, eth_block_hash);
 
     // Emit the block metrics log line
-    [[maybe_unused]] auto const block_time =
+    auto const block_time =
         std::chrono::duration_cast<std::chrono::microseconds>(
             std::chrono::steady_clock::now() - block_begin);
+    block_metrics.set_sender_recovery_time(sender_recovery_time);
+    block_metrics.set_commit_time(commit_time);
+    block_metrics.set_block_time(block_time);
+    record_block_metrics(
+        block_metrics,
+        block.transactions.size(),
+        output_header.gas_used,
+        db,
+        vm,
+        priority_pool);
     LOG_INFO(
         "__exec_block,bl={:8},ts={}"
         ",tx={:5},rt={:4},rtp={:5.2f}%"
@@ -225,7 +251,7 @@ Result<std::pair<uint64_t, uint64_t>> runloop_ethereum(
     vm::VM &vm, BlockHashBufferFinalized &block_hash_buffer,
     fiber::PriorityPool &priority_pool, uint64_t &block_num,
     uint64_t const end_block_num, sig_atomic_t const volatile &stop,
-    bool const enable_tracing)
+    bool const enable_tracing, std::ostream *const capture)
 {
     uint64_t const batch_size =
         end_block_num == std::numeric_limits<uint64_t>::max() ? 1 : 1000;
@@ -260,7 +286,8 @@ Result<std::pair<uint64_t, uint64_t>> runloop_ethereum(
                 block,
                 block_id,
                 parent_block_id,
-                enable_tracing);
+                enable_tracing,
+                capture);
             MONAD_ABORT_PRINTF("unhandled rev switch case: %d", rev);
         }());
 
@@ -21,6 +21,7 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <ostream>
 #include <utility>
 
 #include <signal.h>
@@ -36,9 +37,11 @@ namespace fiber
     class PriorityPool;
 }
 
+// Each block executed is appended to `capture` if set, see `BlockCapture`
 Result<std::pair<uint64_t, uint64_t>> runloop_ethereum(
     Chain const &, std::filesystem::path const &, Db &, vm::VM &,
     BlockHashBufferFinalized &, fiber::PriorityPool &, uint64_t &, uint64_t,
-    sig_atomic_t const volatile &, bool enable_tracing);
+    sig_atomic_t const volatile &, bool enable_tracing,
+    std::ostream *capture = nullptr);
 
 MONAD_NAMESPACE_END
@@ -27,6 +27,7 @@
 #include <category/execution/ethereum/core/block.hpp>
 #include <category/execution/ethereum/core/fmt/bytes_fmt.hpp>
 #include <category/execution/ethereum/core/rlp/block_rlp.hpp>
+#include <category/execution/ethereum/db/block_capture.hpp>
 #include <category/execution/ethereum/db/db.hpp>
 #include <category/execution/ethereum/db/util.hpp>
 #include <category/execution/ethereum/event/exec_event_ctypes.h>
@@ -35,6 +36,7 @@
 #include <category/execution/ethereum/execute_block.hpp>
 #include <category/execution/ethereum/execute_transaction.hpp>
 #include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/metrics/execution_metrics.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
 #include <category/execution/ethereum/transaction_gas.hpp>
@@ -59,6 +61,7 @@
 #include <deque>
 #include <filesystem>
 #include <optional>
+#include <ostream>
 #include <thread>
 #include <variant>
 #include <vector>
@@ -174,7 +177,8 @@ Result<BlockExecOutput> propose_block(
     MonadConsensusBlockHeader const &consensus_header, Block block,
     BlockHashChain &block_hash_chain, MonadChain const &chain, Db &db,
     vm::VM &vm, fiber::PriorityPool &priority_pool, bool const is_first_block,
-    bool const enable_tracing, BlockCache &block_cache)
+    bool const enable_tracing, BlockCache &block_cache,
+    std::ostream *const capture)
 {
     [[maybe_unused]] auto const block_start = std::chrono::system_clock::now();
     auto const block_begin = std::chrono::steady_clock::now();
@@ -279,7 +283,9 @@ Result<BlockExecOutput> propose_block(
 
     BlockExecOutput exec_output;
     BlockMetrics block_metrics;
-    BlockState block_state(db, vm);
+    CaptureDb capture_db{db};
+    CaptureBlockHashBuffer capture_block_hash_buffer{block_hash_buffer};
+    BlockState block_state(capture ? static_cast<Db &>(capture_db) : db, vm);
     record_block_marker_event(MONAD_EXEC_BLOCK_PERF_EVM_ENTER);
     BOOST_OUTCOME_TRY(
         auto const results,
@@ -289,7 +295,9 @@ Result<BlockExecOutput> propose_block(
             senders,
             recovered_authorities,
             block_state,
-            block_hash_buffer,
+            capture ? static_cast<BlockHashBuffer const &>(
+                          capture_block_hash_buffer)
+                    : block_hash_buffer,
             priority_pool.fiber_group(),
             block_metrics,
             call_tracers,
@@ -335,6 +343,24 @@ Result<BlockExecOutput> propose_block(
     exec_output.eth_header = db.read_eth_header();
     BOOST_OUTCOME_TRY(
         validate_live_execution_outputs(block.header, exec_output.eth_header));
+    if (capture) {
+        BlockCapture block_capture = capture_db.take();
+        block_capture.block_hashes = capture_block_hash_buffer.take();
+        if (chain_context.parent_senders_and_authorities) {
+            block_capture.parent_senders_and_authorities.assign(
+                chain_context.parent_senders_and_authorities->begin(),
+                chain_context.parent_senders_and_authorities->end());
+        }
+        if (chain_context.grandparent_senders_and_authorities) {
+            block_capture.grandparent_senders_and_authorities.assign(
+                chain_context.grandparent_senders_and_authorities->begin(),
+                chain_context.grandparent_senders_and_authorities->end());
+        }
+        auto const encoded = encode_block_capture(block_capture);
+        capture->write(
+            reinterpret_cast<char const *>(encoded.data()),
+            static_cast<std::streamsize>(encoded.size()));
+    }
 
     // Commit prologue: computation of the Ethereum block hash to append to
     // the circular hash buffer
@@ -347,9 +373,19 @@ Result<BlockExecOutput> propose_block(
         consensus_header.parent_id());
 
     // Emit the block metrics log line
-    [[maybe_unused]] auto const block_time =
+    auto const block_time =
         std::chrono::duration_cast<std::chrono::microseconds>(
             std::chrono::steady_clock::now() - block_begin);
+    block_metrics.set_sender_recovery_time(sender_recovery_time);
+    block_metrics.set_commit_time(commit_time);
+    block_metrics.set_block_time(block_time);
+    record_block_metrics(
+        block_metrics,
+        block.transactions.size(),
+        exec_output.eth_header.gas_used,
+        db,
+        vm,
+        priority_pool);
     LOG_INFO(
         "__exec_block,bl={:8},id={},ts={}"
         ",tx={:5},rt={:4},rtp={:5.2f}%"
@@ -469,7 +505,7 @@ Result<std::pair<uint64_t, uint64_t>> runloop_monad(
     BlockHashBufferFinalized &block_hash_buffer,
     fiber::PriorityPool &priority_pool, uint64_t &finalized_block_num,
     uint64_t const end_block_num, sig_atomic_t const volatile &stop,
-    bool const enable_tracing)
+    bool const enable_tracing, std::ostream *const capture)
 {
     constexpr auto SLEEP_TIME = std::chrono::microseconds(100);
     uint64_t const start_block_num = finalized_block_num;
@@ -623,7 +659,8 @@ Result<std::pair<uint64_t, uint64_t>> runloop_monad(
              chain_id,
              start_block_num,
              enable_tracing,
-             &block_cache](
+             &block_cache,
+             capture](
                 bytes32_t const &block_id,
                 auto const &header) -> Result<std::pair<uint64_t, uint64_t>> {
             auto const block_time_start = std::chrono::steady_clock::now();
@@ -678,7 +715,8 @@ Result<std::pair<uint64_t, uint64_t>> runloop_monad(
                     priority_pool,
                     block_number == start_block_num,
                     enable_tracing,
-                    block_cache);
+                    block_cache,
+                    capture);
                 MONAD_ABORT_PRINTF("handled rev value %d", rev);
             };
             BOOST_OUTCOME_TRY(
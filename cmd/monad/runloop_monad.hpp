@@ -21,6 +21,7 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <ostream>
 #include <utility>
 
 #include <signal.h>
@@ -41,9 +42,11 @@ namespace fiber
     class PriorityPool;
 }
 
+// Each block executed is appended to `capture` if set, see `BlockCapture`
 Result<std::pair<uint64_t, uint64_t>> runloop_monad(
     MonadChain const &, std::filesystem::path const &, mpt::Db &, Db &,
     vm::VM &, BlockHashBufferFinalized &, fiber::PriorityPool &, uint64_t &,
-    uint64_t, sig_atomic_t const volatile &, bool enable_tracing);
+    uint64_t, sig_atomic_t const volatile &, bool enable_tracing,
+    std::ostream *capture = nullptr);
 
 MONAD_NAMESPACE_END
@@ -29,6 +29,7 @@
 #include <category/execution/ethereum/execute_block.hpp>
 #include <category/execution/ethereum/execute_transaction.hpp>
 #include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/metrics/execution_metrics.hpp>
 #include <category/execution/ethereum/state2/block_state.hpp>
 #include <category/execution/ethereum/trace/call_tracer.hpp>
 #include <category/execution/ethereum/validate_block.hpp>
@@ -256,9 +257,19 @@ Result<void> process_monad_block(
     block_hash_buffer.set(block.header.number, eth_block_hash);
 
     // Emit the block metrics log line
-    [[maybe_unused]] auto const block_time =
+    auto const block_time =
         std::chrono::duration_cast<std::chrono::microseconds>(
             std::chrono::steady_clock::now() - block_begin);
+    block_metrics.set_sender_recovery_time(sender_recovery_time);
+    block_metrics.set_commit_time(commit_time);
+    block_metrics.set_block_time(block_time);
+    record_block_metrics(
+        block_metrics,
+        block.transactions.size(),
+        output_header.gas_used,
+        db,
+        vm,
+        priority_pool);
     LOG_INFO(
         "__exec_block,bl={:8},ts={}"
         ",tx={:5},rt={:4},rtp={:5.2f}%"
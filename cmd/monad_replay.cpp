@@ -0,0 +1,333 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/assert.h>
+#include <category/core/byte_string.hpp>
+#include <category/core/bytes.hpp>
+#include <category/core/config.hpp>
+#include <category/core/fiber/priority_pool.hpp>
+#include <category/core/result.hpp>
+#include <category/execution/ethereum/chain/chain.hpp>
+#include <category/execution/ethereum/chain/chain_config.h>
+#include <category/execution/ethereum/chain/ethereum_mainnet.hpp>
+#include <category/execution/ethereum/core/address.hpp>
+#include <category/execution/ethereum/core/block.hpp>
+#include <category/execution/ethereum/core/log_level_map.hpp>
+#include <category/execution/ethereum/core/transaction.hpp>
+#include <category/execution/ethereum/db/block_capture.hpp>
+#include <category/execution/ethereum/execute_block.hpp>
+#include <category/execution/ethereum/execute_transaction.hpp>
+#include <category/execution/ethereum/metrics/block_metrics.hpp>
+#include <category/execution/ethereum/state2/block_state.hpp>
+#include <category/execution/ethereum/trace/call_tracer.hpp>
+#include <category/execution/ethereum/trace/state_tracer.hpp>
+#include <category/execution/ethereum/validate_transaction.hpp>
+#include <category/execution/monad/chain/monad_chain.hpp>
+#include <category/execution/monad/chain/monad_devnet.hpp>
+#include <category/execution/monad/chain/monad_mainnet.hpp>
+#include <category/execution/monad/chain/monad_testnet.hpp>
+#include <category/execution/monad/reserve_balance.hpp>
+#include <category/vm/evm/switch_traits.hpp>
+#include <category/vm/evm/traits.hpp>
+#include <category/vm/vm.hpp>
+
+#include <CLI/CLI.hpp>
+#include <ankerl/unordered_dense.h>
+#include <boost/outcome/try.hpp>
+#include <quill/Quill.h>
+#include <quill/detail/LogMacros.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+MONAD_ANONYMOUS_NAMESPACE_BEGIN
+
+// Executes a captured block against the values it read, and checks that it
+// makes the same changes to the state
+template <Traits traits>
+Result<bool> replay_block(
+    Chain const &chain, BlockCapture const &capture, vm::VM &vm,
+    fiber::PriorityPool &priority_pool)
+{
+    Block const &block = capture.block;
+
+    auto const recovered_senders =
+        recover_senders(block.transactions, priority_pool);
+    auto const recovered_authorities =
+        recover_authorities(block.transactions, priority_pool);
+    std::vector<Address> senders(block.transactions.size());
+    for (unsigned i = 0; i < recovered_senders.size(); ++i) {
+        if (!recovered_senders[i].has_value()) {
+            return TransactionError::MissingSender;
+        }
+        senders[i] = recovered_senders[i].value();
+    }
+
+    std::vector<std::unique_ptr<CallTracerBase>> call_tracers{
+        block.transactions.size()};
+    std::vector<std::unique_ptr<trace::StateTracer>> state_tracers{
+        block.transactions.size()};
+    for (unsigned i = 0; i < block.transactions.size(); ++i) {
+        call_tracers[i] = std::make_unique<NoopCallTracer>();
+        state_tracers[i] =
+            std::make_unique<trace::StateTracer>(std::monostate{});
+    }
+
+    ankerl::unordered_dense::segmented_set<Address> senders_and_authorities;
+    for (Address const &sender : senders) {
+        senders_and_authorities.insert(sender);
+    }
+    for (auto const &authorities : recovered_authorities) {
+        for (std::optional<Address> const &authority : authorities) {
+            if (authority.has_value()) {
+                senders_and_authorities.insert(authority.value());
+            }
+        }
+    }
+    ankerl::unordered_dense::segmented_set<Address> parent;
+    for (Address const &address : capture.parent_senders_and_authorities) {
+        parent.insert(address);
+    }
+    ankerl::unordered_dense::segmented_set<Address> grandparent;
+    for (Address const &address :
+         capture.grandparent_senders_and_authorities) {
+        grandparent.insert(address);
+    }
+    MonadChainContext const chain_context{
+        .grandparent_senders_and_authorities =
+            block.header.number > 2 ? &grandparent : nullptr,
+        .parent_senders_and_authorities =
+            block.header.number > 1 ? &parent : nullptr,
+        .senders_and_authorities = senders_and_authorities,
+        .senders = senders,
+        .authorities = recovered_authorities};
+
+    RevertTransactionFn const revert_transaction =
+        [&block, &chain_context](
+            Address const &sender,
+            Transaction const &tx,
+            uint64_t const i,
+            State &state) {
+            if constexpr (is_monad_trait_v<traits>) {
+                return revert_monad_transaction<traits>(
+                    sender,
+                    tx,
+                    block.header.base_fee_per_gas.value_or(0),
+                    i,
+                    state,
+                    chain_context);
+            }
+            else {
+                return false;
+            }
+        };
+
+    ReplayDb db{capture};
+    ReplayBlockHashBuffer const block_hash_buffer{capture};
+    BlockMetrics block_metrics;
+    BlockState block_state(db, vm);
+    BOOST_OUTCOME_TRY(
+        auto const receipts,
+        execute_block<traits>(
+            chain,
+            block,
+            senders,
+            recovered_authorities,
+            block_state,
+            block_hash_buffer,
+            priority_pool.fiber_group(),
+            block_metrics,
+            call_tracers,
+            state_tracers,
+            revert_transaction));
+    block_state.commit(
+        bytes32_t{block.header.number},
+        block.header,
+        receipts,
+        {},
+        senders,
+        block.transactions,
+        block.ommers,
+        block.withdrawals);
+    return db.state_changes() == capture.state_changes;
+}
+
+Result<bool> replay_block(
+    Chain const &chain, BlockCapture const &capture, vm::VM &vm,
+    fiber::PriorityPool &priority_pool)
+{
+    BlockHeader const &header = capture.block.header;
+    if (auto const *const monad_chain =
+            dynamic_cast<MonadChain const *>(&chain)) {
+        auto const rev = monad_chain->get_monad_revision(header.timestamp);
+        SWITCH_MONAD_TRAITS(replay_block, chain, capture, vm, priority_pool);
+        MONAD_ABORT_PRINTF("unhandled monad rev switch case: %d", rev);
+    }
+    auto const rev = chain.get_revision(header.number, header.timestamp);
+    SWITCH_EVM_TRAITS(replay_block, chain, capture, vm, priority_pool);
+    MONAD_ABORT_PRINTF("unhandled rev switch case: %d", rev);
+}
+
+MONAD_ANONYMOUS_NAMESPACE_END
+
+using namespace monad;
+namespace fs = std::filesystem;
+
+// Replays the blocks recorded with `monad --capture` without a database, to
+// measure the execution engine alone and to check it against the recording
+int main(int const argc, char const *argv[])
+{
+    CLI::App cli{"monad-replay"};
+    cli.option_defaults()->always_capture_default();
+
+    monad_chain_config chain_config;
+    fs::path capture_path;
+    unsigned nthreads = 4;
+    unsigned nfibers = 256;
+    unsigned passes = 1;
+    auto log_level = quill::LogLevel::Info;
+
+    std::unordered_map<std::string, monad_chain_config> const CHAIN_CONFIG_MAP =
+        {{"ethereum_mainnet", CHAIN_CONFIG_ETHEREUM_MAINNET},
+         {"monad_devnet", CHAIN_CONFIG_MONAD_DEVNET},
+         {"monad_testnet", CHAIN_CONFIG_MONAD_TESTNET},
+         {"monad_mainnet", CHAIN_CONFIG_MONAD_MAINNET}};
+
+    cli.add_option("--chain", chain_config, "chain config the capture ran")
+        ->transform(CLI::CheckedTransformer(CHAIN_CONFIG_MAP, CLI::ignore_case))
+        ->required();
+    cli.add_option("--capture", capture_path, "file written by monad --capture")
+        ->required();
+    cli.add_option("--nthreads", nthreads, "number of threads");
+    cli.add_option("--nfibers", nfibers, "number of fibers");
+    cli.add_option("--passes", passes, "number of times to replay the blocks");
+    cli.add_option("--log_level", log_level, "level of logging")
+        ->transform(CLI::CheckedTransformer(log_level_map, CLI::ignore_case));
+
+    try {
+        cli.parse(argc, argv);
+    }
+    catch (CLI::ParseError const &e) {
+        return cli.exit(e);
+    }
+
+    auto stdout_handler = quill::stdout_handler();
+    stdout_handler->set_pattern(
+        "%(time) [%(thread_id)] %(file_name):%(line_number) LOG_%(log_level)\t"
+        "%(message)",
+        "%Y-%m-%d %H:%M:%S.%Qns",
+        quill::Timezone::GmtTime);
+    quill::Config cfg;
+    cfg.default_handlers.emplace_back(stdout_handler);
+    quill::configure(cfg);
+    quill::start(true);
+    quill::get_root_logger()->set_log_level(log_level);
+
+    auto chain = [chain_config] -> std::unique_ptr<Chain> {
+        switch (chain_config) {
+        case CHAIN_CONFIG_ETHEREUM_MAINNET:
+            return std::make_unique<EthereumMainnet>();
+        case CHAIN_CONFIG_MONAD_DEVNET:
+            return std::make_unique<MonadDevnet>();
+        case CHAIN_CONFIG_MONAD_TESTNET:
+            return std::make_unique<MonadTestnet>();
+        case CHAIN_CONFIG_MONAD_MAINNET:
+            return std::make_unique<MonadMainnet>();
+        }
+        MONAD_ASSERT(false);
+    }();
+
+    // Decode every block up front so the replay only measures execution
+    std::vector<BlockCapture> captures;
+    {
+        std::ifstream in(capture_path, std::ios::binary);
+        if (!in) {
+            LOG_ERROR("can not open capture file {}", capture_path.string());
+            return EXIT_FAILURE;
+        }
+        byte_string const data{
+            std::istreambuf_iterator<char>{in},
+            std::istreambuf_iterator<char>{}};
+        byte_string_view enc{data};
+        while (!enc.empty()) {
+            auto capture = decode_block_capture(enc);
+            if (capture.has_error()) {
+                LOG_ERROR(
+                    "could not decode block {} of the capture: {}",
+                    captures.size(),
+                    capture.error().message());
+                return EXIT_FAILURE;
+            }
+            captures.push_back(std::move(capture.value()));
+        }
+    }
+    LOG_INFO(
+        "Loaded {} blocks from {}", captures.size(), capture_path.string());
+
+    fiber::PriorityPool priority_pool{nthreads, nfibers};
+    vm::VM vm;
+    uint64_t mismatches = 0;
+    for (unsigned pass = 0; pass < passes; ++pass) {
+        uint64_t ntxs = 0;
+        uint64_t gas = 0;
+        auto const begin = std::chrono::steady_clock::now();
+        for (BlockCapture const &capture : captures) {
+            auto const result =
+                replay_block(*chain, capture, vm, priority_pool);
+            if (result.has_error()) {
+                LOG_ERROR(
+                    "block {} failed with: {}",
+                    capture.block.header.number,
+                    result.error().message());
+                ++mismatches;
+            }
+            else if (!result.value()) {
+                LOG_ERROR(
+                    "block {} changed the state differently than captured",
+                    capture.block.header.number);
+                ++mismatches;
+            }
+            ntxs += capture.block.transactions.size();
+            gas += capture.block.header.gas_used;
+        }
+        auto const elapsed = std::max(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - begin)
+                .count(),
+            int64_t{1});
+        LOG_INFO(
+            "Pass {}: {} blocks, {} transactions in {} us, tps = {}, "
+            "gps = {} M",
+            pass,
+            captures.size(),
+            ntxs,
+            elapsed,
+            ntxs * 1'000'000 / static_cast<uint64_t>(elapsed),
+            gas / static_cast<uint64_t>(elapsed));
+    }
+    quill::flush();
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,76 @@
+// Copyright (C) 2025 Category Labs, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <category/core/keccak.h>
+
+#include <benchmark/benchmark.h>
+
+#include <ethash/keccak.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Throughput of the SHA3 opcode hash by input size, for the vectorized
+// permutation used by the runtime against the portable ethash one it
+// replaced. The sizes cover single words, the largest single block input,
+// the first two block input and large memory regions.
+namespace
+{
+    std::vector<uint8_t> make_input(size_t const size)
+    {
+        std::vector<uint8_t> input(size);
+        for (size_t i = 0; i < size; ++i) {
+            input[i] = static_cast<uint8_t>(i * 31 + 7);
+        }
+        return input;
+    }
+
+    void keccak_ethash(benchmark::State &state)
+    {
+        auto const input = make_input(static_cast<size_t>(state.range(0)));
+        for (auto _ : state) {
+            auto const hash = ethash::keccak256(input.data(), input.size());
+            benchmark::DoNotOptimize(hash);
+        }
+        state.SetBytesProcessed(
+            static_cast<int64_t>(state.iterations()) * state.range(0));
+    }
+
+    void keccak_runtime(benchmark::State &state)
+    {
+        auto const input = make_input(static_cast<size_t>(state.range(0)));
+        for (auto _ : state) {
+            uint8_t hash[KECCAK256_SIZE];
+            keccak256(input.data(), input.size(), hash);
+            benchmark::DoNotOptimize(hash);
+        }
+        state.SetBytesProcessed(
+            static_cast<int64_t>(state.iterations()) * state.range(0));
+    }
+
+    void input_sizes(benchmark::internal::Benchmark *const b)
+    {
+        for (int64_t const size :
+             {32, 64, 96, 135, 136, 271, 272, 1024, 4096, 32768}) {
+            b->Arg(size);
+        }
+    }
+}
+
+BENCHMARK(keccak_ethash)->Apply(input_sizes);
+BENCHMARK(keccak_runtime)->Apply(input_sizes);
+
+BENCHMARK_MAIN();
@@ -18,6 +18,10 @@
 #include <category/vm/compiler/types.hpp>
 #include <category/vm/evm/opcodes.hpp>
 #include <category/vm/evm/traits.hpp>
+#include <category/vm/runtime/allocator.hpp>
+#ifdef MONAD_COMPILER_LLVM
+    #include <category/vm/llvm/llvm.hpp>
+#endif
 #include <category/vm/runtime/types.hpp>
 
 #include <evmc/evmc.h>
@@ -29,6 +33,7 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <filesystem>
 #include <memory>
 #include <thread>
 #include <unordered_set>
@@ -151,3 +156,73 @@ TEST(async_compile_test, disable)
         ASSERT_TRUE(entry == nullptr);
     }
 }
+
+#ifdef MONAD_COMPILER_LLVM
+TEST(async_compile_test, llvm_tier)
+{
+    using traits = EvmTraits<EVMC_PRAGUE>;
+
+    auto const cache_dir =
+        std::filesystem::temp_directory_path() / "monad_vm_llvm_tier_test";
+    std::filesystem::remove_all(cache_dir);
+
+    Compiler compiler;
+    compiler.enable_llvm_tier({.object_cache_dir = cache_dir});
+
+    auto const hash = test_hash(7);
+    auto const icode = make_shared_intercode(test_code(7));
+    auto const ncode = compiler.cached_compile<traits>(hash, icode);
+    ASSERT_FALSE(ncode->is_optimized());
+    auto const vcode = compiler.find_varcode(hash);
+    ASSERT_TRUE(vcode.has_value());
+
+    ASSERT_FALSE((*vcode)->llvm_tier_requested());
+    ASSERT_TRUE(compiler.async_compile_llvm<traits>(hash, *vcode));
+    ASSERT_TRUE((*vcode)->llvm_tier_requested());
+    ASSERT_FALSE(compiler.async_compile_llvm<traits>(hash, *vcode));
+    compiler.debug_wait_for_llvm_tier();
+
+    auto const optimized = compiler.find_varcode(hash);
+    ASSERT_TRUE(optimized.has_value());
+    auto const &optimized_ncode = (*optimized)->nativecode();
+    ASSERT_TRUE(optimized_ncode->is_optimized());
+    ASSERT_EQ(optimized_ncode->chain_id(), traits::id());
+    auto const record = compiler.llvm_tier_record(hash);
+    ASSERT_TRUE(record.has_value());
+    ASSERT_EQ(record->optimized.lock(), *optimized);
+
+    auto ctx = runtime::Context::empty();
+    ctx.gas_remaining = 100;
+    runtime::EvmStackAllocator stack_allocator;
+    auto const stack = stack_allocator.allocate();
+    optimized_ncode->entrypoint()(&ctx, stack.get());
+    ASSERT_EQ(ctx.result.status, runtime::StatusCode::Success);
+    ASSERT_EQ(uint256_t::load_le(ctx.result.offset), 7);
+    ASSERT_EQ(uint256_t::load_le(ctx.result.size), 1);
+
+    // The object was persisted, and loads without compiling
+    llvm::ObjectCache const cache{cache_dir};
+    ASSERT_NE(cache.load<traits>(hash), nullptr);
+    ASSERT_EQ(cache.load<traits>(test_hash(8)), nullptr);
+    std::filesystem::remove_all(cache_dir);
+}
+
+TEST(async_compile_test, llvm_tier_retried_after_job_limit)
+{
+    using traits = EvmTraits<EVMC_PRAGUE>;
+
+    Compiler compiler{true, 0};
+    compiler.enable_llvm_tier({});
+
+    auto const hash = test_hash(9);
+    auto const icode = make_shared_intercode(test_code(9));
+    compiler.cached_compile<traits>(hash, icode);
+    auto const vcode = compiler.find_varcode(hash);
+    ASSERT_TRUE(vcode.has_value());
+
+    // Turned down for too many jobs, so it is requested again later
+    ASSERT_FALSE(compiler.async_compile_llvm<traits>(hash, *vcode));
+    ASSERT_FALSE((*vcode)->llvm_tier_requested());
+    ASSERT_FALSE(compiler.llvm_tier_record(hash).has_value());
+}
+#endif